@@ -0,0 +1,30 @@
+# Copyright (c) BBP/EPFL 2016
+#
+# Find the LZ4 compression library.
+#
+# Input variables:
+#  LZ4_ROOT - optional installation prefix to search first
+#
+# Output variables:
+#  LZ4_FOUND - True if the headers and the library were found
+#  LZ4_INCLUDE_DIRS - The directory of lz4.h
+#  LZ4_LIBRARIES - The library to link against
+
+find_path(LZ4_INCLUDE_DIR lz4.h
+  HINTS ${LZ4_ROOT} $ENV{LZ4_ROOT}
+  PATH_SUFFIXES include)
+
+find_library(LZ4_LIBRARY NAMES lz4 liblz4
+  HINTS ${LZ4_ROOT} $ENV{LZ4_ROOT}
+  PATH_SUFFIXES lib lib64)
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(LZ4 DEFAULT_MSG
+  LZ4_LIBRARY LZ4_INCLUDE_DIR)
+
+if(LZ4_FOUND)
+  set(LZ4_INCLUDE_DIRS ${LZ4_INCLUDE_DIR})
+  set(LZ4_LIBRARIES ${LZ4_LIBRARY})
+endif()
+
+mark_as_advanced(LZ4_INCLUDE_DIR LZ4_LIBRARY)
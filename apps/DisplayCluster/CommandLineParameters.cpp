@@ -45,6 +45,9 @@
 CommandLineParameters::CommandLineParameters(int &argc, char **argv)
     : desc_("Allowed options")
     , getHelp_(false)
+    , transport_(TRANSPORT_MPI)
+    , offscreen_(false)
+    , profile_(false)
 {
     initDesc();
     parseCommandLineArguments(argc, argv);
@@ -69,6 +72,13 @@ void CommandLineParameters::initDesc()
                  "path to configuration file")
         ("session", boost::program_options::value<std::string>()->default_value(""),
                  "path to an initial session file")
+        ("transport", boost::program_options::value<std::string>()->default_value("mpi"),
+                 "transport from the master to the walls: 'mpi' or 'shm' "
+                 "(shared memory, if all processes run on the same host)")
+        ("offscreen", "render the walls offscreen, without windows")
+        ("dump-frames", boost::program_options::value<std::string>()->default_value(""),
+                 "folder where the walls save their offscreen frames as images")
+        ("profile", "record the profiler events of all the processes")
     ;
 }
 
@@ -89,6 +99,11 @@ void CommandLineParameters::parseCommandLineArguments(int &argc, char **argv)
     getHelp_ = vm.count("help");
     configFilename_ = vm["config"].as<std::string>().c_str();
     sessionFilename_ = vm["session"].as<std::string>().c_str();
+    if (vm["transport"].as<std::string>() == "shm")
+        transport_ = TRANSPORT_SHARED_MEMORY;
+    offscreen_ = vm.count("offscreen");
+    frameDumpFolder_ = vm["dump-frames"].as<std::string>().c_str();
+    profile_ = vm.count("profile");
 }
 
 const QString& CommandLineParameters::getConfigFilename() const
@@ -101,3 +116,22 @@ const QString& CommandLineParameters::getSessionFilename() const
     return sessionFilename_;
 }
 
+BroadcastTransportType CommandLineParameters::getTransport() const
+{
+    return transport_;
+}
+
+bool CommandLineParameters::getOffscreen() const
+{
+    return offscreen_;
+}
+
+const QString& CommandLineParameters::getFrameDumpFolder() const
+{
+    return frameDumpFolder_;
+}
+
+bool CommandLineParameters::getProfile() const
+{
+    return profile_;
+}
@@ -40,6 +40,8 @@
 #ifndef COMMANDLINEPARAMETERS_H
 #define COMMANDLINEPARAMETERS_H
 
+#include "BroadcastTransport.h"
+
 #include <QString>
 #include <boost/program_options/options_description.hpp>
 
@@ -64,6 +66,18 @@ public:
     /** Get the config filename */
     const QString& getSessionFilename() const;
 
+    /** Get the transport of the messages from the master to the walls */
+    BroadcastTransportType getTransport() const;
+
+    /** Should the walls render offscreen instead of in windows */
+    bool getOffscreen() const;
+
+    /** Get the folder where the walls save their offscreen frames */
+    const QString& getFrameDumpFolder() const;
+
+    /** Should the processes record profiler events */
+    bool getProfile() const;
+
 private:
     void initDesc();
     void parseCommandLineArguments(int &argc, char **argv);
@@ -73,6 +87,10 @@ private:
 
     QString configFilename_;
     QString sessionFilename_;
+    BroadcastTransportType transport_;
+    bool offscreen_;
+    QString frameDumpFolder_;
+    bool profile_;
 };
 
 #endif // COMMANDLINEPARAMETERS_H
@@ -50,6 +50,9 @@
 #include "MasterFromWallChannel.h"
 #include "Options.h"
 #include "Markers.h"
+#include "ClusterMetrics.h"
+#include "GLTexture2D.h"
+#include "Profiler.h"
 
 #if ENABLE_TUIO_TOUCH_LISTENER
 #  include "MultiTouchListener.h"
@@ -68,29 +71,36 @@
 #include "ws/TextInputDispatcher.h"
 #include "ws/TextInputHandler.h"
 #include "ws/DisplayGroupAdapter.h"
+#include "ws/MetricsHandler.h"
 
 #include <deflect/CommandHandler.h>
 #include <deflect/EventReceiver.h>
 #include <deflect/FrameDispatcher.h>
 #include <deflect/Server.h>
 
+#include <ctime>
 #include <stdexcept>
 
+namespace
+{
+const int METRICS_INTERVAL_MS = 2000;
+}
+
 MasterApplication::MasterApplication( int& argc_, char** argv_,
-                                      MPIChannelPtr worldChannel )
+                                      const CommandLineParameters& options,
+                                      MPIChannelPtr worldChannel,
+                                      BroadcastSenderPtr sender )
     : QApplication( argc_, argv_ )
-    , masterToWallChannel_( new MasterToWallChannel( worldChannel ))
+    , masterToWallChannel_( new MasterToWallChannel( sender ))
     , masterFromWallChannel_( new MasterFromWallChannel( worldChannel ))
     , markers_( new Markers )
+    , clusterMetrics_( new ClusterMetrics )
+    , wallProcessesCount_( worldChannel->getSize() - 1 )
 {
     // don't create touch points for mouse events and vice versa
     setAttribute( Qt::AA_SynthesizeTouchForUnhandledMouseEvents, false );
     setAttribute( Qt::AA_SynthesizeMouseForUnhandledTouchEvents, false );
 
-    CommandLineParameters options( argc_, argv_ );
-    if( options.getHelp( ))
-        options.showSyntax();
-
     if( !createConfig( options.getConfigFilename( )))
         throw std::runtime_error( "MasterApplication: initialization failed." );
 
@@ -107,7 +117,10 @@ MasterApplication::~MasterApplication()
 {
     deflectServer_.reset();
 
-    masterToWallChannel_->sendQuit();
+    // Broadcasts are collective operations, they must all be issued from the
+    // MPI send thread to guarantee the same order on all processes.
+    QMetaObject::invokeMethod( masterToWallChannel_.get(), "sendQuit",
+                               Qt::BlockingQueuedConnection );
 
     mpiSendThread_.quit();
     mpiSendThread_.wait();
@@ -121,6 +134,8 @@ MasterApplication::~MasterApplication()
 
 void MasterApplication::init()
 {
+    Profiler::setThreadName( "main" );
+
     connect( this, &MasterApplication::lastWindowClosed,
              this, &MasterApplication::quit );
 
@@ -210,6 +225,15 @@ void MasterApplication::startWebservice( const int webServicePort )
              textInputDispatcher_.get(),
              &TextInputDispatcher::sendKeyEventToActiveWindow );
 
+    webServiceServer_->addHandler( "/dcapi/metrics",
+                                   dcWebservice::HandlerPtr(
+                                       new MetricsHandler( clusterMetrics_,
+                                           MetricsHandler::FORMAT_JSON )));
+    webServiceServer_->addHandler( "/dcapi/metrics/prometheus",
+                                   dcWebservice::HandlerPtr(
+                                       new MetricsHandler( clusterMetrics_,
+                                           MetricsHandler::FORMAT_PROMETHEUS )));
+
     webServiceServer_->start();
 }
 
@@ -245,6 +269,9 @@ void MasterApplication::initPixelStreamLauncher()
 
 void MasterApplication::initMPIConnection()
 {
+    masterToWallChannel_->setCompressionThreshold(
+                config_->getMPICompressionThreshold( ));
+
     masterToWallChannel_->moveToThread( &mpiSendThread_ );
     masterFromWallChannel_->moveToThread( &mpiReceiveThread_ );
 
@@ -269,7 +296,9 @@ void MasterApplication::initMPIConnection()
     connect( &deflectServer_->getPixelStreamDispatcher(),
              &deflect::FrameDispatcher::sendFrame,
              masterToWallChannel_.get(),
-             &MasterToWallChannel::send );
+             [this]( deflect::FramePtr frame )
+                { masterToWallChannel_->send( frame ); },
+             Qt::DirectConnection );
     connect( &deflectServer_->getPixelStreamDispatcher(),
              &deflect::FrameDispatcher::sendFrame,
              pixelStreamWindowManager_.get(),
@@ -299,10 +328,79 @@ void MasterApplication::initMPIConnection()
              masterFromWallChannel_.get(),
              &MasterFromWallChannel::processMessages );
 
+    connect( masterWindow_.get(), &MasterWindow::saveFrameTrace,
+             this, &MasterApplication::requestFrameTrace );
+    connect( masterFromWallChannel_.get(),
+             &MasterFromWallChannel::receivedTrace,
+             this, &MasterApplication::addFrameTrace );
+    connect( &mpiSendThread_, &QThread::started,
+             [] { Profiler::setThreadName( "mpi send" ); } );
+
+    // ClusterMetrics is thread-safe, update it directly from the MPI thread
+    ClusterMetricsPtr metrics = clusterMetrics_;
+    connect( masterFromWallChannel_.get(),
+             &MasterFromWallChannel::receivedMetrics,
+             [metrics]( const ProcessMetrics& processMetrics )
+                { metrics->update( processMetrics ); } );
+    connect( &metricsTimer_, &QTimer::timeout,
+             this, &MasterApplication::updateMasterMetrics );
+    updateMasterMetrics();
+    metricsTimer_.start( METRICS_INTERVAL_MS );
+
     mpiSendThread_.start();
     mpiReceiveThread_.start();
 }
 
+void MasterApplication::requestFrameTrace( const QString& filename )
+{
+    if( !traceFilename_.isEmpty( ))
+    {
+        put_flog( LOG_WARN, "a frame trace is already being saved to '%s'",
+                  traceFilename_.toLocal8Bit().constData( ));
+        return;
+    }
+
+    traceFilename_ = filename;
+    traceEvents_.clear();
+    traceEvents_.push_back( Profiler::getTraceEvents( 0, "master" ));
+
+    // Broadcasts must be issued from the MPI send thread
+    QMetaObject::invokeMethod( masterToWallChannel_.get(), "sendTraceRequest",
+                               Qt::QueuedConnection );
+}
+
+void MasterApplication::addFrameTrace( const QByteArray& traceEvents )
+{
+    if( traceFilename_.isEmpty( ))
+        return;
+
+    traceEvents_.push_back( std::string( traceEvents.constData(),
+                                         traceEvents.size( )));
+    if( (int)traceEvents_.size() <= wallProcessesCount_ )
+        return;
+
+    if( Profiler::writeChromeTrace( traceFilename_, traceEvents_ ))
+        put_flog( LOG_INFO, "frame trace saved to '%s'",
+                  traceFilename_.toLocal8Bit().constData( ));
+    else
+        put_flog( LOG_ERROR, "could not save frame trace to '%s'",
+                  traceFilename_.toLocal8Bit().constData( ));
+
+    traceFilename_.clear();
+    traceEvents_.clear();
+}
+
+void MasterApplication::updateMasterMetrics()
+{
+    ProcessMetrics metrics;
+    Metrics::getDurations( metrics );
+    metrics.rank = 0;
+    metrics.queueDepth = masterToWallChannel_->getQueueSize();
+    metrics.textureMemory = GLTexture2D::getAllocatedMemory();
+    metrics.cpuTime = double( std::clock( )) / CLOCKS_PER_SEC;
+    clusterMetrics_->update( metrics );
+}
+
 #if ENABLE_TUIO_TOUCH_LISTENER
 void MasterApplication::initTouchListener()
 {
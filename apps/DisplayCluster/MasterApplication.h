@@ -45,8 +45,13 @@
 
 #include <QApplication>
 #include <QThread>
+#include <QTimer>
 #include <boost/scoped_ptr.hpp>
 
+#include <string>
+#include <vector>
+
+class CommandLineParameters;
 class MasterToWallChannel;
 class MasterFromWallChannel;
 class MasterWindow;
@@ -69,10 +74,14 @@ public:
      * Constructor
      * @param argc Command line argument count (required by QApplication)
      * @param argv Command line arguments (required by QApplication)
+     * @param options The command line parameters, parsed from argc, argv
      * @param worldChannel The world MPI channel
+     * @param sender The transport of the messages to the walls
      * @throw std::runtime_error if an error occured during initialization
      */
-    MasterApplication(int &argc, char **argv, MPIChannelPtr worldChannel);
+    MasterApplication(int &argc, char **argv,
+                      const CommandLineParameters& options,
+                      MPIChannelPtr worldChannel, BroadcastSenderPtr sender);
 
     /** Destructor */
     virtual ~MasterApplication();
@@ -97,6 +106,13 @@ private:
     QThread mpiSendThread_;
     QThread mpiReceiveThread_;
 
+    ClusterMetricsPtr clusterMetrics_;
+    QTimer metricsTimer_;
+
+    const int wallProcessesCount_;
+    QString traceFilename_;
+    std::vector<std::string> traceEvents_;
+
     void init();
     bool createConfig(const QString& filename);
     void startDeflectServer();
@@ -104,6 +120,9 @@ private:
     void restoreBackground();
     void initPixelStreamLauncher();
     void initMPIConnection();
+    void requestFrameTrace(const QString& filename);
+    void addFrameTrace(const QByteArray& traceEvents);
+    void updateMasterMetrics();
 
 #if ENABLE_TUIO_TOUCH_LISTENER
     void initTouchListener();
@@ -64,6 +64,7 @@
 namespace
 {
 const QString STATE_FILES_FILTER( "State files (*.dcx)" );
+const QString TRACE_FILES_FILTER( "Chrome trace files (*.json)" );
 const QSize DEFAULT_WINDOW_SIZE( 800, 600 );
 }
 
@@ -153,6 +154,11 @@ void MasterWindow::setupMasterWindowUI()
     computeImagePyramidAction->setStatusTip("Compute image pyramid");
     connect(computeImagePyramidAction, SIGNAL(triggered()), this, SLOT(computeImagePyramid()));
 
+    // save frame trace action
+    QAction* saveTraceAction = new QAction( "Save Frame Trace", this );
+    saveTraceAction->setStatusTip( "Save the frame timings of all processes" );
+    connect( saveTraceAction, SIGNAL( triggered( )), this, SLOT( saveTrace( )));
+
     // load background content action
     QAction * backgroundAction = new QAction("Background", this);
     backgroundAction->setStatusTip("Select the background color and content");
@@ -251,6 +257,7 @@ void MasterWindow::setupMasterWindowUI()
     viewMenu->addAction( showZoomContextAction );
     viewMenu->addAction( enableAlphaBlendingAction );
     toolsMenu->addAction( computeImagePyramidAction );
+    toolsMenu->addAction( saveTraceAction );
 
     helpMenu->addAction( showAboutDialog );
 
@@ -437,6 +444,20 @@ void MasterWindow::loadState( const QString& filename )
     }
 }
 
+void MasterWindow::saveTrace()
+{
+    QString filename = QFileDialog::getSaveFileName( this, "Save Frame Trace",
+                                                     sessionFolder_,
+                                                     TRACE_FILES_FILTER );
+    if( filename.isEmpty( ))
+        return;
+
+    if( !filename.endsWith( ".json" ))
+        filename.append( ".json" );
+
+    emit saveFrameTrace( filename );
+}
+
 void MasterWindow::computeImagePyramid()
 {
     const QString filename = QFileDialog::getOpenFileName( this, "Select image",
@@ -82,6 +82,9 @@ signals:
     /** Emitted when users want to open a webbrowser. */
     void openWebBrowser( QPointF pos, QSize size, QString url );
 
+    /** Emitted when users want to save the frame timings of all processes. */
+    void saveFrameTrace( QString filename );
+
 protected:
     /** @name Drag events re-implemented from QMainWindow */
     //@{
@@ -98,6 +101,8 @@ private slots:
 
     void computeImagePyramid();
 
+    void saveTrace();
+
     void openAboutWidget();
 
 private:
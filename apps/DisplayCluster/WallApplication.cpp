@@ -42,7 +42,11 @@
 #include "log.h"
 #include "CommandLineParameters.h"
 
+#include "GLTexture2D.h"
+#include "Metrics.h"
 #include "MPIChannel.h"
+#include "PixelStreamUpdater.h"
+#include "Profiler.h"
 #include "WallFromMasterChannel.h"
 #include "WallToMasterChannel.h"
 #include "WallToWallChannel.h"
@@ -51,25 +55,35 @@
 
 #include "RenderContext.h"
 
+#include <ctime>
 #include <stdexcept>
 
 #include <boost/bind.hpp>
 
+namespace
+{
+const int METRICS_INTERVAL_MS = 2000;
+const int IDLE_POLL_MS = 20;
+const int IDLE_TIMEOUT_MS = 1000;
+}
+
 WallApplication::WallApplication( int& argc_, char** argv_,
+                                  const CommandLineParameters& options,
                                   MPIChannelPtr worldChannel,
-                                  MPIChannelPtr wallChannel )
+                                  MPIChannelPtr wallChannel,
+                                  BroadcastReceiverPtr receiver )
     : QApplication( argc_, argv_ )
     , wallChannel_( new WallToWallChannel( wallChannel ))
+    , idleStart_( 0 )
+    , idlePolls_( 0 )
+    , frameRequested_( false )
+    , frameRequestTime_( 0 )
 {
-    CommandLineParameters options( argc_, argv_ );
-    if( options.getHelp( ))
-        options.showSyntax();
-
     if ( !createConfig( options.getConfigFilename(), worldChannel->getRank( )))
         throw std::runtime_error(" WallApplication: initialization failed." );
 
-    initRenderContext();
-    initMPIConnection( worldChannel );
+    initRenderContext( options );
+    initMPIConnection( worldChannel, receiver );
     startRendering();
 }
 
@@ -96,13 +110,14 @@ bool WallApplication::createConfig( const QString& filename, const int rank )
     return true;
 }
 
-void WallApplication::initRenderContext()
+void WallApplication::initRenderContext( const CommandLineParameters& options )
 {
     connect( this, SIGNAL( lastWindowClosed( )), this, SLOT( quit( )));
 
     try
     {
-        renderContext_.reset( new RenderContext( *config_ ));
+        renderContext_.reset( new RenderContext( *config_,
+                                                 options.getOffscreen( )));
     }
     catch( const std::runtime_error& e )
     {
@@ -111,12 +126,14 @@ void WallApplication::initRenderContext()
         throw std::runtime_error( "WallApplication: initialization failed." );
     }
 
+    renderContext_->setFrameDumpFolder( options.getFrameDumpFolder( ));
     renderController_.reset( new RenderController( renderContext_ ));
 }
 
-void WallApplication::initMPIConnection( MPIChannelPtr worldChannel )
+void WallApplication::initMPIConnection( MPIChannelPtr worldChannel,
+                                         BroadcastReceiverPtr receiver )
 {
-    fromMasterChannel_.reset( new WallFromMasterChannel( worldChannel ));
+    fromMasterChannel_.reset( new WallFromMasterChannel( receiver ));
     toMasterChannel_.reset( new WallToMasterChannel( worldChannel ));
 
     fromMasterChannel_->moveToThread( &mpiReceiveThread_ );
@@ -146,12 +163,21 @@ void WallApplication::initMPIConnection( MPIChannelPtr worldChannel )
                  toMasterChannel_.get(), SLOT( sendRequestFrame( QString )));
     }
 
+    connect( fromMasterChannel_.get(), SIGNAL( receivedTraceRequest( )),
+             toMasterChannel_.get(), SLOT( sendTrace( )));
+
     connect( fromMasterChannel_.get(), SIGNAL( receivedQuit( )),
              toMasterChannel_.get(), SLOT( sendQuit( )));
 
     connect( &mpiReceiveThread_, SIGNAL( started( )),
              fromMasterChannel_.get(), SLOT( processMessages( )));
 
+    connect( &mpiSendThread_, &QThread::started,
+             [] { Profiler::setThreadName( "mpi send" ); } );
+
+    connect( &metricsTimer_, SIGNAL( timeout( )), this, SLOT( sendMetrics( )));
+    metricsTimer_.start( METRICS_INTERVAL_MS );
+
     mpiReceiveThread_.start();
     mpiSendThread_.start();
 }
@@ -162,23 +188,166 @@ void WallApplication::startRendering()
     // Must be a queued connection to avoid infinite recursion.
     connect( this, SIGNAL( frameFinished( )),
              this, SLOT( renderFrame( )), Qt::QueuedConnection );
+
+    // When nothing changed on the wall, rendering is suspended until a new
+    // message from the master application or a change in the Qml scene.
+    // Such events may only be seen by some of the processes, so the idle
+    // processes poll together and all resume as soon as one of them needs a
+    // frame. They also resume periodically as a safety net.
+    connect( fromMasterChannel_.get(), SIGNAL( receivedQuit( )),
+             this, SLOT( requestFrame( )));
+    connect( fromMasterChannel_.get(), SIGNAL( received( DisplayGroupPtr )),
+             this, SLOT( requestFrame( )));
+    connect( fromMasterChannel_.get(), SIGNAL( received( OptionsPtr )),
+             this, SLOT( requestFrame( )));
+    connect( fromMasterChannel_.get(), SIGNAL( received( MarkersPtr )),
+             this, SLOT( requestFrame( )));
+    connect( fromMasterChannel_.get(), SIGNAL( received( deflect::FramePtr )),
+             this, SLOT( requestFrame( )));
+    connect( &renderContext_->getScene(), SIGNAL( changed( QList<QRectF> )),
+             this, SLOT( requestFrame( )));
+
+    idleTimer_.setInterval( IDLE_POLL_MS );
+    connect( &idleTimer_, SIGNAL( timeout( )), this, SLOT( pollIdle( )));
+
+    Profiler::setThreadName( "render" );
     renderFrame();
 }
 
 void WallApplication::renderFrame()
 {
-    wallChannel_->synchronizeClock();
-
-    renderController_->preRenderUpdate( *wallChannel_ );
-
-    renderContext_->updateGLWindows();
-    wallChannel_->globalBarrier();
-    renderContext_->swapBuffers();
-
-    renderController_->postRenderUpdate( *wallChannel_ );
+    PROFILE_SCOPE( "frame", "renderFrame" );
+    // Requests made from now on are for the next frame
+    frameRequested_ = false;
+    if( frameTimer_.isValid( ))
+        Metrics::recordFrameTime( frameTimer_.nsecsElapsed() / 1000000.0 );
+    frameTimer_.start();
+    {
+        PROFILE_SCOPE( "frame", "synchronizeClock" );
+        wallChannel_->synchronizeClock();
+    }
+    {
+        PROFILE_SCOPE( "frame", "preRenderUpdate" );
+        renderController_->preRenderUpdate( *wallChannel_ );
+    }
+    bool redrawNeeded = false;
+    {
+        PROFILE_SCOPE( "frame", "voteRedraw" );
+        redrawNeeded = wallChannel_->anyModified(
+                           renderController_->isRedrawNeeded( ));
+    }
+    if( !redrawNeeded )
+    {
+        skipFrame();
+        return;
+    }
+    {
+        PROFILE_SCOPE( "frame", "updateGLWindows" );
+        renderContext_->updateGLWindows();
+    }
+    // The GPU renders the frame while the CPU finishes it and already
+    // synchronizes the objects of the next one.
+    {
+        PROFILE_SCOPE( "frame", "postRenderUpdate" );
+        renderController_->postRenderUpdate( *wallChannel_ );
+    }
+    {
+        PROFILE_SCOPE( "frame", "prepareNextFrame" );
+        renderController_->prepareNextFrame( *wallChannel_ );
+    }
+    {
+        PROFILE_SCOPE( "frame", "waitGPU" );
+        renderContext_->waitForGPU();
+    }
+    {
+        PROFILE_SCOPE( "frame", "globalBarrier" );
+        wallChannel_->globalBarrier();
+    }
+    {
+        PROFILE_SCOPE( "frame", "swapBuffers" );
+        renderContext_->swapBuffers();
+    }
 
     if( renderController_->quitRendering( ))
         quit();
 
     emit( frameFinished( ));
 }
+
+void WallApplication::skipFrame()
+{
+    Metrics::recordSkippedFrame();
+
+    // Don't count the idle time as a frame duration
+    frameTimer_.invalidate();
+
+    idleStart_ = Profiler::now();
+    idlePolls_ = 0;
+    idleTimer_.start();
+}
+
+void WallApplication::requestFrame()
+{
+    if( frameRequested_ )
+        return;
+
+    frameRequested_ = true;
+    frameRequestTime_ = Profiler::now();
+}
+
+void WallApplication::pollIdle()
+{
+    // Collective: all the idle processes poll at the same rate, so the polls
+    // of the processes match each other.
+    ++idlePolls_;
+    const bool timeout = idlePolls_ * IDLE_POLL_MS >= IDLE_TIMEOUT_MS;
+    bool resume = false;
+    {
+        PROFILE_SCOPE( "frame", "pollIdle" );
+        resume = wallChannel_->anyModified( frameRequested_ || timeout );
+    }
+    if( resume )
+        resumeRendering();
+}
+
+void WallApplication::resumeRendering()
+{
+    const int64_t now = Profiler::now();
+    if( Profiler::isEnabled( ))
+        Profiler::record( "frame", "idle", idleStart_, now - idleStart_ );
+    if( frameRequested_ )
+        Metrics::recordWakeTime( ( now - frameRequestTime_ ) / 1000.0 );
+
+    idleTimer_.stop();
+    renderFrame();
+}
+
+void WallApplication::sendMetrics()
+{
+    ProcessMetrics metrics;
+    Metrics::getDurations( metrics );
+
+    const PixelStreamUpdater& updater =
+            renderController_->getPixelStreamUpdater();
+    metrics.streamsFps = updater.getStreamsFps();
+    metrics.queueDepth = updater.getPendingFramesCount();
+    metrics.textureMemory = GLTexture2D::getAllocatedMemory();
+    metrics.cpuTime = double( std::clock( )) / CLOCKS_PER_SEC;
+
+    UploadScheduler& uploadScheduler = renderContext_->getUploadScheduler();
+    metrics.uploadBacklog = uploadScheduler.getBacklogSize();
+    metrics.maxUploadFrameTime = uploadScheduler.getWorstFrameTime();
+    uploadScheduler.resetWorstFrameTime();
+
+    const MemoryAccountant& memory = renderContext_->getMemoryAccountant();
+    for( const auto& window : memory.getUsagePerWindow( ))
+        metrics.windowsMemory[window.first.toStdString()] = window.second;
+    for( const auto& type : memory.getUsagePerType( ))
+        metrics.contentTypesMemory[type.first.toStdString()] = type.second;
+    metrics.memoryBudget = memory.getBudget();
+    metrics.evictions = memory.getEvictionCount();
+
+    QMetaObject::invokeMethod( toMasterChannel_.get(), "sendMetrics",
+                               Qt::QueuedConnection,
+                               Q_ARG( ProcessMetrics, metrics ));
+}
@@ -45,9 +45,12 @@
 #include "RenderController.h"
 
 #include <QApplication>
+#include <QElapsedTimer>
 #include <QThread>
+#include <QTimer>
 #include <boost/scoped_ptr.hpp>
 
+class CommandLineParameters;
 class RenderContext;
 class WallFromMasterChannel;
 class WallToMasterChannel;
@@ -65,11 +68,16 @@ public:
      * Constructor
      * @param argc Command line argument count (required by QApplication)
      * @param argv Command line arguments (required by QApplication)
+     * @param options The command line parameters, parsed from argc, argv
      * @param worldChannel The world MPI channel
      * @param wallChannel The wall MPI channel
+     * @param receiver The transport of the messages from the master
      * @throw std::runtime_error if an error occured during initialization
      */
-    WallApplication(int &argc, char **argv, MPIChannelPtr worldChannel, MPIChannelPtr wallChannel);
+    WallApplication(int &argc, char **argv,
+                    const CommandLineParameters& options,
+                    MPIChannelPtr worldChannel, MPIChannelPtr wallChannel,
+                    BroadcastReceiverPtr receiver);
 
     /** Destructor */
     virtual ~WallApplication();
@@ -80,6 +88,9 @@ signals:
 
 private slots:
     void renderFrame();
+    void requestFrame();
+    void pollIdle();
+    void sendMetrics();
 
 private:
     boost::scoped_ptr<WallConfiguration> config_;
@@ -93,11 +104,23 @@ private:
     QThread mpiSendThread_;
     QThread mpiReceiveThread_;
 
+    QTimer metricsTimer_;
+    QElapsedTimer frameTimer_;
+
+    QTimer idleTimer_;
+    int64_t idleStart_;
+    int idlePolls_;
+    bool frameRequested_;
+    int64_t frameRequestTime_;
+
     bool createConfig(const QString& filename, const int rank);
-    void initRenderContext();
-    void initMPIConnection(MPIChannelPtr worldChannel);
+    void initRenderContext(const CommandLineParameters& options);
+    void initMPIConnection(MPIChannelPtr worldChannel,
+                           BroadcastReceiverPtr receiver);
 
     void startRendering();
+    void skipFrame();
+    void resumeRendering();
 };
 
 #endif // WALLAPPLICATION_H
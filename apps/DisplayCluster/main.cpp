@@ -39,7 +39,10 @@
 #include "config.h"
 #include "log.h"
 
+#include "BroadcastTransport.h"
+#include "CommandLineParameters.h"
 #include "MPIChannel.h"
+#include "Profiler.h"
 #include "WallApplication.h"
 #include "MasterApplication.h"
 
@@ -78,6 +81,21 @@ int main( int argc, char* argv[] )
 
     MPIChannelPtr wallChannel( new MPIChannel( *worldChannel, rank > 0, rank ));
 
+    const CommandLineParameters options( argc, argv );
+    if( options.getHelp( ))
+        options.showSyntax();
+    Profiler::setEnabled( options.getProfile( ));
+
+    // Collective operation, done before any other use of the world channel
+    BroadcastSenderPtr sender;
+    BroadcastReceiverPtr receiver;
+    if( rank == 0 )
+        sender = BroadcastSender::create( options.getTransport(),
+                                          worldChannel );
+    else
+        receiver = BroadcastReceiver::create( options.getTransport(),
+                                              worldChannel );
+
 #if ENABLE_TUIO_TOUCH_LISTENER
     // we need X multithreading support if we're running the
     // TouchListener thread and creating X events
@@ -89,10 +107,11 @@ int main( int argc, char* argv[] )
     try
     {
         if( rank == 0 )
-            app.reset( new MasterApplication( argc, argv, worldChannel ));
+            app.reset( new MasterApplication( argc, argv, options,
+                                              worldChannel, sender ));
         else
-            app.reset( new WallApplication( argc, argv, worldChannel,
-                                            wallChannel ));
+            app.reset( new WallApplication( argc, argv, options, worldChannel,
+                                            wallChannel, receiver ));
     }
     catch( const std::runtime_error& e )
     {
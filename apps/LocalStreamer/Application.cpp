@@ -99,14 +99,14 @@ bool Application::initialize(const CommandLineOptions& options)
 
 void Application::sendImage(QImage image)
 {
-#ifdef COMPRESS_IMAGES
     // QImage Format_RGB32 (0xffRRGGBB) corresponds in fact to GL_BGRA == deflect::BGRA
-    deflect::ImageWrapper deflectImage((const void*)image.bits(), image.width(), image.height(), deflect::BGRA);
+    deflect::ImageWrapper deflectImage(image.constBits(), image.width(), image.height(),
+                                       PixelStreamer::getPixelFormat());
+#ifdef COMPRESS_IMAGES
     deflectImage.compressionPolicy = deflect::COMPRESSION_ON;
 #else
-    // This conversion is suboptimal, but the only solution until we send the PixelFormat with the PixelStreamSegment
-    image = image.rgbSwapped();
-    deflect::ImageWrapper deflectImage((const void*)image.bits(), image.width(), image.height(), deflect::RGBA);
+    // No conversion needed, the Wall processes upload the segments using the
+    // PixelFormat declared for this stream by the PixelStreamerLauncher.
     deflectImage.compressionPolicy = deflect::COMPRESSION_OFF;
 #endif
     bool success = dcStream_->send(deflectImage) && dcStream_->finishFrame();
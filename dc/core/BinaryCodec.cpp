@@ -0,0 +1,479 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#include "BinaryCodec.h"
+
+#include "DynamicTextureContent.h"
+#include "MovieContent.h"
+#include "PDFContent.h"
+#include "PixelStreamContent.h"
+#include "SVGContent.h"
+#include "TextureContent.h"
+
+#include <cstring>
+
+namespace
+{
+// Pointer tags: 0 for null pointers, NEW_OBJECT followed by the object the
+// first time it is written, and the index + 1 of the object afterwards.
+const uint32_t NULL_OBJECT = 0;
+const uint32_t NEW_OBJECT = 0xffffffff;
+}
+
+BinaryEncoder::BinaryEncoder()
+    : _buffer( 0 )
+    , _contentRegistryEnabled( false )
+    , _nextContentId( 0 )
+{
+}
+
+void BinaryEncoder::enableContentRegistry()
+{
+    _contentRegistryEnabled = true;
+}
+
+void BinaryEncoder::_write( const void* data, const size_t size )
+{
+    _buffer->append( static_cast< const char* >( data ), size );
+}
+
+bool BinaryEncoder::_saveReference( const void* object )
+{
+    if( !object )
+    {
+        _save( NULL_OBJECT );
+        return false;
+    }
+
+    // Linear search: messages reference at most a few hundred objects
+    for( size_t i = 0; i < _trackedObjects.size(); ++i )
+    {
+        if( _trackedObjects[i] == object )
+        {
+            _save( uint32_t( i + 1 ));
+            return false;
+        }
+    }
+    _trackedObjects.push_back( object );
+    _save( NEW_OBJECT );
+    return true;
+}
+
+void BinaryEncoder::_save( const ContentPtr& content )
+{
+    if( !_contentRegistryEnabled )
+    {
+        _savePointer( content.get( ));
+        return;
+    }
+
+    if( !_saveReference( content.get( )))
+        return;
+
+    RegisteredContent& entry = _registeredContents[content.get()];
+    const bool isRegistered = entry.content.lock() == content;
+    if( !isRegistered )
+    {
+        // New content, or a new object allocated at the same address
+        entry.content = content;
+        entry.id = _nextContentId++;
+    }
+    const bool isUpToDate = isRegistered &&
+                            entry.version == content->getVersion();
+    entry.version = content->getVersion();
+    entry.referenced = true;
+
+    _save( entry.id );
+    _save( !isUpToDate );
+    if( isUpToDate )
+        return;
+
+    _save( entry.version );
+    _saveContent( *content );
+}
+
+void BinaryEncoder::_savePointer( const Content* content )
+{
+    if( _saveReference( content ))
+        _saveContent( *content );
+}
+
+void BinaryEncoder::_saveContent( const Content& content )
+{
+    const CONTENT_TYPE type = content.getType();
+    _save( type );
+
+    switch( type )
+    {
+    case CONTENT_TYPE_DYNAMIC_TEXTURE:
+        _save( static_cast< const DynamicTextureContent& >( content ));
+        break;
+    case CONTENT_TYPE_MOVIE:
+        _save( static_cast< const MovieContent& >( content ));
+        break;
+    case CONTENT_TYPE_PIXEL_STREAM:
+        _save( static_cast< const PixelStreamContent& >( content ));
+        break;
+    case CONTENT_TYPE_SVG:
+        _save( static_cast< const SVGContent& >( content ));
+        break;
+    case CONTENT_TYPE_TEXTURE:
+        _save( static_cast< const TextureContent& >( content ));
+        break;
+    case CONTENT_TYPE_PDF:
+        _save( static_cast< const PDFContent& >( content ));
+        break;
+    case CONTENT_TYPE_ANY:
+    default:
+        throw std::runtime_error( "Can not encode content of unknown type" );
+    }
+}
+
+void BinaryEncoder::_endContentRegistryMessage()
+{
+    // Forget the contents which are gone, the decoder does the same
+    RegisteredContents::iterator it = _registeredContents.begin();
+    while( it != _registeredContents.end( ))
+    {
+        if( it->second.referenced )
+        {
+            it->second.referenced = false;
+            ++it;
+        }
+        else
+            _registeredContents.erase( it++ );
+    }
+}
+
+void BinaryEncoder::_save( const QString& string )
+{
+    _save( uint32_t( string.size( )));
+    _write( string.utf16(), string.size() * sizeof( ushort ));
+}
+
+void BinaryEncoder::_save( const QByteArray& array )
+{
+    _save( uint32_t( array.size( )));
+    _write( array.constData(), array.size( ));
+}
+
+void BinaryEncoder::_save( const QUuid& uuid )
+{
+    _save( uuid.data1 );
+    _save( uuid.data2 );
+    _save( uuid.data3 );
+    _write( uuid.data4, sizeof( uuid.data4 ));
+}
+
+void BinaryEncoder::_save( const QColor& color )
+{
+    _save( uint32_t( color.rgba( )));
+}
+
+void BinaryEncoder::_save( const QPointF& point )
+{
+    _save( point.x( ));
+    _save( point.y( ));
+}
+
+void BinaryEncoder::_save( const QRectF& rect )
+{
+    _save( rect.x( ));
+    _save( rect.y( ));
+    _save( rect.width( ));
+    _save( rect.height( ));
+}
+
+void BinaryEncoder::_save( const QSize& size )
+{
+    _save( int32_t( size.width( )));
+    _save( int32_t( size.height( )));
+}
+
+void BinaryEncoder::_save( const deflect::Frame& frame )
+{
+    _save( frame.segments );
+    _save( frame.uri );
+}
+
+void BinaryEncoder::_save( const deflect::Segment& segment )
+{
+    _save( segment.parameters );
+    _save( segment.imageData );
+}
+
+void BinaryEncoder::_save( const deflect::SegmentParameters& parameters )
+{
+    _save( parameters.x );
+    _save( parameters.y );
+    _save( parameters.width );
+    _save( parameters.height );
+    _save( parameters.compressed );
+}
+
+BinaryDecoder::BinaryDecoder()
+    : _data( 0 )
+    , _end( 0 )
+    , _contentRegistryEnabled( false )
+{
+}
+
+void BinaryDecoder::enableContentRegistry()
+{
+    _contentRegistryEnabled = true;
+}
+
+void BinaryDecoder::_read( void* data, const size_t size )
+{
+    if( size > size_t( _end - _data ))
+        throw std::runtime_error( "Truncated binary message" );
+
+    std::memcpy( data, _data, size );
+    _data += size;
+}
+
+uint32_t BinaryDecoder::_loadSize()
+{
+    uint32_t size = 0;
+    _load( size );
+    // Each item takes at least one byte, reject corrupted sizes early
+    if( size > size_t( _end - _data ))
+        throw std::runtime_error( "Invalid size in binary message" );
+    return size;
+}
+
+uint32_t BinaryDecoder::_loadTag()
+{
+    uint32_t tag = NULL_OBJECT;
+    _load( tag );
+    if( tag != NULL_OBJECT && tag != NEW_OBJECT && tag > _trackedObjects.size( ))
+        throw std::runtime_error( "Invalid object reference in binary message" );
+    return tag;
+}
+
+bool BinaryDecoder::_isReference( const uint32_t tag ) const
+{
+    return tag != NULL_OBJECT && tag != NEW_OBJECT;
+}
+
+bool BinaryDecoder::_isNewObject( const uint32_t tag ) const
+{
+    return tag == NEW_OBJECT;
+}
+
+void* BinaryDecoder::_getAddress( const uint32_t tag ) const
+{
+    return _trackedObjects[tag - 1].address;
+}
+
+boost::shared_ptr< void > BinaryDecoder::_getOwner( const uint32_t tag ) const
+{
+    const TrackedObject& object = _trackedObjects[tag - 1];
+    if( !object.owner )
+        throw std::runtime_error( "Shared object was first decoded as a raw "
+                                  "pointer" );
+    return object.owner;
+}
+
+void BinaryDecoder::_track( void* object, boost::shared_ptr< void > owner )
+{
+    const TrackedObject trackedObject = { object, owner };
+    _trackedObjects.push_back( trackedObject );
+}
+
+void BinaryDecoder::_load( ContentPtr& content )
+{
+    if( !_contentRegistryEnabled )
+    {
+        _load< Content >( content );
+        return;
+    }
+
+    const uint32_t tag = _loadTag();
+    if( _isReference( tag ))
+    {
+        content = boost::static_pointer_cast< Content >( _getOwner( tag ));
+        return;
+    }
+    if( !_isNewObject( tag ))
+    {
+        content.reset();
+        return;
+    }
+
+    uint32_t id = 0;
+    bool included = false;
+    _load( id );
+    _load( included );
+
+    RegisteredContent& entry = _registeredContents[id];
+    if( included )
+    {
+        _load( entry.version );
+        _loadNew( content );
+        entry.content = content;
+    }
+    else
+    {
+        if( !entry.content )
+            throw std::runtime_error( "Unknown content in binary message" );
+        content = entry.content;
+        _track( content.get(), content );
+    }
+    entry.referenced = true;
+}
+
+void BinaryDecoder::_endContentRegistryMessage()
+{
+    RegisteredContents::iterator it = _registeredContents.begin();
+    while( it != _registeredContents.end( ))
+    {
+        if( it->second.referenced )
+        {
+            it->second.referenced = false;
+            ++it;
+        }
+        else
+            _registeredContents.erase( it++ );
+    }
+}
+
+void BinaryDecoder::_loadNew( ContentPtr& content )
+{
+    CONTENT_TYPE type = CONTENT_TYPE_ANY;
+    _load( type );
+
+    switch( type )
+    {
+    case CONTENT_TYPE_DYNAMIC_TEXTURE:
+        _loadNewContent< DynamicTextureContent >( content );
+        break;
+    case CONTENT_TYPE_MOVIE:
+        _loadNewContent< MovieContent >( content );
+        break;
+    case CONTENT_TYPE_PIXEL_STREAM:
+        _loadNewContent< PixelStreamContent >( content );
+        break;
+    case CONTENT_TYPE_SVG:
+        _loadNewContent< SVGContent >( content );
+        break;
+    case CONTENT_TYPE_TEXTURE:
+        _loadNewContent< TextureContent >( content );
+        break;
+    case CONTENT_TYPE_PDF:
+        _loadNewContent< PDFContent >( content );
+        break;
+    case CONTENT_TYPE_ANY:
+    default:
+        throw std::runtime_error( "Invalid content type in binary message" );
+    }
+}
+
+void BinaryDecoder::_load( QString& string )
+{
+    const uint32_t size = _loadSize();
+    string.resize( size );
+    _read( string.data(), size * sizeof( ushort ));
+}
+
+void BinaryDecoder::_load( QByteArray& array )
+{
+    const uint32_t size = _loadSize();
+    array.resize( size );
+    _read( array.data(), size );
+}
+
+void BinaryDecoder::_load( QUuid& uuid )
+{
+    _load( uuid.data1 );
+    _load( uuid.data2 );
+    _load( uuid.data3 );
+    _read( uuid.data4, sizeof( uuid.data4 ));
+}
+
+void BinaryDecoder::_load( QColor& color )
+{
+    uint32_t rgba = 0;
+    _load( rgba );
+    color = QColor::fromRgba( rgba );
+}
+
+void BinaryDecoder::_load( QPointF& point )
+{
+    _load( point.rx( ));
+    _load( point.ry( ));
+}
+
+void BinaryDecoder::_load( QRectF& rect )
+{
+    qreal x, y, width, height;
+    _load( x );
+    _load( y );
+    _load( width );
+    _load( height );
+    rect = QRectF( x, y, width, height );
+}
+
+void BinaryDecoder::_load( QSize& size )
+{
+    int32_t width, height;
+    _load( width );
+    _load( height );
+    size = QSize( width, height );
+}
+
+void BinaryDecoder::_load( deflect::Frame& frame )
+{
+    _load( frame.segments );
+    _load( frame.uri );
+}
+
+void BinaryDecoder::_load( deflect::Segment& segment )
+{
+    _load( segment.parameters );
+    _load( segment.imageData );
+}
+
+void BinaryDecoder::_load( deflect::SegmentParameters& parameters )
+{
+    _load( parameters.x );
+    _load( parameters.y );
+    _load( parameters.width );
+    _load( parameters.height );
+    _load( parameters.compressed );
+}
@@ -0,0 +1,518 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#ifndef BINARYCODEC_H
+#define BINARYCODEC_H
+
+#include "types.h"
+#include "ContentType.h"
+
+#include <deflect/Frame.h>
+
+#include <QColor>
+#include <QPointF>
+#include <QRectF>
+#include <QSize>
+#include <QString>
+#include <QUuid>
+
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
+#include <boost/serialization/access.hpp>
+#include <boost/serialization/extended_type_info_typeid.hpp>
+#include <boost/serialization/nvp.hpp>
+#include <boost/serialization/version.hpp>
+#include <boost/serialization/void_cast.hpp>
+#include <boost/type_traits.hpp>
+#include <boost/utility/enable_if.hpp>
+
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/**
+ * Compact binary codec for the messages sent from the master to the walls.
+ *
+ * It reuses the serialize() methods written for boost.serialization, but
+ * unlike boost binary archives it writes no class information, transfers
+ * strings as raw UTF-16 and writes directly to a reusable buffer.
+ *
+ * Each message starts with the codec version, and each object with the
+ * version of its class (BOOST_CLASS_VERSION). Objects referenced by several
+ * pointers (shared windows, back-pointers of controllers) are only written
+ * once, like with boost archives.
+ *
+ * Optionally, Content objects can be registered across messages: each Content
+ * is then only sent with the first message that references it, or after it
+ * was modified, and is otherwise referenced by its registry id.
+ */
+namespace BinaryCodec
+{
+/** The version of the message format. */
+const uint32_t VERSION = 1;
+}
+
+/**
+ * Encode objects with the BinaryCodec format.
+ */
+class BinaryEncoder : public boost::noncopyable
+{
+public:
+    typedef boost::mpl::bool_<true> is_saving;
+    typedef boost::mpl::bool_<false> is_loading;
+
+    /** Constructor. */
+    BinaryEncoder();
+
+    /**
+     * Encode an object.
+     * @param object The object to encode
+     * @param buffer The output buffer, cleared but keeping its capacity
+     */
+    template< typename T >
+    void encode( const T& object, std::string& buffer )
+    {
+        buffer.clear();
+        _buffer = &buffer;
+        _trackedObjects.clear();
+
+        _save( BinaryCodec::VERSION );
+        _save( object );
+        _endContentRegistryMessage();
+
+        _buffer = 0;
+    }
+
+    /**
+     * Only send Content objects which are new or modified since the
+     * previous message.
+     *
+     * The matching BinaryDecoder must also enable the registry and decode
+     * all the messages encoded by this encoder, in the same order.
+     * Contents which are not referenced by a message are removed from the
+     * registry, so the same type of object should be encoded each time.
+     */
+    void enableContentRegistry();
+
+    /** @name Archive interface used by the serialize() methods. */
+    //@{
+    template< typename T >
+    BinaryEncoder& operator&( const T& object )
+    {
+        _save( object );
+        return *this;
+    }
+
+    template< typename T >
+    BinaryEncoder& operator<<( const T& object )
+    {
+        _save( object );
+        return *this;
+    }
+    //@}
+
+private:
+    std::string* _buffer;
+    std::vector< const void* > _trackedObjects;
+
+    struct RegisteredContent
+    {
+        boost::weak_ptr< Content > content;
+        uint32_t id;
+        uint32_t version;
+        bool referenced;
+    };
+    typedef std::map< const Content*, RegisteredContent > RegisteredContents;
+    bool _contentRegistryEnabled;
+    RegisteredContents _registeredContents;
+    uint32_t _nextContentId;
+
+    void _write( const void* data, size_t size );
+
+    template< typename T >
+    typename boost::enable_if_c< boost::is_arithmetic< T >::value >::type
+    _save( const T& value )
+    {
+        _write( &value, sizeof( T ));
+    }
+
+    template< typename T >
+    typename boost::enable_if< boost::is_enum< T >>::type
+    _save( const T& value )
+    {
+        _save( int32_t( value ));
+    }
+
+    template< typename T >
+    typename boost::enable_if< boost::is_class< T >>::type
+    _save( const T& object )
+    {
+        const unsigned int version = boost::serialization::version< T >::value;
+        _save( uint8_t( version ));
+        boost::serialization::access::serialize( *this, const_cast< T& >( object ),
+                                                 version );
+    }
+
+    template< typename T >
+    void _save( const boost::serialization::nvp< T >& nvp )
+    {
+        _save( nvp.const_value( ));
+    }
+
+    template< typename T >
+    void _save( const std::vector< T >& vector )
+    {
+        _save( uint32_t( vector.size( )));
+        for( const T& item : vector )
+            _save( item );
+    }
+
+    template< typename T >
+    void _save( const std::set< T >& set )
+    {
+        _save( uint32_t( set.size( )));
+        for( const T& item : set )
+            _save( item );
+    }
+
+    template< typename K, typename V >
+    void _save( const std::map< K, V >& map )
+    {
+        _save( uint32_t( map.size( )));
+        for( const auto& item : map )
+        {
+            _save( item.first );
+            _save( item.second );
+        }
+    }
+
+    template< typename T >
+    void _save( const boost::shared_ptr< T >& ptr )
+    {
+        _savePointer( ptr.get( ));
+    }
+
+    template< typename T >
+    void _save( const boost::scoped_ptr< T >& ptr )
+    {
+        _savePointer( ptr.get( ));
+    }
+
+    template< typename T >
+    void _save( T* const& ptr )
+    {
+        _savePointer( ptr );
+    }
+
+    template< typename T >
+    void _savePointer( const T* object )
+    {
+        if( _saveReference( object ))
+            _save( *object );
+    }
+
+    void _save( const ContentPtr& content );
+    void _savePointer( const Content* content );
+    bool _saveReference( const void* object );
+    void _saveContent( const Content& content );
+    void _endContentRegistryMessage();
+
+    void _save( const QString& string );
+    void _save( const QByteArray& array );
+    void _save( const QUuid& uuid );
+    void _save( const QColor& color );
+    void _save( const QPointF& point );
+    void _save( const QRectF& rect );
+    void _save( const QSize& size );
+    void _save( const deflect::Frame& frame );
+    void _save( const deflect::Segment& segment );
+    void _save( const deflect::SegmentParameters& parameters );
+};
+
+/**
+ * Decode objects encoded by a BinaryEncoder.
+ */
+class BinaryDecoder : public boost::noncopyable
+{
+public:
+    typedef boost::mpl::bool_<false> is_saving;
+    typedef boost::mpl::bool_<true> is_loading;
+
+    /** Constructor. */
+    BinaryDecoder();
+
+    /**
+     * Decode an object.
+     * @param data The encoded data
+     * @param size The size of the encoded data
+     * @param object The decoded object
+     * @throw std::runtime_error if the data is invalid or truncated
+     */
+    template< typename T >
+    void decode( const char* data, const size_t size, T& object )
+    {
+        _data = data;
+        _end = data + size;
+        _trackedObjects.clear();
+
+        uint32_t version = 0;
+        _load( version );
+        if( version != BinaryCodec::VERSION )
+            throw std::runtime_error( "Unsupported binary message version" );
+
+        _load( object );
+        _endContentRegistryMessage();
+        _trackedObjects.clear();
+    }
+
+    /**
+     * Decode messages from a BinaryEncoder which uses a content registry.
+     * @see BinaryEncoder::enableContentRegistry()
+     */
+    void enableContentRegistry();
+
+    /** @name Archive interface used by the serialize() methods. */
+    //@{
+    template< typename T >
+    BinaryDecoder& operator&( T& object )
+    {
+        _load( object );
+        return *this;
+    }
+
+    template< typename T >
+    BinaryDecoder& operator>>( T& object )
+    {
+        _load( object );
+        return *this;
+    }
+    //@}
+
+private:
+    const char* _data;
+    const char* _end;
+
+    struct TrackedObject
+    {
+        void* address;
+        boost::shared_ptr< void > owner;
+    };
+    std::vector< TrackedObject > _trackedObjects;
+
+    struct RegisteredContent
+    {
+        ContentPtr content;
+        uint32_t version;
+        bool referenced;
+    };
+    typedef std::map< uint32_t, RegisteredContent > RegisteredContents;
+    bool _contentRegistryEnabled;
+    RegisteredContents _registeredContents;
+
+    void _read( void* data, size_t size );
+
+    template< typename T >
+    typename boost::enable_if_c< boost::is_arithmetic< T >::value >::type
+    _load( T& value )
+    {
+        _read( &value, sizeof( T ));
+    }
+
+    template< typename T >
+    typename boost::enable_if< boost::is_enum< T >>::type
+    _load( T& value )
+    {
+        int32_t intValue = 0;
+        _load( intValue );
+        value = T( intValue );
+    }
+
+    template< typename T >
+    typename boost::enable_if< boost::is_class< T >>::type
+    _load( T& object )
+    {
+        uint8_t version = 0;
+        _load( version );
+        if( int( version ) > boost::serialization::version< T >::value )
+            throw std::runtime_error( "Unsupported binary object version" );
+        boost::serialization::access::serialize( *this, object, version );
+    }
+
+    template< typename T >
+    void _load( const boost::serialization::nvp< T >& nvp )
+    {
+        _load( nvp.value( ));
+    }
+
+    template< typename T >
+    void _load( std::vector< T >& vector )
+    {
+        vector.clear();
+        vector.resize( _loadSize( ));
+        for( T& item : vector )
+            _load( item );
+    }
+
+    template< typename T >
+    void _load( std::set< T >& set )
+    {
+        set.clear();
+        const uint32_t size = _loadSize();
+        for( uint32_t i = 0; i < size; ++i )
+        {
+            T item;
+            _load( item );
+            set.insert( item );
+        }
+    }
+
+    template< typename K, typename V >
+    void _load( std::map< K, V >& map )
+    {
+        map.clear();
+        const uint32_t size = _loadSize();
+        for( uint32_t i = 0; i < size; ++i )
+        {
+            K key;
+            _load( key );
+            _load( map[key] );
+        }
+    }
+
+    template< typename T >
+    void _load( boost::shared_ptr< T >& ptr )
+    {
+        const uint32_t tag = _loadTag();
+        if( _isReference( tag ))
+            ptr = boost::static_pointer_cast< T >( _getOwner( tag ));
+        else if( _isNewObject( tag ))
+            _loadNew( ptr );
+        else
+            ptr.reset();
+    }
+
+    template< typename T >
+    void _load( boost::scoped_ptr< T >& ptr )
+    {
+        T* object = 0;
+        _load( object );
+        ptr.reset( object );
+    }
+
+    template< typename T >
+    void _load( T*& ptr )
+    {
+        typedef typename boost::remove_const< T >::type Type;
+
+        const uint32_t tag = _loadTag();
+        if( _isReference( tag ))
+            ptr = static_cast< Type* >( _getAddress( tag ));
+        else if( _isNewObject( tag ))
+        {
+            Type* object = _create< Type >();
+            _track( object, boost::shared_ptr< void >( ));
+            _load( *object );
+            ptr = object;
+        }
+        else
+            ptr = 0;
+    }
+
+    template< typename T >
+    void _loadNew( boost::shared_ptr< T >& ptr )
+    {
+        ptr.reset( _create< T >( ));
+        _track( ptr.get(), ptr );
+        _load( *ptr );
+    }
+
+    void _load( ContentPtr& content );
+    void _loadNew( ContentPtr& content );
+    void _endContentRegistryMessage();
+
+    template< typename T >
+    void _loadNewContent( ContentPtr& content )
+    {
+        boost::shared_ptr< T > derived( _create< T >( ));
+        content = derived;
+        _track( content.get(), content );
+        _load( *derived );
+    }
+
+    template< typename T >
+    static T* _create()
+    {
+        void* memory = ::operator new( sizeof( T ));
+        try
+        {
+            boost::serialization::access::construct( static_cast< T* >( memory ));
+        }
+        catch( ... )
+        {
+            ::operator delete( memory );
+            throw;
+        }
+        return static_cast< T* >( memory );
+    }
+
+    uint32_t _loadSize();
+    uint32_t _loadTag();
+    bool _isReference( uint32_t tag ) const;
+    bool _isNewObject( uint32_t tag ) const;
+    void* _getAddress( uint32_t tag ) const;
+    boost::shared_ptr< void > _getOwner( uint32_t tag ) const;
+    void _track( void* object, boost::shared_ptr< void > owner );
+
+    void _load( QString& string );
+    void _load( QByteArray& array );
+    void _load( QUuid& uuid );
+    void _load( QColor& color );
+    void _load( QPointF& point );
+    void _load( QRectF& rect );
+    void _load( QSize& size );
+    void _load( deflect::Frame& frame );
+    void _load( deflect::Segment& segment );
+    void _load( deflect::SegmentParameters& parameters );
+};
+
+#endif // BINARYCODEC_H
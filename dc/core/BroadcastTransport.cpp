@@ -0,0 +1,152 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+#include "BroadcastTransport.h"
+
+#include "MPIBroadcastTransport.h"
+#include "MPIChannel.h"
+#include "log.h"
+
+#if ENABLE_SHM_TRANSPORT
+#  include "SharedMemoryBroadcastTransport.h"
+#  include <unistd.h>
+#endif
+
+#include <stdexcept>
+
+#define RANK0 0
+
+namespace
+{
+#if ENABLE_SHM_TRANSPORT
+const size_t SHARED_MEMORY_CAPACITY = 64 * 1024 * 1024;
+#endif
+
+bool canShareMemory( const MPIChannel& worldChannel )
+{
+#if ENABLE_SHM_TRANSPORT
+    return worldChannel.getNodeSize() == worldChannel.getSize();
+#else
+    (void)worldChannel;
+    return false;
+#endif
+}
+
+/** @return true if all the processes have succeeded, collectively. */
+bool allSucceeded( MPIChannel& worldChannel, const bool success )
+{
+    return worldChannel.globalSum( success ? 0 : 1 ) == 0;
+}
+}
+
+BroadcastSenderPtr BroadcastSender::create( const BroadcastTransportType type,
+                                            MPIChannelPtr worldChannel )
+{
+    if( type == TRANSPORT_SHARED_MEMORY )
+    {
+        if( !canShareMemory( *worldChannel ))
+            put_flog( LOG_WARN, "shared memory transport not available, "
+                                "using MPI" );
+#if ENABLE_SHM_TRANSPORT
+        else
+        {
+            std::unique_ptr< SharedMemoryRing > ring;
+            try
+            {
+                const std::string name = "/displaycluster-" +
+                                      std::to_string( (long long)getpid( ));
+                ring.reset( new SharedMemoryRing( name, SHARED_MEMORY_CAPACITY,
+                                                  worldChannel->getSize() - 1 ));
+            }
+            catch( const std::runtime_error& e )
+            {
+                put_flog( LOG_ERROR, "%s", e.what( ));
+            }
+
+            // Walls open the ring before its name is removed, so that the
+            // memory is not leaked if a process crashes.
+            worldChannel->broadcast( MPI_MESSAGE_TYPE_NONE,
+                                     ring ? ring->getName() : std::string( ));
+            const bool success = allSucceeded( *worldChannel, !!ring );
+            if( ring )
+                ring->unlink();
+
+            if( success )
+                return BroadcastSenderPtr(
+                            new SharedMemoryBroadcastSender( std::move( ring )));
+            put_flog( LOG_WARN, "shared memory transport failed, using MPI" );
+        }
+#endif
+    }
+    return BroadcastSenderPtr( new MPIBroadcastSender( worldChannel ));
+}
+
+BroadcastReceiverPtr BroadcastReceiver::create(
+        const BroadcastTransportType type, MPIChannelPtr worldChannel )
+{
+#if ENABLE_SHM_TRANSPORT
+    if( type == TRANSPORT_SHARED_MEMORY && canShareMemory( *worldChannel ))
+    {
+        const MPIHeader header = worldChannel->receiveHeader( RANK0 );
+        std::string name( header.size, '\0' );
+        worldChannel->receiveBroadcast( &name[0], header.size, RANK0 );
+
+        std::unique_ptr< SharedMemoryRing > ring;
+        if( !name.empty( ))
+        {
+            // Walls are the ranks [1, size[ of the world channel
+            try
+            {
+                ring.reset( new SharedMemoryRing( name,
+                                                 worldChannel->getRank() - 1 ));
+            }
+            catch( const std::runtime_error& e )
+            {
+                put_flog( LOG_ERROR, "%s", e.what( ));
+            }
+        }
+        if( allSucceeded( *worldChannel, !!ring ))
+            return BroadcastReceiverPtr(
+                        new SharedMemoryBroadcastReceiver( std::move( ring )));
+    }
+#else
+    (void)type;
+#endif
+    return BroadcastReceiverPtr( new MPIBroadcastReceiver( worldChannel ));
+}
@@ -0,0 +1,115 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+#ifndef BROADCASTTRANSPORT_H
+#define BROADCASTTRANSPORT_H
+
+#include "types.h"
+#include "MPIHeader.h"
+
+#include <boost/noncopyable.hpp>
+
+#include <string>
+
+/** The transports available for the messages from the master to the walls. */
+enum BroadcastTransportType
+{
+    TRANSPORT_MPI,
+    TRANSPORT_SHARED_MEMORY
+};
+
+/**
+ * Send messages from the master process to all the wall processes.
+ */
+class BroadcastSender : public boost::noncopyable
+{
+public:
+    virtual ~BroadcastSender() {}
+
+    /**
+     * Create the sender of the master process.
+     * This is a collective operation on the world channel, the wall processes
+     * must call BroadcastReceiver::create() with the same type.
+     * The shared memory transport falls back to MPI if it is not supported or
+     * if the processes do not all run on the same host.
+     * @param type The requested type of transport
+     * @param worldChannel The channel to all the processes
+     */
+    static BroadcastSenderPtr create( BroadcastTransportType type,
+                                      MPIChannelPtr worldChannel );
+
+    /**
+     * Send a message, possibly asynchronously.
+     * @param header The message header
+     * @param data The payload of size header.size. Its contents may be swapped
+     *        with a buffer of a previous message for reuse.
+     */
+    virtual void send( const MPIHeader& header, std::string& data ) = 0;
+
+    /** Block until all the messages have been sent. */
+    virtual void flush() = 0;
+};
+
+/**
+ * Receive the messages sent by the master process to the wall processes.
+ */
+class BroadcastReceiver : public boost::noncopyable
+{
+public:
+    virtual ~BroadcastReceiver() {}
+
+    /**
+     * Create the receiver of a wall process.
+     * @see BroadcastSender::create()
+     * @param type The requested type of transport
+     * @param worldChannel The channel to all the processes
+     */
+    static BroadcastReceiverPtr create( BroadcastTransportType type,
+                                        MPIChannelPtr worldChannel );
+
+    /**
+     * Receive the next message, blocking until it is available.
+     * Must not be called again after the MPI_MESSAGE_TYPE_QUIT message.
+     * @param header The message header
+     * @return the payload of size header.size, valid until the next call
+     */
+    virtual const char* receive( MPIHeader& header ) = 0;
+};
+
+#endif // BROADCASTTRANSPORT_H
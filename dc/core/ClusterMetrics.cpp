@@ -0,0 +1,361 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+#include "ClusterMetrics.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <sstream>
+
+namespace
+{
+const std::string PREFIX( "displaycluster_" );
+
+QJsonObject histogramToJson( const DurationHistogram& histogram )
+{
+    const std::vector< double >& bounds = DurationHistogram::getBounds();
+
+    QJsonArray buckets;
+    uint64_t cumulativeCount = 0;
+    for( size_t i = 0; i < histogram.counts.size(); ++i )
+    {
+        cumulativeCount += histogram.counts[i];
+
+        QJsonObject bucket;
+        if( i < bounds.size( ))
+            bucket["le"] = bounds[i];
+        else
+            bucket["le"] = QString( "+Inf" );
+        bucket["count"] = double( cumulativeCount );
+        buckets.append( bucket );
+    }
+
+    QJsonObject object;
+    object["count"] = double( histogram.count );
+    object["sum"] = histogram.sum;
+    object["buckets"] = buckets;
+    return object;
+}
+
+QJsonObject toJson( const std::map< std::string, uint64_t >& values )
+{
+    QJsonObject object;
+    for( const auto& value : values )
+        object[QString::fromStdString( value.first )] = double( value.second );
+    return object;
+}
+
+std::string escapeLabel( const std::string& value )
+{
+    std::string escaped;
+    escaped.reserve( value.size( ));
+    for( const char c : value )
+    {
+        if( c == '\\' || c == '"' )
+            escaped += '\\';
+        if( c == '\n' )
+            escaped += "\\n";
+        else
+            escaped += c;
+    }
+    return escaped;
+}
+
+void writeHeader( std::ostream& out, const std::string& name,
+                  const std::string& type, const std::string& help )
+{
+    out << "# HELP " << PREFIX << name << " " << help << "\n"
+        << "# TYPE " << PREFIX << name << " " << type << "\n";
+}
+
+void writeHistogram( std::ostream& out, const std::string& name,
+                     const int rank, const DurationHistogram& histogram )
+{
+    const std::vector< double >& bounds = DurationHistogram::getBounds();
+    const std::string metric = PREFIX + name;
+
+    uint64_t cumulativeCount = 0;
+    for( size_t i = 0; i < histogram.counts.size(); ++i )
+    {
+        cumulativeCount += histogram.counts[i];
+        out << metric << "_bucket{rank=\"" << rank << "\",le=\"";
+        if( i < bounds.size( ))
+            out << bounds[i] / 1000.0;
+        else
+            out << "+Inf";
+        out << "\"} " << cumulativeCount << "\n";
+    }
+    out << metric << "_sum{rank=\"" << rank << "\"} "
+        << histogram.sum / 1000.0 << "\n";
+    out << metric << "_count{rank=\"" << rank << "\"} "
+        << histogram.count << "\n";
+}
+}
+
+ClusterMetrics::ClusterMetrics()
+{
+}
+
+void ClusterMetrics::update( const ProcessMetrics& metrics )
+{
+    const Clock::time_point now = Clock::now();
+
+    const std::lock_guard< std::mutex > lock( _mutex );
+
+    ProcessReport& report = _reports[metrics.rank];
+    report.frameRate = 0.0;
+    if( report.time != Clock::time_point( ))
+    {
+        const std::chrono::duration< double > elapsed = now - report.time;
+        const uint64_t previousCount = report.metrics.frameTimes.count;
+        if( elapsed.count() > 0.0 && metrics.frameTimes.count >= previousCount )
+            report.frameRate = ( metrics.frameTimes.count - previousCount ) /
+                               elapsed.count();
+    }
+    report.metrics = metrics;
+    report.time = now;
+}
+
+std::string ClusterMetrics::toJson() const
+{
+    const Clock::time_point now = Clock::now();
+
+    const std::lock_guard< std::mutex > lock( _mutex );
+
+    QJsonArray processes;
+    for( const auto& it : _reports )
+    {
+        const ProcessMetrics& metrics = it.second.metrics;
+        const std::chrono::duration< double > age = now - it.second.time;
+
+        QJsonObject streamsFps;
+        for( const auto& stream : metrics.streamsFps )
+            streamsFps[QString::fromStdString( stream.first )] = stream.second;
+
+        QJsonObject process;
+        process["rank"] = metrics.rank;
+        process["age"] = age.count();
+        process["frameRate"] = it.second.frameRate;
+        process["frameTimes"] = histogramToJson( metrics.frameTimes );
+        process["decodeTimes"] = histogramToJson( metrics.decodeTimes );
+        process["uploadTimes"] = histogramToJson( metrics.uploadTimes );
+        process["gpuWaitTimes"] = histogramToJson( metrics.gpuWaitTimes );
+        process["wakeTimes"] = histogramToJson( metrics.wakeTimes );
+        process["controlQueueTimes"] =
+                histogramToJson( metrics.controlQueueTimes );
+        process["streamQueueTimes"] =
+                histogramToJson( metrics.streamQueueTimes );
+        process["streamsFps"] = streamsFps;
+        process["textureMemory"] = double( metrics.textureMemory );
+        process["queueDepth"] = double( metrics.queueDepth );
+        process["skippedFrames"] = double( metrics.skippedFrames );
+        process["supersededFrames"] = double( metrics.supersededFrames );
+        process["cpuTime"] = metrics.cpuTime;
+        process["uploadBacklog"] = double( metrics.uploadBacklog );
+        process["maxUploadFrameTime"] = metrics.maxUploadFrameTime;
+        process["windowsMemory"] = toJson( metrics.windowsMemory );
+        process["contentTypesMemory"] = toJson( metrics.contentTypesMemory );
+        process["memoryBudget"] = double( metrics.memoryBudget );
+        process["evictions"] = double( metrics.evictions );
+        processes.append( process );
+    }
+
+    QJsonObject root;
+    root["processes"] = processes;
+    return QJsonDocument( root ).toJson().toStdString();
+}
+
+std::string ClusterMetrics::toPrometheus() const
+{
+    const Clock::time_point now = Clock::now();
+
+    const std::lock_guard< std::mutex > lock( _mutex );
+
+    std::ostringstream out;
+
+    writeHeader( out, "frame_duration_seconds", "histogram",
+                 "Time between the start of two consecutive frames." );
+    for( const auto& it : _reports )
+        writeHistogram( out, "frame_duration_seconds", it.first,
+                        it.second.metrics.frameTimes );
+
+    writeHeader( out, "decode_duration_seconds", "histogram",
+                 "Time spent decoding movie frames and images." );
+    for( const auto& it : _reports )
+        writeHistogram( out, "decode_duration_seconds", it.first,
+                        it.second.metrics.decodeTimes );
+
+    writeHeader( out, "upload_duration_seconds", "histogram",
+                 "Time spent uploading textures to the GPU." );
+    for( const auto& it : _reports )
+        writeHistogram( out, "upload_duration_seconds", it.first,
+                        it.second.metrics.uploadTimes );
+
+    writeHeader( out, "gpu_wait_duration_seconds", "histogram",
+                 "Time spent waiting for the GPU to complete the previous "
+                 "frames." );
+    for( const auto& it : _reports )
+        writeHistogram( out, "gpu_wait_duration_seconds", it.first,
+                        it.second.metrics.gpuWaitTimes );
+
+    writeHeader( out, "wake_duration_seconds", "histogram",
+                 "Time for the idle processes to resume rendering after a "
+                 "change." );
+    for( const auto& it : _reports )
+        writeHistogram( out, "wake_duration_seconds", it.first,
+                        it.second.metrics.wakeTimes );
+
+    writeHeader( out, "control_queue_duration_seconds", "histogram",
+                 "Time control messages wait in the send queue of the "
+                 "master." );
+    for( const auto& it : _reports )
+        writeHistogram( out, "control_queue_duration_seconds", it.first,
+                        it.second.metrics.controlQueueTimes );
+
+    writeHeader( out, "stream_queue_duration_seconds", "histogram",
+                 "Time pixel stream frames wait in the send queue of the "
+                 "master." );
+    for( const auto& it : _reports )
+        writeHistogram( out, "stream_queue_duration_seconds", it.first,
+                        it.second.metrics.streamQueueTimes );
+
+    writeHeader( out, "frame_rate", "gauge",
+                 "Frames per second since the previous report." );
+    for( const auto& it : _reports )
+        out << PREFIX << "frame_rate{rank=\"" << it.first << "\"} "
+            << it.second.frameRate << "\n";
+
+    writeHeader( out, "stream_fps", "gauge",
+                 "Frames per second received for each pixel stream." );
+    for( const auto& it : _reports )
+    {
+        for( const auto& stream : it.second.metrics.streamsFps )
+            out << PREFIX << "stream_fps{rank=\"" << it.first
+                << "\",stream=\"" << escapeLabel( stream.first ) << "\"} "
+                << stream.second << "\n";
+    }
+
+    writeHeader( out, "texture_memory_bytes", "gauge",
+                 "GPU memory allocated for textures." );
+    for( const auto& it : _reports )
+        out << PREFIX << "texture_memory_bytes{rank=\"" << it.first << "\"} "
+            << it.second.metrics.textureMemory << "\n";
+
+    writeHeader( out, "queue_depth", "gauge",
+                 "Messages or frames waiting to be processed." );
+    for( const auto& it : _reports )
+        out << PREFIX << "queue_depth{rank=\"" << it.first << "\"} "
+            << it.second.metrics.queueDepth << "\n";
+
+    writeHeader( out, "skipped_frames_total", "counter",
+                 "Frames not rendered because nothing changed on the wall." );
+    for( const auto& it : _reports )
+        out << PREFIX << "skipped_frames_total{rank=\"" << it.first << "\"} "
+            << it.second.metrics.skippedFrames << "\n";
+
+    writeHeader( out, "superseded_frames_total", "counter",
+                 "Pixel stream frames replaced by a newer one before the "
+                 "master sent them." );
+    for( const auto& it : _reports )
+        out << PREFIX << "superseded_frames_total{rank=\"" << it.first
+            << "\"} " << it.second.metrics.supersededFrames << "\n";
+
+    writeHeader( out, "cpu_seconds_total", "counter",
+                 "CPU time used by the process." );
+    for( const auto& it : _reports )
+        out << PREFIX << "cpu_seconds_total{rank=\"" << it.first << "\"} "
+            << it.second.metrics.cpuTime << "\n";
+
+    writeHeader( out, "upload_backlog", "gauge",
+                 "Texture uploads postponed to the next frame." );
+    for( const auto& it : _reports )
+        out << PREFIX << "upload_backlog{rank=\"" << it.first << "\"} "
+            << it.second.metrics.uploadBacklog << "\n";
+
+    writeHeader( out, "upload_frame_max_seconds", "gauge",
+                 "Longest time spent uploading textures in a frame." );
+    for( const auto& it : _reports )
+        out << PREFIX << "upload_frame_max_seconds{rank=\"" << it.first
+            << "\"} " << it.second.metrics.maxUploadFrameTime / 1000.0 << "\n";
+
+    writeHeader( out, "window_memory_bytes", "gauge",
+                 "Memory used by the contents of each window." );
+    for( const auto& it : _reports )
+    {
+        for( const auto& window : it.second.metrics.windowsMemory )
+            out << PREFIX << "window_memory_bytes{rank=\"" << it.first
+                << "\",window=\"" << escapeLabel( window.first ) << "\"} "
+                << window.second << "\n";
+    }
+
+    writeHeader( out, "content_type_memory_bytes", "gauge",
+                 "Memory used by the contents of each type." );
+    for( const auto& it : _reports )
+    {
+        for( const auto& type : it.second.metrics.contentTypesMemory )
+            out << PREFIX << "content_type_memory_bytes{rank=\"" << it.first
+                << "\",type=\"" << escapeLabel( type.first ) << "\"} "
+                << type.second << "\n";
+    }
+
+    writeHeader( out, "memory_budget_bytes", "gauge",
+                 "Memory budget of the contents." );
+    for( const auto& it : _reports )
+        out << PREFIX << "memory_budget_bytes{rank=\"" << it.first << "\"} "
+            << it.second.metrics.memoryBudget << "\n";
+
+    writeHeader( out, "evictions_total", "counter",
+                 "Contents evicted to stay within the memory budget." );
+    for( const auto& it : _reports )
+        out << PREFIX << "evictions_total{rank=\"" << it.first << "\"} "
+            << it.second.metrics.evictions << "\n";
+
+    writeHeader( out, "report_age_seconds", "gauge",
+                 "Time since the last report of the process." );
+    for( const auto& it : _reports )
+    {
+        const std::chrono::duration< double > age = now - it.second.time;
+        out << PREFIX << "report_age_seconds{rank=\"" << it.first << "\"} "
+            << age.count() << "\n";
+    }
+
+    return out.str();
+}
@@ -0,0 +1,93 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+#ifndef CLUSTERMETRICS_H
+#define CLUSTERMETRICS_H
+
+#include "Metrics.h"
+
+#include <boost/noncopyable.hpp>
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+
+/**
+ * Aggregate the ProcessMetrics reported by all the processes of the cluster.
+ *
+ * The metrics are exported as JSON for the web interface, and in the
+ * Prometheus text exposition format so that a monitoring system can scrape
+ * them and alert on a wall process dropping frames.
+ *
+ * This class is thread-safe.
+ */
+class ClusterMetrics : public boost::noncopyable
+{
+public:
+    /** Constructor. */
+    ClusterMetrics();
+
+    /**
+     * Update the metrics of a process, replacing its previous report.
+     * @param metrics The latest metrics of the process
+     */
+    void update( const ProcessMetrics& metrics );
+
+    /** @return the metrics of all the processes as a JSON document. */
+    std::string toJson() const;
+
+    /** @return the metrics in the Prometheus text exposition format. */
+    std::string toPrometheus() const;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct ProcessReport
+    {
+        ProcessMetrics metrics;
+        Clock::time_point time;
+        double frameRate;
+    };
+
+    mutable std::mutex _mutex;
+    std::map< int, ProcessReport > _reports;
+};
+
+#endif // CLUSTERMETRICS_H
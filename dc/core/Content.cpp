@@ -47,6 +47,13 @@ qreal Content::maxScale_ = 3.0;
 
 Content::Content( const QString& uri )
     : _uri( uri )
+    , _version( 0 )
+{
+    connect( this, &Content::modified, [this]() { ++_version; } );
+}
+
+Content::Content()
+    : Content( QString( ))
 {
 }
 
@@ -110,6 +117,11 @@ qreal Content::getMaxScale()
     return maxScale_;
 }
 
+uint32_t Content::getVersion() const
+{
+    return _version;
+}
+
 void Content::setDimensions( const QSize& dimensions )
 {
     if( _size == dimensions )
@@ -57,6 +57,8 @@
 #include <QObject>
 #include <QSize>
 
+#include <stdint.h>
+
 #include <deflect/SizeHints.h>
 
 class WallToWallChannel;
@@ -124,6 +126,9 @@ public:
     /** @return the maxium scale factor for zoom and resize */
     static qreal getMaxScale();
 
+    /** @return the version of the content, incremented by modified(). */
+    uint32_t getVersion() const;
+
 signals:
     /** Emitted by any Content subclass when its state has been modified */
     void modified();
@@ -134,7 +139,7 @@ protected:
     friend class boost::serialization::access;
 
     // Default constructor required for boost::serialization
-    Content() {}
+    Content();
 
     /** Serialize for sending to Wall applications. */
     template< class Archive >
@@ -179,6 +184,7 @@ protected:
     QSize _size;
     ContentActionsModel _actions;
     deflect::SizeHints _sizeHints;
+    uint32_t _version;
     static qreal maxScale_;
 };
 
@@ -0,0 +1,121 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+#ifndef CONTENTCACHE_H
+#define CONTENTCACHE_H
+
+#include <QRectF>
+#include <QSize>
+#include <QString>
+
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
+
+#include <map>
+#include <mutex>
+#include <typeindex>
+
+/**
+ * Share the decoded images and GL textures of the contents between the
+ * windows of a Wall process which show the same data.
+ *
+ * Objects are identified by their type and by a key built from the uri of the
+ * content and the parameters of the data (tile, page, resolution...). The
+ * cache only keeps weak references, so that an object is released as soon as
+ * the last window using it drops its reference.
+ *
+ * This class is thread-safe.
+ */
+class ContentCache : public boost::noncopyable
+{
+public:
+    /**
+     * Find a shared object.
+     * @param key The key of the object
+     * @return the object, or a null pointer if no window is using it
+     */
+    template< typename T >
+    boost::shared_ptr<T> find( const QString& key ) const
+    {
+        std::lock_guard<std::mutex> lock( _mutex );
+
+        Entries::const_iterator it = _entries.find( Key( typeid( T ), key ));
+        if( it == _entries.end( ))
+            return boost::shared_ptr<T>();
+        return boost::static_pointer_cast<T>( it->second.lock( ));
+    }
+
+    /**
+     * Share an object with the other windows.
+     * @param key The key of the object, replacing any previous object
+     * @param object The object, which must be kept alive by the caller
+     */
+    template< typename T >
+    void insert( const QString& key, boost::shared_ptr<T> object )
+    {
+        std::lock_guard<std::mutex> lock( _mutex );
+
+        _removeExpiredEntries();
+        _entries[Key( typeid( T ), key )] = object;
+    }
+
+    /** @return the number of objects currently shared. */
+    size_t getSize() const;
+
+    /**
+     * Build the key of a texture showing a region of a content.
+     * @param uri The uri of the content, including the page if any
+     * @param size The size of the texture in pixels
+     * @param region The normalized region of the content shown by the texture
+     */
+    static QString makeKey( const QString& uri, const QSize& size,
+                            const QRectF& region );
+
+private:
+    typedef std::pair< std::type_index, QString > Key;
+    typedef std::map< Key, boost::weak_ptr<void> > Entries;
+
+    mutable std::mutex _mutex;
+    Entries _entries;
+
+    void _removeExpiredEntries();
+};
+
+#endif // CONTENTCACHE_H
@@ -43,6 +43,7 @@
 #include "WallContent.h"
 
 #include <QtGui/QPainter>
+#include <QStyleOptionGraphicsItem>
 
 #include <GL/gl.h>
 
@@ -52,11 +53,19 @@ ContentItem::ContentItem( QDeclarativeItem* parentItem_ )
     , role_( ROLE_CONTENT )
 {
     setFlag( QGraphicsItem::ItemHasNoContents, false );
+    // Provides the exposedRect, to render only what is visible on each screen
+    setFlag( QGraphicsItem::ItemUsesExtendedStyleOption, true );
 }
 
-void ContentItem::paint( QPainter* painter, const QStyleOptionGraphicsItem*,
-                         QWidget*)
+void ContentItem::paint( QPainter* painter,
+                         const QStyleOptionGraphicsItem* option, QWidget*)
 {
+    exposedSceneRect_ = mapRectToScene( option->exposedRect );
+
+    // The content is not loaded while it is away from the screens
+    if( !wallContent_ )
+        return;
+
     painter->beginNativePainting();
 
     glPushMatrix();
@@ -95,6 +104,11 @@ QRectF ContentItem::getSceneRect() const
     return mapRectToScene( boundingRect( ));
 }
 
+const QRectF& ContentItem::getExposedSceneRect() const
+{
+    return exposedSceneRect_;
+}
+
 bool ContentItem::isAnimating() const
 {
     return property("animating").toBool();
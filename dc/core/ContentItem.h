@@ -76,6 +76,12 @@ public:
     /** Get the scene coordinates of the item. */
     QRectF getSceneRect() const;
 
+    /**
+     * Get the part of the item visible on the screen being painted, in scene
+     * coordinates. Only valid during paint().
+     */
+    const QRectF& getExposedSceneRect() const;
+
     /** Check if the item's size or position is being animated from QML. */
     bool isAnimating() const;
 
@@ -88,6 +94,7 @@ signals:
 private:
     WallContent* wallContent_;
     Role role_;
+    QRectF exposedSceneRect_;
 };
 
 #endif // CONTENTITEM_H
@@ -0,0 +1,87 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+#include "ContentLoadingPolicy.h"
+
+const int ContentLoadingPolicy::DEFAULT_PREFETCH_MARGIN = 512;
+const int ContentLoadingPolicy::DEFAULT_UNLOAD_DELAY_MS = 10000;
+
+ContentLoadingPolicy::ContentLoadingPolicy( const int prefetchMargin,
+                                            const int unloadDelayMs )
+    : _prefetchMargin( prefetchMargin )
+    , _unloadDelayMs( unloadDelayMs )
+    , _loaded( false )
+{
+}
+
+bool ContentLoadingPolicy::update( const QRectF& sceneRect,
+                                   const QRegion& visibleWallArea,
+                                   const boost::posix_time::ptime& time )
+{
+    const QRect nearbyRect =
+        sceneRect.toAlignedRect().adjusted( -_prefetchMargin, -_prefetchMargin,
+                                            _prefetchMargin, _prefetchMargin );
+
+    if( visibleWallArea.intersects( nearbyRect ))
+    {
+        _lastNearbyTime = time;
+        _loaded = true;
+    }
+    else if( _loaded && ( time - _lastNearbyTime ).total_milliseconds() >=
+                        _unloadDelayMs )
+    {
+        _loaded = false;
+    }
+    return _loaded;
+}
+
+bool ContentLoadingPolicy::isLoaded() const
+{
+    return _loaded;
+}
+
+int ContentLoadingPolicy::getPrefetchMargin() const
+{
+    return _prefetchMargin;
+}
+
+int ContentLoadingPolicy::getUnloadDelayMs() const
+{
+    return _unloadDelayMs;
+}
@@ -0,0 +1,105 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+#ifndef CONTENTLOADINGPOLICY_H
+#define CONTENTLOADINGPOLICY_H
+
+#ifndef Q_MOC_RUN
+#include <boost/date_time/posix_time/posix_time.hpp>
+#endif
+
+#include <QRectF>
+#include <QRegion>
+
+/**
+ * Decide when a Wall process loads and unloads the data of a content.
+ *
+ * A content is loaded as soon as its window comes within a margin of the
+ * screens of the process, so that it is ready when it becomes visible. It is
+ * unloaded once it has stayed away from them for a given delay, so that
+ * windows moved back and forth are not reloaded every time.
+ */
+class ContentLoadingPolicy
+{
+public:
+    /** Default margin around the screens of the process, in pixels. */
+    static const int DEFAULT_PREFETCH_MARGIN;
+
+    /** Default delay before unloading a content, in milliseconds. */
+    static const int DEFAULT_UNLOAD_DELAY_MS;
+
+    /**
+     * Constructor.
+     * @param prefetchMargin The margin around the screens of the process in
+     *        which contents are loaded, in pixels
+     * @param unloadDelayMs The time after which a content that stayed outside
+     *        of the margin is unloaded, in milliseconds
+     */
+    ContentLoadingPolicy( int prefetchMargin = DEFAULT_PREFETCH_MARGIN,
+                          int unloadDelayMs = DEFAULT_UNLOAD_DELAY_MS );
+
+    /**
+     * Update the policy with the current position of the content.
+     * @param sceneRect The area of the content on the wall
+     * @param visibleWallArea The area of the wall covered by the screens of
+     *        this process
+     * @param time The current time
+     * @return true if the content must be loaded, false if it must be unloaded
+     */
+    bool update( const QRectF& sceneRect, const QRegion& visibleWallArea,
+                 const boost::posix_time::ptime& time =
+                     boost::posix_time::microsec_clock::universal_time( ));
+
+    /** @return the decision taken by the last update(). */
+    bool isLoaded() const;
+
+    /** @return the margin around the screens of the process, in pixels. */
+    int getPrefetchMargin() const;
+
+    /** @return the delay before unloading a content, in milliseconds. */
+    int getUnloadDelayMs() const;
+
+private:
+    int _prefetchMargin;
+    int _unloadDelayMs;
+    bool _loaded;
+    boost::posix_time::ptime _lastNearbyTime;
+};
+
+#endif // CONTENTLOADINGPOLICY_H
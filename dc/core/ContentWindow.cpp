@@ -106,6 +106,33 @@ void ContentWindow::setContent( ContentPtr content )
 
     content_ = content;
     init();
+
+    emit contentChanged();
+    emit labelChanged();
+}
+
+void ContentWindow::update( const ContentWindow& window )
+{
+    if( window.content_ != content_ )
+        setContent( window.content_ );
+
+    setCoordinates( window.coordinates_ );
+    setZoomRect( window.zoomRect_ );
+    setBorder( window.windowBorder_ );
+    setFocusedCoordinates( window.focusedCoordinates_ );
+    setControlsVisible( window.controlsVisible_ );
+
+    // Copied directly, setFocused() and setState() also change other fields
+    if( window.focused_ != focused_ )
+    {
+        focused_ = window.focused_;
+        emit focusedChanged();
+    }
+    if( window.windowState_ != windowState_ )
+    {
+        windowState_ = window.windowState_;
+        emit stateChanged();
+    }
 }
 
 ContentWindowController* ContentWindow::getController()
@@ -149,6 +176,7 @@ void ContentWindow::setZoomRect( const QRectF& zoomRect )
         return;
 
     zoomRect_ = zoomRect;
+    emit zoomRectChanged();
     emit modified();
 }
 
@@ -76,8 +76,8 @@ class ContentWindow : public Coordinates
     Q_PROPERTY( bool focused READ isFocused WRITE setFocused NOTIFY focusedChanged )
     Q_PROPERTY( QString label READ getLabel NOTIFY labelChanged )
     Q_PROPERTY( bool controlsVisible READ getControlsVisible WRITE setControlsVisible NOTIFY controlsVisibleChanged )
-    Q_PROPERTY( Content* content READ getContentPtr CONSTANT )
-    Q_PROPERTY( QRectF zoomRect READ getZoomRect CONSTANT )
+    Q_PROPERTY( Content* content READ getContentPtr NOTIFY contentChanged )
+    Q_PROPERTY( QRectF zoomRect READ getZoomRect NOTIFY zoomRectChanged )
     Q_PROPERTY( ContentInteractionDelegate* delegate READ getInteractionDelegate CONSTANT )
     Q_PROPERTY( ContentWindowController* controller READ getController CONSTANT )
     Q_PROPERTY( QRectF focusedCoordinates READ getFocusedCoordinates
@@ -129,9 +129,17 @@ public:
     /** Get the content. */
     ContentPtr getContent() const;
 
-    /** Set the content, replacing the existing one. @note Rank0 only. */
+    /** Set the content, replacing the existing one. */
     void setContent( ContentPtr content );
 
+    /**
+     * Update the window with the state of a newer copy of it, such as one
+     * received from Rank0. Only the properties which changed are notified.
+     * The controller and the interaction delegate are not updated.
+     * @param window A copy of this window, with the same id
+     */
+    void update( const ContentWindow& window );
+
 
     /** @return the controller for this window, or 0 if the window has not been
      *          added to a DisplayGroup.
@@ -227,6 +235,8 @@ signals:
 
     /** @name QProperty notifiers */
     //@{
+    void contentChanged();
+    void zoomRectChanged();
     void borderChanged();
     void focusedChanged();
     void focusedCoordinatesChanged();
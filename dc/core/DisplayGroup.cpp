@@ -46,11 +46,13 @@
 IMPLEMENT_SERIALIZE_FOR_XML( DisplayGroup )
 
 DisplayGroup::DisplayGroup()
+    : _hasFocusedWindows( false )
 {
 }
 
 DisplayGroup::DisplayGroup( const QSizeF& size )
     : _showWindowTitles( true )
+    , _hasFocusedWindows( false )
 {
     coordinates_.setSize( size );
 }
@@ -174,12 +176,28 @@ void DisplayGroup::setContentWindows( ContentWindowPtrs contentWindows )
             _focusedWindows.insert( window );
     }
     _updateFocusedWindowsCoordinates();
+    _setHasFocusedWindows( !_focusedWindows.empty( ));
     sendDisplayGroup();
 }
 
+void DisplayGroup::update( const DisplayGroup& displayGroup )
+{
+    setCoordinates( displayGroup.coordinates_ );
+
+    if( displayGroup._showWindowTitles != _showWindowTitles )
+    {
+        _showWindowTitles = displayGroup._showWindowTitles;
+        emit showWindowTitlesChanged( _showWindowTitles );
+    }
+
+    // Only the flag is copied, the focused windows of the other group are
+    // not the windows rendered by this one.
+    _setHasFocusedWindows( displayGroup._hasFocusedWindows );
+}
+
 bool DisplayGroup::hasFocusedWindows() const
 {
-    return !_focusedWindows.empty();
+    return _hasFocusedWindows;
 }
 
 void DisplayGroup::focus( const QUuid& id )
@@ -191,9 +209,7 @@ void DisplayGroup::focus( const QUuid& id )
     _focusedWindows.insert( window );
     _updateFocusedWindowsCoordinates();
     window->setFocused( true );
-
-    if( _focusedWindows.size() == 1 )
-        emit hasFocusedWindowsChanged();
+    _setHasFocusedWindows( true );
 
     sendDisplayGroup();
 }
@@ -257,12 +273,19 @@ void DisplayGroup::_removeFocusedWindow( ContentWindowPtr window )
     if( _focusedWindows.erase( window ))
     {
         _updateFocusedWindowsCoordinates();
-
-        if( _focusedWindows.empty( ))
-            emit hasFocusedWindowsChanged();
+        _setHasFocusedWindows( !_focusedWindows.empty( ));
     }
 }
 
+void DisplayGroup::_setHasFocusedWindows( const bool value )
+{
+    if( _hasFocusedWindows == value )
+        return;
+
+    _hasFocusedWindows = value;
+    emit hasFocusedWindowsChanged();
+}
+
 void DisplayGroup::_updateFocusedWindowsCoordinates()
 {
     LayoutEngine engine( *this );
@@ -129,6 +129,16 @@ public:
     /** Get the set of focused windows. */
     const ContentWindowSet& getFocusedWindows() const;
 
+    /**
+     * Update the coordinates, the window titles and the hasFocusedWindows flag
+     * with those of a newer copy of the DisplayGroup, such as one received
+     * from Rank0. Only the properties which changed are notified. The windows
+     * are not copied, not even the focused ones, they are updated
+     * individually by the wall renderers.
+     * @param displayGroup A newer copy of this DisplayGroup
+     */
+    void update( const DisplayGroup& displayGroup );
+
 public slots:
     /** Clear all ContentWindows. */
     void clear();
@@ -186,6 +196,7 @@ private:
         ar & _showWindowTitles;
         ar & _contentWindows;
         ar & _focusedWindows;
+        ar & _hasFocusedWindows;
         ar & coordinates_;
     }
 
@@ -215,6 +226,7 @@ private:
             else
                 window->setState( ContentWindow::NONE );
         }
+        _hasFocusedWindows = !_focusedWindows.empty();
     }
 
     /** Saving to xml. */
@@ -227,10 +239,12 @@ private:
     void _watchChanges( ContentWindowPtr contentWindow );
     void _removeFocusedWindow( ContentWindowPtr window );
     void _updateFocusedWindowsCoordinates();
+    void _setHasFocusedWindows( bool value );
 
     bool _showWindowTitles;
     ContentWindowPtrs _contentWindows;
     ContentWindowSet _focusedWindows;
+    bool _hasFocusedWindows;
 };
 
 BOOST_CLASS_VERSION( DisplayGroup, FIRST_DISPLAYGROUP_VERSION )
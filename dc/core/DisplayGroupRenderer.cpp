@@ -69,7 +69,14 @@ DisplayGroupRenderer::DisplayGroupRenderer( RenderContextPtr renderContext )
     , _displayGroupItem( 0 )
     , _options( new Options )
 {
-    setDisplayGroup( _displayGroup );
+    QmlWindowRenderer::preload( _renderContext->getQmlItemPool( ));
+
+    // The DisplayGroup stays bound to the scene, new states are copied into it
+    QDeclarativeEngine& engine = _renderContext->getQmlEngine();
+    engine.rootContext()->setContextProperty( "displaygroup",
+                                              _displayGroup.get( ));
+    _createDisplayGroupQmlItem();
+
     setRenderingOptions( _options );
 }
 
@@ -86,14 +93,8 @@ void DisplayGroupRenderer::setRenderingOptions( OptionsPtr options )
 
 void DisplayGroupRenderer::setDisplayGroup( DisplayGroupPtr displayGroup )
 {
-    QDeclarativeEngine& engine = _renderContext->getQmlEngine();
-
-    // Update the scene with the new information
-    engine.rootContext()->setContextProperty( "displaygroup",
-                                              displayGroup.get( ));
-
-    if( !_displayGroupItem )
-        _createDisplayGroupQmlItem();
+    // Only notify the properties which changed
+    _displayGroup->update( *displayGroup );
 
     ContentWindowPtrs contentWindows = displayGroup->getContentWindows();
 
@@ -127,13 +128,10 @@ void DisplayGroupRenderer::setDisplayGroup( DisplayGroupPtr displayGroup )
         }
     }
 
-    // Retain the new DisplayGroup
-    _displayGroup = displayGroup;
-
     // Work around a bug in animation in Qt, where the opacity property
     // of the focus context may not always be restored to its original value.
     // See JIRA issue: DISCL-305
-    if( !displayGroup->hasFocusedWindows( ))
+    if( !_displayGroup->hasFocusedWindows( ))
     {
         for( QGraphicsItem* child : _displayGroupItem->childItems( ))
         {
@@ -145,7 +143,7 @@ void DisplayGroupRenderer::setDisplayGroup( DisplayGroupPtr displayGroup )
 
 void DisplayGroupRenderer::preRenderUpdate( WallToWallChannel& wallChannel )
 {
-    const QRect& visibleWallArea = _renderContext->getVisibleWallArea();
+    const QRegion& visibleWallArea = _renderContext->getVisibleWallArea();
     foreach( QmlWindowPtr window, _windowItems )
     {
         window->preRenderUpdate( wallChannel, visibleWallArea );
@@ -164,6 +162,16 @@ void DisplayGroupRenderer::postRenderUpdate( WallToWallChannel& wallChannel )
         _backgroundWindowItem->postRenderUpdate( wallChannel );
 }
 
+bool DisplayGroupRenderer::isModified()
+{
+    foreach( QmlWindowPtr window, _windowItems )
+    {
+        if( window->isModified( ))
+            return true;
+    }
+    return _backgroundWindowItem && _backgroundWindowItem->isModified();
+}
+
 void DisplayGroupRenderer::_createDisplayGroupQmlItem()
 {
     QDeclarativeEngine& engine = _renderContext->getQmlEngine();
@@ -175,10 +183,9 @@ void DisplayGroupRenderer::_createDisplayGroupQmlItem()
 
 void DisplayGroupRenderer::_createWindowQmlItem( ContentWindowPtr window )
 {
-    QDeclarativeEngine& engine = _renderContext->getQmlEngine();
-
     const QUuid& id = window->getID();
-    _windowItems[id].reset( new QmlWindowRenderer( engine, *_displayGroupItem,
+    _windowItems[id].reset( new QmlWindowRenderer( *_renderContext,
+                                                   *_displayGroupItem,
                                                    window ));
     emit windowAdded( _windowItems[id] );
 }
@@ -205,8 +212,7 @@ void DisplayGroupRenderer::_setBackground( ContentPtr content )
     window->setController(
                make_unique<ContentWindowController>( *window, *_displayGroup ));
     window->getController()->adjustSize( SIZE_FULLSCREEN );
-    QDeclarativeEngine& engine = _renderContext->getQmlEngine();
-    _backgroundWindowItem.reset( new QmlWindowRenderer( engine,
+    _backgroundWindowItem.reset( new QmlWindowRenderer( *_renderContext,
                                                         *_displayGroupItem,
                                                         window, true ));
     _backgroundWindowItem->setStackingOrder( BACKGROUND_STACKING_ORDER );
@@ -67,8 +67,11 @@ public:
     void preRenderUpdate( WallToWallChannel& wallChannel );
     void postRenderUpdate( WallToWallChannel& wallChannel );
 
+    /** @return true if the content of any window must be rendered again. */
+    bool isModified();
+
 public slots:
-    /** Set the DisplayGroup to render, replacing the previous one. */
+    /** Update the rendered DisplayGroup with a new state of it. */
     void setDisplayGroup( DisplayGroupPtr displayGroup );
 
 signals:
@@ -40,8 +40,11 @@
 
 #include "log.h"
 #include "ContentWindow.h"
+#include "Metrics.h"
+#include "Profiler.h"
 
 #include <fstream>
+#include <boost/bind.hpp>
 #include <boost/tokenizer.hpp>
 
 #include <QDir>
@@ -74,10 +77,13 @@ DynamicTexture::DynamicTexture(const QString& uri, DynamicTexturePtr parent,
     : uri_(uri)
     , useImagePyramid_(false)
     , threadCount_(0)
+    , missingTiles_(false)
+    , lastFrameIncomplete_(false)
     , parent_(parent)
     , imageCoordsInParentImage_(parentCoordinates)
     , depth_(0)
     , loadImageThreadStarted_(false)
+    , uploadRequested_(false)
     , renderedChildren_(false)
 {
     // if we're a child...
@@ -294,18 +300,38 @@ void DynamicTexture::loadImageAsync()
 
 bool DynamicTexture::loadFullResImage()
 {
-    if( !fullscaleImage_.load( uri_ ))
+    // The image may already be decoded for another window
+    fullscaleImage_ = _findShared<QImage>( uri_ );
+    if( !fullscaleImage_ )
     {
-        put_flog( LOG_ERROR, "error loading: '%s'",
-                  uri_.toLocal8Bit().constData( ));
-        return false;
+        boost::shared_ptr<QImage> image( new QImage );
+        if( !image->load( uri_ ))
+        {
+            put_flog( LOG_ERROR, "error loading: '%s'",
+                      uri_.toLocal8Bit().constData( ));
+            return false;
+        }
+        fullscaleImage_ = image;
+        _share( uri_, fullscaleImage_ );
     }
-    imageSize_ = fullscaleImage_.size();
+    if( imageSize_.isEmpty( ))
+        imageSize_ = fullscaleImage_->size();
     return true;
 }
 
+boost::shared_ptr<QImage> DynamicTexture::getFullResImage()
+{
+    // The loader threads of several children may need the image at once
+    QMutexLocker locker( &fullscaleImageMutex_ );
+    if( !fullscaleImage_ )
+        loadFullResImage();
+    return fullscaleImage_;
+}
+
 void DynamicTexture::loadImage()
 {
+    PROFILE_SCOPE( "decoder", "loadImage" );
+    ScopedDuration decodeTime( &Metrics::recordDecodeTime );
     if(isRoot())
     {
         if(useImagePyramid_)
@@ -314,8 +340,9 @@ void DynamicTexture::loadImage()
         }
         else
         {
-            if (!fullscaleImage_.isNull() || loadFullResImage())
-                scaledImage_ = fullscaleImage_.scaled(TEXTURE_SIZE, TEXTURE_SIZE, Qt::KeepAspectRatio);
+            const boost::shared_ptr<QImage> image = getFullResImage();
+            if (image)
+                scaledImage_ = image->scaled(TEXTURE_SIZE, TEXTURE_SIZE, Qt::KeepAspectRatio);
         }
     }
     else
@@ -358,71 +385,120 @@ void DynamicTexture::render()
 {
     assert( isRoot( ));
 
-    render( zoomRect_ );
+    renderRoot( zoomRect_ );
 }
 
 void DynamicTexture::renderPreview()
 {
-    render( UNIT_RECTF );
+    renderRoot( UNIT_RECTF );
 }
 
-void DynamicTexture::render( const QRectF& texCoords )
+void DynamicTexture::renderRoot( const QRectF& texCoords )
 {
-    if( !isVisibleInCurrentGLView( ))
+    assert( isRoot( ));
+
+    render( texCoords, UNIT_RECTF, getCurrentGLView(), quadBatch_ );
+    quadBatch_.render();
+}
+
+void DynamicTexture::render( const QRectF& texCoords, const QRectF& rect,
+                             const GLView& view, GLQuadBatch& batch )
+{
+    const QRectF pixelRect = view.unitToPixels.mapRect( rect );
+    if( !pixelRect.intersects( view.viewport ))
         return;
 
-    if( canHaveChildren() && !isResolutionSufficientForCurrentGLView( ))
+    const bool isResolutionSufficient = pixelRect.width() <= TEXTURE_SIZE &&
+                                        pixelRect.height() <= TEXTURE_SIZE;
+    if( canHaveChildren() && !isResolutionSufficient )
     {
-        renderChildren( texCoords );
+        renderChildren( texCoords, rect, view, batch );
         renderedChildren_ = true;
         return;
     }
 
     // Normal rendering: load the texture if not already available
-    if( !loadImageThreadStarted_ )
+    if( !loadImageThreadStarted_ && !findSharedTexture( ))
         loadImageAsync();
 
-    drawTexture( texCoords );
+    drawTexture( texCoords, rect, batch );
 }
 
 void DynamicTexture::preRenderUpdate( ContentWindowPtr window,
-                                      const QRect& wallArea )
+                                      const QRegion& wallArea )
 {
     assert( isRoot( ));
 
-    if( !QRectF( wallArea ).intersects( _qmlItem->getSceneRect( )))
+    if( !_isVisibleIn( wallArea ))
         return;
 
+    // Upload the tiles which were loaded during the last frame
+    for( const auto& weakTile : pendingUploads_ )
+    {
+        DynamicTexturePtr tile = weakTile.lock();
+        if( !tile )
+            continue;
+        tile->uploadRequested_ = false;
+        _scheduleUpload( *window, wallArea, tile->scaledImage_.byteCount(),
+                         boost::bind( &DynamicTexture::generateTexture, tile ));
+    }
+    pendingUploads_.clear();
+
     // Root needs to always have a texture for renderInParent()
-    if( !loadImageThreadStarted_ )
+    if( !loadImageThreadStarted_ && !findSharedTexture( ))
         loadImageAsync();
 
     zoomRect_ = window->getZoomRect();
 }
 
-void DynamicTexture::postRenderSync( WallToWallChannel& )
+bool DynamicTexture::isModified()
 {
-    clearOldChildren();
-    renderedChildren_ = false;
+    assert( isRoot( ));
+
+    return lastFrameIncomplete_;
 }
 
-QImage DynamicTexture::getRootImage() const
+size_t DynamicTexture::getMemoryUsage() const
 {
-    return QImage( imagePyramidPath_+ '/' + getPyramidImageFilename( ));
+    assert( isRoot( ));
+
+    size_t usage = getTextureMemoryDescending();
+    QMutexLocker locker( &fullscaleImageMutex_ );
+    if( fullscaleImage_ )
+        usage += fullscaleImage_->byteCount() / fullscaleImage_.use_count();
+    return usage;
+}
+
+void DynamicTexture::releaseMemory()
+{
+    assert( isRoot( ));
+
+    // Tiles can not be deleted while their image is loading
+    if( !getThreadsDoneDescending( ))
+        return;
+
+    children_.clear();
+    pendingUploads_.clear();
+
+    // The root tile is loaded again when the texture becomes visible
+    texture_.reset();
+    fullscaleImage_.reset();
+    uploadRequested_ = false;
+    loadImageThreadStarted_ = false;
 }
 
-bool DynamicTexture::isVisibleInCurrentGLView()
+void DynamicTexture::postRenderSync( WallToWallChannel& )
 {
-    // TODO This objects visibility should be determined by using the GLWindow
-    // as a pre-render step, not retro-fitted in here!
-    const QRectF screenRect = getProjectedPixelRect(true);
-    return screenRect.width()*screenRect.height() > 0.;
+    clearOldChildren();
+    renderedChildren_ = false;
+
+    lastFrameIncomplete_ = missingTiles_;
+    missingTiles_ = false;
 }
 
-bool DynamicTexture::isResolutionSufficientForCurrentGLView()
+QImage DynamicTexture::getRootImage() const
 {
-    const QRectF fullRect = getProjectedPixelRect(false);
-    return fullRect.width() <= TEXTURE_SIZE && fullRect.height() <= TEXTURE_SIZE;
+    return QImage( imagePyramidPath_+ '/' + getPyramidImageFilename( ));
 }
 
 bool DynamicTexture::canHaveChildren()
@@ -431,45 +507,53 @@ bool DynamicTexture::canHaveChildren()
             getRoot()->imageSize_.height() / (1 << depth_) > TEXTURE_SIZE);
 }
 
-void DynamicTexture::drawTexture(const QRectF& texCoords)
+void DynamicTexture::drawTexture(const QRectF& texCoords, const QRectF& rect,
+                                 GLQuadBatch& batch)
 {
-    if(!texture_.isValid() && loadImageThreadStarted_ && loadImageThread_.isFinished())
-        generateTexture();
+    if(!texture_ && loadImageThreadStarted_ && loadImageThread_.isFinished())
+        requestUpload();
 
-    if(texture_.isValid())
+    if(texture_)
     {
+        batch.add(rect, texCoords, texture_->getTextureId(),
+                  texture_->hasAlphaChannel());
 #ifdef DYNAMIC_TEXTURE_SHOW_BORDER
-        renderTextureBorder();
+        batch.render(); // draw the tile below its border
+        renderTextureBorder(rect);
 #endif
-        renderTexturedUnitQuad(texCoords);
     }
     else
     {
+        // Render again once the texture has been loaded
+        if(!loadImageThreadStarted_ || !loadImageThread_.isFinished() ||
+           uploadRequested_)
+            getRoot()->missingTiles_ = true;
+
         // If we don't yet have a texture, try to render from parent's texture
         DynamicTexturePtr parent = parent_.lock();
         if(parent)
-            parent->drawTexture(getImageRegionInParentImage(texCoords));
+            parent->drawTexture(getImageRegionInParentImage(texCoords), rect,
+                                batch);
     }
 }
 
-void DynamicTexture::renderTextureBorder()
+void DynamicTexture::renderTextureBorder( const QRectF& rect )
 {
-    glPushAttrib( GL_CURRENT_BIT );
+    glPushAttrib( GL_CURRENT_BIT | GL_ENABLE_BIT );
 
+    glDisable( GL_TEXTURE_2D );
     glColor4f( 0.f, 1.f, 0.f, 1.f );
 
-    quadBorder_.setRenderMode( GL_LINE_LOOP );
-    quadBorder_.render();
+    glBegin( GL_LINE_LOOP );
+    glVertex2f( rect.left(), rect.top( ));
+    glVertex2f( rect.right(), rect.top( ));
+    glVertex2f( rect.right(), rect.bottom( ));
+    glVertex2f( rect.left(), rect.bottom( ));
+    glEnd();
 
     glPopAttrib();
 }
 
-void DynamicTexture::renderTexturedUnitQuad( const QRectF& texCoords )
-{
-    quad_.setTexCoords( texCoords );
-    quad_.render();
-}
-
 void DynamicTexture::clearOldChildren()
 {
     if(!renderedChildren_ && !children_.empty() && getThreadsDoneDescending())
@@ -592,13 +676,20 @@ QImage DynamicTexture::getImageFromParent( const QRectF& imageRegion,
     if(loadImageThreadStarted_ && !loadImageThread_.isFinished())
         loadImageThread_.waitForFinished();
 
-    if(!fullscaleImage_.isNull())
+    // the root texture may have been shared by another window, in which case
+    // the full scale image was not loaded yet
+    boost::shared_ptr<QImage> fullscaleImage;
+    if(isRoot())
+        fullscaleImage = getFullResImage();
+
+    if(fullscaleImage)
     {
         // we have a valid image, return the clipped image
-        return fullscaleImage_.copy(imageRegion.x()*fullscaleImage_.width(),
-                                    imageRegion.y()*fullscaleImage_.height(),
-                                    imageRegion.width()*fullscaleImage_.width(),
-                                    imageRegion.height()*fullscaleImage_.height());
+        const QImage& image = *fullscaleImage;
+        return image.copy(imageRegion.x()*image.width(),
+                          imageRegion.y()*image.height(),
+                          imageRegion.width()*image.width(),
+                          imageRegion.height()*image.height());
     }
     else
     {
@@ -615,15 +706,43 @@ QImage DynamicTexture::getImageFromParent( const QRectF& imageRegion,
 
 void DynamicTexture::generateTexture()
 {
-    texture_.init( scaledImage_, GL_BGRA );
+    // Another window may have uploaded the same tile in the meantime
+    if( findSharedTexture( ))
+    {
+        scaledImage_ = QImage();
+        return;
+    }
 
-    quad_.setTexture( texture_.getTextureId( ));
-    quad_.enableAlphaBlending( scaledImage_.hasAlphaChannel( ));
+    texture_.reset( new GLTexture2D );
+    texture_->init( scaledImage_, GL_BGRA );
+    getRoot()->_share( getTileKey(), texture_ );
 
     scaledImage_ = QImage(); // no longer need the source image
 }
 
-void DynamicTexture::renderChildren(const QRectF& texCoords)
+bool DynamicTexture::findSharedTexture()
+{
+    if( !texture_ )
+        texture_ = getRoot()->_findShared<GLTexture2D>( getTileKey( ));
+    return bool( texture_ );
+}
+
+QString DynamicTexture::getTileKey()
+{
+    return getRoot()->uri_ + '#' + getPyramidImageFilename();
+}
+
+void DynamicTexture::requestUpload()
+{
+    if( uploadRequested_ )
+        return;
+
+    uploadRequested_ = true;
+    getRoot()->pendingUploads_.push_back( shared_from_this( ));
+}
+
+void DynamicTexture::renderChildren(const QRectF& texCoords, const QRectF& rect,
+                                    const GLView& view, GLQuadBatch& batch)
 {
     // children rectangles
     const float inf = 1000000.;
@@ -673,16 +792,26 @@ void DynamicTexture::renderChildren(const QRectF& texCoords)
                                 childTextureRect.width() / texCoords.width(),
                                 childTextureRect.height() / texCoords.height());
 
-        glPushMatrix();
-        glTranslatef(renderRect.x(), renderRect.y(), 0.);
-        glScalef(renderRect.width(), renderRect.height(), 1.);
-
-        children_[i]->render(childTextureRectTranslatedAndScaled);
+        // position of the child in the unit quad of the root
+        const QRectF childRect(rect.x() + renderRect.x() * rect.width(),
+                               rect.y() + renderRect.y() * rect.height(),
+                               renderRect.width() * rect.width(),
+                               renderRect.height() * rect.height());
 
-        glPopMatrix();
+        children_[i]->render(childTextureRectTranslatedAndScaled, childRect,
+                             view, batch);
     }
 }
 
+size_t DynamicTexture::getTextureMemoryDescending() const
+{
+    size_t memory = texture_ ? texture_->getMemorySize() / texture_.use_count()
+                             : 0;
+    for(unsigned int i=0; i<children_.size(); i++)
+        memory += children_[i]->getTextureMemoryDescending();
+    return memory;
+}
+
 bool DynamicTexture::getThreadsDoneDescending()
 {
     if(!loadImageThread_.isFinished())
@@ -723,18 +852,8 @@ void DynamicTexture::incrementGlobalThreadCount()
     }
 }
 
-QRectF DynamicTexture::getProjectedPixelRect( const bool clampToViewportBorders )
+DynamicTexture::GLView DynamicTexture::getCurrentGLView()
 {
-    // get four corners in object space (recall we're in normalized 0->1 coord)
-    const double corners[4][3] =
-    {
-        {0.,0.,0.},
-        {1.,0.,0.},
-        {1.,1.,0.},
-        {0.,1.,0.}
-    };
-
-    // get four corners in screen space
     GLdouble modelview[16];
     glGetDoublev( GL_MODELVIEW_MATRIX, modelview );
 
@@ -744,30 +863,31 @@ QRectF DynamicTexture::getProjectedPixelRect( const bool clampToViewportBorders
     GLint viewport[4];
     glGetIntegerv( GL_VIEWPORT, viewport );
 
-    GLdouble xWin[4][3];
+    const GLdouble viewportHeight = (GLdouble)viewport[3];
 
-    for(size_t i=0; i<4; i++)
+    // Project the origin and the two unit axes. The transformation is affine
+    // for the orthographic views used by the wall, so the projection of any
+    // sub-rectangle of the unit quad can then be computed without GL queries.
+    const double corners[3][2] = { {0.,0.}, {1.,0.}, {0.,1.} };
+    QPointF xWin[3];
+    for( size_t i = 0; i < 3; ++i )
     {
-        gluProject( corners[i][0], corners[i][1], corners[i][2],
-                    modelview, projection, viewport,
-                    &xWin[i][0], &xWin[i][1], &xWin[i][2] );
-
-        const GLdouble viewportWidth = (GLdouble)viewport[2];
-        const GLdouble viewportHeight = (GLdouble)viewport[3];
+        GLdouble x, y, z;
+        gluProject( corners[i][0], corners[i][1], 0.,
+                    modelview, projection, viewport, &x, &y, &z );
 
         // The GL coordinates system origin is at the bottom-left corner with
-        // the y-axis pointing upwards. For the QRect, we want the origin at
-        // the top of the viewport with the y-axis pointing downwards.
-        xWin[i][1] = viewportHeight - xWin[i][1];
-
-        if( clampToViewportBorders )
-        {
-            xWin[i][0] = std::min( std::max( xWin[i][0], 0. ), viewportWidth );
-            xWin[i][1] = std::min( std::max( xWin[i][1], 0. ), viewportHeight );
-        }
+        // the y-axis pointing upwards. We want the origin at the top of the
+        // viewport with the y-axis pointing downwards.
+        xWin[i] = QPointF( x, viewportHeight - y );
     }
 
-    const QPointF topleft( xWin[0][0], xWin[0][1] );
-    const QPointF bottomright( xWin[2][0], xWin[2][1] );
-    return QRectF( topleft, bottomright );
+    const QPointF xAxis = xWin[1] - xWin[0];
+    const QPointF yAxis = xWin[2] - xWin[0];
+
+    GLView view;
+    view.unitToPixels = QTransform( xAxis.x(), xAxis.y(), yAxis.x(), yAxis.y(),
+                                    xWin[0].x(), xWin[0].y( ));
+    view.viewport = QRectF( 0., 0., viewport[2], viewport[3] );
+    return view;
 }
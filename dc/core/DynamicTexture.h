@@ -42,10 +42,11 @@
 #include "WallContent.h"
 
 #include "GLTexture2D.h"
-#include "GLQuad.h"
+#include "GLQuadBatch.h"
 
 #include <QImage>
 #include <QFuture>
+#include <QTransform>
 
 #include <boost/shared_ptr.hpp>
 #include <boost/weak_ptr.hpp>
@@ -97,11 +98,20 @@ public:
 
     /** Pre render step. */
     void preRenderUpdate( ContentWindowPtr window,
-                          const QRect& wallArea ) override;
+                          const QRegion& wallArea ) override;
+
+    /** @return true if tiles were still missing in the last rendered frame. */
+    bool isModified() override;
 
     /** Post render step. */
     void postRenderSync( WallToWallChannel& wallToWallChannel ) override;
 
+    /** @return the memory used by the loaded tiles and the source image. */
+    size_t getMemoryUsage() const override;
+
+    /** Free all the tiles once they are done loading. */
+    void releaseMemory() override;
+
     /** Get the root image of the pyramid. */
     QImage getRootImage() const;
 
@@ -140,10 +150,19 @@ private:
     int threadCount_;
     QMutex threadCountMutex_;
 
-    QImage fullscaleImage_;
+    boost::shared_ptr<QImage> fullscaleImage_; // Shared with other windows
+    mutable QMutex fullscaleImageMutex_; // Loaded lazily by the children
 
     QRectF zoomRect_;
 
+    bool missingTiles_; // Some tiles are not loaded yet in the current frame
+    bool lastFrameIncomplete_;
+
+    GLQuadBatch quadBatch_; // The tiles to draw in the current frame
+
+    // The tiles loaded during the last frame, to upload in the next one
+    std::vector<boost::weak_ptr<DynamicTexture> > pendingUploads_;
+
     /* for children only: */
 
     boost::weak_ptr<DynamicTexture> parent_;
@@ -159,33 +178,50 @@ private:
 
     QSize imageSize_; // full scale image dimensions
     QImage scaledImage_; // for texture upload to GPU
-    GLTexture2D texture_;
-    GLQuad quad_;
-    GLQuad quadBorder_;
+    boost::shared_ptr<GLTexture2D> texture_; // Shared with other windows
+    bool uploadRequested_;
 
     std::vector<DynamicTexturePtr> children_; // Children in the image pyramid
     bool renderedChildren_; // Used for garbage-collecting unused child objects
 
-    bool isVisibleInCurrentGLView();
-    bool isResolutionSufficientForCurrentGLView();
+    /** The GL view in which the tiles are rendered, queried once per frame. */
+    struct GLView
+    {
+        QTransform unitToPixels; // From the unit quad of the root to pixels
+        QRectF viewport; // The viewport in pixels
+    };
+
     bool canHaveChildren();
 
     /** Recursively clear children which have not been rendered recently. */
     void clearOldChildren(); // @All
 
     /**
-     * Render the dynamic texture.
+     * Render the visible tiles of the texture and draw them in a single batch.
+     * @param texCoords The area of the full scale texture to render
+     */
+    void renderRoot( const QRectF& texCoords ); // @Root
+
+    /**
+     * Add the visible tiles of the dynamic texture to a batch.
      * @param texCoords The area of the full scale texture to render
+     * @param rect The position of this object in the unit quad of the root
+     * @param view The current GL view
+     * @param batch The batch of tiles to render
      */
-    void render( const QRectF& texCoords );
+    void render( const QRectF& texCoords, const QRectF& rect,
+                 const GLView& view, GLQuadBatch& batch ); // @All
 
     /**
-     * Render the dynamic texture.
+     * Add the texture of this object to a batch.
      * This function is also called from child objects to render a low-res
      * texture when the high-res one is not loaded yet.
      * @param texCoords The area of the full scale texture to render
+     * @param rect The position of the tile in the unit quad of the root
+     * @param batch The batch of tiles to render
      */
-    void drawTexture( const QRectF& texCoords ); // @All
+    void drawTexture( const QRectF& texCoords, const QRectF& rect,
+                      GLQuadBatch& batch ); // @All
 
     /** Is this object the root element. */
     bool isRoot() const;  // @All
@@ -215,15 +251,20 @@ private:
 
     void loadImageAsync(); // @All
     bool loadFullResImage(); // @Root only
+    boost::shared_ptr<QImage> getFullResImage(); // @Root only
     QImage getImageFromParent( const QRectF& imageRegion,
                                DynamicTexture* start ); // @Child only
     void generateTexture(); // @All
+    bool findSharedTexture(); // @All
+    QString getTileKey(); // @All
+    void requestUpload(); // @All
 
-    void renderChildren( const QRectF& texCoords ); // @All
-    void renderTextureBorder(); // @All
-    void renderTexturedUnitQuad( const QRectF& texCoords ); // @All
+    void renderChildren( const QRectF& texCoords, const QRectF& rect,
+                         const GLView& view, GLQuadBatch& batch ); // @All
+    void renderTextureBorder( const QRectF& rect ); // @All
 
     bool getThreadsDoneDescending(); // @Root
+    size_t getTextureMemoryDescending() const; // @All
 
 
     int getGlobalThreadCount(); // @Root
@@ -232,16 +273,12 @@ private:
     // @TODO-Remove
     QRect getRootImageCoordinates( float x, float y, float w, float h );
 
-    // @TODO-Remove
     /**
-     * Get the region spanned by a unit rectangle {(0;0),(1;1)} in the current
-     * GL view.
-     * The region is in screen coordinates with the origin at the viewport's
+     * Get the projection of the unit rectangle {(0;0),(1;1)} in the current
+     * GL view, in screen coordinates with the origin at the viewport's
      * top-left corner.
-     * @param clampToViewportBorders Clamp to the visible part of the region.
-     * @return The region in pixel units.
      */
-    static QRectF getProjectedPixelRect( const bool clampToViewportBorders );
+    static GLView getCurrentGLView();
 };
 
 #endif
@@ -41,6 +41,8 @@
 
 #include "FFMPEGFrame.h"
 #include "FFMPEGVideoStream.h"
+#include "Metrics.h"
+#include "Profiler.h"
 #include "log.h"
 
 #define MIN_SEEK_DELTA_SEC  0.5
@@ -223,12 +225,14 @@ std::future<PicturePtr> FFMPEGMovie::getFrame( const double posInSeconds )
 
 void FFMPEGMovie::_decode()
 {
+    Profiler::setThreadName( "movie decoder" );
     while( !_stopDecoding )
         _decodeOneFrame();
 }
 
 void FFMPEGMovie::_decodeOneFrame()
 {
+    PROFILE_SCOPE( "decoder", "decodeMovieFrame" );
     {
         std::unique_lock<std::mutex> lock( _seekMutex );
         if( _seek )
@@ -319,7 +323,11 @@ bool FFMPEGMovie::_readVideoFrame()
     // keep reading frames until we decode a valid video frame
     while( (avReadStatus = av_read_frame( _avFormatContext, &packet )) >= 0 )
     {
-        auto picture = _videoStream->decode( packet );
+        PicturePtr picture;
+        {
+            ScopedDuration decodeTime( &Metrics::recordDecodeTime );
+            picture = _videoStream->decode( packet );
+        }
         if( picture )
         {
             _queue.enqueue( picture );
@@ -383,6 +391,7 @@ bool FFMPEGMovie::_seekFileTo( const double timePosInSeconds )
 
 PicturePtr FFMPEGMovie::_grabSingleFrame( const double posInSeconds )
 {
+    PROFILE_SCOPE( "decoder", "grabMovieFrame" );
     _seekFileTo( posInSeconds );
     if( _queue.empty( ))
         throw std::runtime_error( "Frame unavailable error" );
@@ -58,7 +58,7 @@ void FpsCounter::tick()
 
 float FpsCounter::getFps() const
 {
-    if(history_.empty())
+    if(history_.size() < 2)
         return 0.f;
 
     const float delta = (float)(history_.back() - history_.front()).total_milliseconds() / 1000.f;
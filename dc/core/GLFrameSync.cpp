@@ -0,0 +1,174 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+#include "GLFrameSync.h"
+
+#include "log.h"
+
+#include <QOpenGLContext>
+#include <QtGui/qopengl.h>
+
+#include <algorithm>
+
+namespace
+{
+// Timeout of each wait, repeated until the fence is signaled
+const GLuint64 WAIT_TIMEOUT_NS = 1000000000;
+
+struct SyncFunctions
+{
+    SyncFunctions()
+        : fenceSync( 0 )
+        , clientWaitSync( 0 )
+        , deleteSync( 0 )
+    {}
+
+    PFNGLFENCESYNCPROC fenceSync;
+    PFNGLCLIENTWAITSYNCPROC clientWaitSync;
+    PFNGLDELETESYNCPROC deleteSync;
+};
+
+// Resolved once, all the contexts of a process share the same driver
+const SyncFunctions& getSyncFunctions()
+{
+    static bool resolved = false;
+    static SyncFunctions functions;
+    if( resolved )
+        return functions;
+
+    QOpenGLContext* context = QOpenGLContext::currentContext();
+    if( !context )
+        return functions;
+    resolved = true;
+
+    const bool supported = context->format().version() >= qMakePair( 3, 2 ) ||
+                           context->hasExtension( "GL_ARB_sync" );
+    if( !supported )
+    {
+        put_flog( LOG_WARN, "GL sync objects not available, using glFinish" );
+        return functions;
+    }
+
+    functions.fenceSync = (PFNGLFENCESYNCPROC)
+            context->getProcAddress( "glFenceSync" );
+    functions.clientWaitSync = (PFNGLCLIENTWAITSYNCPROC)
+            context->getProcAddress( "glClientWaitSync" );
+    functions.deleteSync = (PFNGLDELETESYNCPROC)
+            context->getProcAddress( "glDeleteSync" );
+
+    if( !functions.fenceSync || !functions.clientWaitSync ||
+        !functions.deleteSync )
+    {
+        put_flog( LOG_WARN, "GL sync functions not found, using glFinish" );
+        functions = SyncFunctions();
+    }
+    return functions;
+}
+}
+
+const unsigned int GLFrameSync::DEFAULT_FRAMES_IN_FLIGHT = 1;
+
+GLFrameSync::GLFrameSync( const unsigned int maxFramesInFlight )
+    : maxFramesInFlight_( std::max( maxFramesInFlight, 1u ))
+{
+}
+
+GLFrameSync::~GLFrameSync()
+{
+    const SyncFunctions& gl = getSyncFunctions();
+    if( !gl.deleteSync || !QOpenGLContext::currentContext( ))
+        return;
+
+    pendingFrames_.push_back( currentFrame_ );
+    for( const Fences& fences : pendingFrames_ )
+    {
+        for( void* fence : fences )
+            gl.deleteSync( static_cast<GLsync>( fence ));
+    }
+}
+
+void GLFrameSync::insertFence()
+{
+    const SyncFunctions& gl = getSyncFunctions();
+    if( !gl.fenceSync )
+        return;
+
+    // Flush so that the GPU starts working on the frame without waiting for
+    // a later command, since this context may not be used again this frame.
+    currentFrame_.push_back( gl.fenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 ));
+    glFlush();
+}
+
+void GLFrameSync::endFrame()
+{
+    if( currentFrame_.empty( ))
+    {
+        glFinish();
+        return;
+    }
+
+    pendingFrames_.push_back( currentFrame_ );
+    currentFrame_.clear();
+
+    while( pendingFrames_.size() >= maxFramesInFlight_ )
+    {
+        waitForFrame( pendingFrames_.front( ));
+        pendingFrames_.pop_front();
+    }
+}
+
+unsigned int GLFrameSync::getMaxFramesInFlight() const
+{
+    return maxFramesInFlight_;
+}
+
+void GLFrameSync::waitForFrame( const Fences& fences )
+{
+    const SyncFunctions& gl = getSyncFunctions();
+    for( void* fence : fences )
+    {
+        GLsync sync = static_cast<GLsync>( fence );
+        GLenum result = GL_TIMEOUT_EXPIRED;
+        while( result == GL_TIMEOUT_EXPIRED )
+            result = gl.clientWaitSync( sync, 0, WAIT_TIMEOUT_NS );
+        if( result == GL_WAIT_FAILED )
+            put_flog( LOG_WARN, "waiting for a GL fence failed" );
+        gl.deleteSync( sync );
+    }
+}
@@ -0,0 +1,109 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+#ifndef GLFRAMESYNC_H
+#define GLFRAMESYNC_H
+
+#include <boost/noncopyable.hpp>
+
+#include <deque>
+#include <vector>
+
+/**
+ * Bound the number of frames which the GPU may still be rendering, using GL
+ * fences instead of blocking on glFinish.
+ *
+ * With one frame in flight (the default), endFrame() returns once the GPU has
+ * completed the frame in all the contexts, like glFinish. Calling it just
+ * before the barrier which precedes the swap keeps the swap lock of the
+ * cluster, while the CPU work done between insertFence() and endFrame()
+ * overlaps with the rendering.
+ *
+ * With more frames in flight, a whole frame of CPU work overlaps with the
+ * rendering. This relaxes the swap lock: a process with a slower GPU may
+ * display its frame one or more vblanks after the others.
+ *
+ * Falls back to glFinish if the driver does not support sync objects.
+ *
+ * All methods of this class must be called from the OpenGL thread.
+ */
+class GLFrameSync : public boost::noncopyable
+{
+public:
+    /** The default maximum number of frames in flight. */
+    static const unsigned int DEFAULT_FRAMES_IN_FLIGHT;
+
+    /**
+     * Constructor.
+     * @param maxFramesInFlight The maximum number of frames which the GPU
+     *        may still be rendering after endFrame() returns, plus one.
+     */
+    explicit GLFrameSync( unsigned int maxFramesInFlight =
+                              DEFAULT_FRAMES_IN_FLIGHT );
+
+    /** Delete the pending fences, if a GL context is still current. */
+    ~GLFrameSync();
+
+    /**
+     * Insert a fence after the commands submitted so far in the current GL
+     * context, and flush them. Call once for each context used in a frame.
+     */
+    void insertFence();
+
+    /**
+     * End the current frame, waiting until at most maxFramesInFlight - 1
+     * frames, including the current one, remain to be completed by the GPU.
+     */
+    void endFrame();
+
+    /** Get the maximum number of frames in flight. */
+    unsigned int getMaxFramesInFlight() const;
+
+private:
+    // GLsync handles, kept opaque so that this header does not require GL
+    typedef std::vector< void* > Fences;
+
+    const unsigned int maxFramesInFlight_;
+    Fences currentFrame_;
+    std::deque< Fences > pendingFrames_;
+
+    void waitForFrame( const Fences& fences );
+};
+
+#endif // GLFRAMESYNC_H
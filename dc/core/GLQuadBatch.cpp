@@ -0,0 +1,175 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+#include "GLQuadBatch.h"
+
+#include <algorithm>
+
+namespace
+{
+const size_t VERTICES_PER_QUAD = 4;
+const size_t FLOATS_PER_QUAD = 2 * VERTICES_PER_QUAD;
+
+void appendCorners( std::vector<GLfloat>& array, const QRectF& rect )
+{
+    // Same winding as GLQuad: top-left, top-right, bottom-right, bottom-left
+    const GLfloat corners[FLOATS_PER_QUAD] =
+    {
+        GLfloat( rect.left( )),  GLfloat( rect.top( )),
+        GLfloat( rect.right( )), GLfloat( rect.top( )),
+        GLfloat( rect.right( )), GLfloat( rect.bottom( )),
+        GLfloat( rect.left( )),  GLfloat( rect.bottom( ))
+    };
+    array.insert( array.end(), corners, corners + FLOATS_PER_QUAD );
+}
+}
+
+GLQuadBatch::GLQuadBatch()
+{
+}
+
+void GLQuadBatch::add( const QRectF& rect, const QRectF& texCoords,
+                       const GLuint textureId, const bool alphaBlending )
+{
+    const Quad quad = { rect, texCoords, textureId, alphaBlending };
+    quads_.push_back( quad );
+}
+
+size_t GLQuadBatch::getQuadCount() const
+{
+    return quads_.size();
+}
+
+void GLQuadBatch::clear()
+{
+    quads_.clear();
+}
+
+size_t GLQuadBatch::render()
+{
+    if( quads_.empty( ))
+        return 0;
+
+    sortQuads();
+    fillArrays();
+
+    glPushAttrib( GL_ENABLE_BIT | GL_TEXTURE_BIT | GL_COLOR_BUFFER_BIT );
+    glPushClientAttrib( GL_CLIENT_VERTEX_ARRAY_BIT );
+
+    glEnableClientState( GL_VERTEX_ARRAY );
+    glEnableClientState( GL_TEXTURE_COORD_ARRAY );
+    glVertexPointer( 2, GL_FLOAT, 0, vertices_.data( ));
+    glTexCoordPointer( 2, GL_FLOAT, 0, texCoords_.data( ));
+
+    // Opaque quads come first and keep the blending state of the caller,
+    // like GLQuad does.
+    bool blendingEnabled = false;
+    size_t drawCalls = 0;
+    size_t first = 0;
+    while( first < order_.size( ))
+    {
+        const Quad& quad = quads_[order_[first]];
+
+        size_t last = first + 1;
+        while( last < order_.size() &&
+               quads_[order_[last]].textureId == quad.textureId &&
+               quads_[order_[last]].alphaBlending == quad.alphaBlending )
+        {
+            ++last;
+        }
+
+        if( quad.alphaBlending && !blendingEnabled )
+        {
+            glEnable( GL_BLEND );
+            glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
+            blendingEnabled = true;
+        }
+
+        if( quad.textureId )
+        {
+            glEnable( GL_TEXTURE_2D );
+            glBindTexture( GL_TEXTURE_2D, quad.textureId );
+        }
+        else
+            glDisable( GL_TEXTURE_2D );
+
+        glDrawArrays( GL_QUADS, GLint( first * VERTICES_PER_QUAD ),
+                      GLsizei(( last - first ) * VERTICES_PER_QUAD ));
+        ++drawCalls;
+        first = last;
+    }
+
+    glPopClientAttrib();
+    glPopAttrib();
+
+    quads_.clear();
+    return drawCalls;
+}
+
+void GLQuadBatch::sortQuads()
+{
+    order_.resize( quads_.size( ));
+    for( size_t i = 0; i < order_.size(); ++i )
+        order_[i] = i;
+
+    // Only valid for quads which do not overlap, see the class documentation
+    const std::vector<Quad>& quads = quads_;
+    std::stable_sort( order_.begin(), order_.end(),
+                      [&quads]( const size_t a, const size_t b )
+    {
+        if( quads[a].alphaBlending != quads[b].alphaBlending )
+            return !quads[a].alphaBlending;
+        return quads[a].textureId < quads[b].textureId;
+    });
+}
+
+void GLQuadBatch::fillArrays()
+{
+    vertices_.clear();
+    texCoords_.clear();
+    vertices_.reserve( quads_.size() * FLOATS_PER_QUAD );
+    texCoords_.reserve( quads_.size() * FLOATS_PER_QUAD );
+
+    for( size_t i = 0; i < order_.size(); ++i )
+    {
+        const Quad& quad = quads_[order_[i]];
+        appendCorners( vertices_, quad.rect );
+        appendCorners( texCoords_, quad.texCoords );
+    }
+}
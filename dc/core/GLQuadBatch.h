@@ -0,0 +1,110 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+#ifndef GLQUADBATCH_H
+#define GLQUADBATCH_H
+
+#include <QtCore/QRectF>
+#include <QtOpenGL/qgl.h>
+
+#include <vector>
+
+/**
+ * Draw many textured quads with a few OpenGL calls.
+ *
+ * The quads added during a frame are collected in a vertex array, sorted by
+ * blending state and texture, and drawn with one glDrawArrays() call for each
+ * texture. The quads which share the same state are drawn in the order in
+ * which they were added.
+ *
+ * Sorting by texture changes the drawing order. This is only valid because
+ * the quads of a batch which have different textures never overlap: the tiles
+ * of a DynamicTexture and the segments of a PixelStream partition their
+ * content. Overlapping markers share one texture, so they keep their order,
+ * and blended quads are always drawn over the opaque ones.
+ */
+class GLQuadBatch
+{
+public:
+    /** Construct an empty batch. */
+    GLQuadBatch();
+
+    /**
+     * Add a quad to the batch.
+     * @param rect The position of the quad, in the current GL coordinates
+     * @param texCoords The texture coordinates
+     * @param textureId The texture to use for rendering (0 = no texturing)
+     * @param alphaBlending Enable alpha blending for this quad
+     */
+    void add( const QRectF& rect, const QRectF& texCoords, GLuint textureId,
+              bool alphaBlending = false );
+
+    /** @return the number of quads waiting to be rendered. */
+    size_t getQuadCount() const;
+
+    /**
+     * Draw all the quads with the current GL matrices and clear the batch.
+     * @return the number of draw calls issued
+     */
+    size_t render();
+
+    /** Remove all the quads without drawing them. */
+    void clear();
+
+private:
+    struct Quad
+    {
+        QRectF rect;
+        QRectF texCoords;
+        GLuint textureId;
+        bool alphaBlending;
+    };
+
+    std::vector<Quad> quads_;
+
+    // Reused across frames to avoid reallocations
+    std::vector<size_t> order_;
+    std::vector<GLfloat> vertices_;
+    std::vector<GLfloat> texCoords_;
+
+    void sortQuads();
+    void fillArrays();
+};
+
+#endif // GLQUADBATCH_H
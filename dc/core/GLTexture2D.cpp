@@ -39,10 +39,22 @@
 
 #include "GLTexture2D.h"
 
+#include "Metrics.h"
+
 #include <QImage>
 
+#include <atomic>
+
+namespace
+{
+const uint64_t BYTES_PER_PIXEL = 4; // GL_RGBA internal format
+std::atomic<uint64_t> allocatedMemory(0);
+}
+
 GLTexture2D::GLTexture2D()
     : textureId_(0)
+    , memory_(0)
+    , alphaChannel_(false)
 {
 }
 
@@ -56,6 +68,8 @@ bool GLTexture2D::init(const QImage image, const GLenum format, bool mipmaps)
     if(textureId_)
         return false;
 
+    ScopedDuration uploadTime(&Metrics::recordUploadTime);
+
     glGenTextures(1, &textureId_);
     glBindTexture(GL_TEXTURE_2D, textureId_);
 
@@ -77,6 +91,12 @@ bool GLTexture2D::init(const QImage image, const GLenum format, bool mipmaps)
                  0, format, GL_UNSIGNED_BYTE, image.bits());
 
     size_ = image.size();
+    alphaChannel_ = image.hasAlphaChannel();
+
+    memory_ = BYTES_PER_PIXEL * image.width() * image.height();
+    if (mipmaps)
+        memory_ = memory_ * 4 / 3;
+    allocatedMemory += memory_;
 
     return true;
 }
@@ -88,6 +108,8 @@ void GLTexture2D::free()
         glDeleteTextures(1, &textureId_);
         textureId_ = 0;
         size_ = QSize();
+        allocatedMemory -= memory_;
+        memory_ = 0;
     }
 }
 
@@ -96,6 +118,16 @@ GLuint GLTexture2D::getTextureId() const
     return textureId_;
 }
 
+bool GLTexture2D::hasAlphaChannel() const
+{
+    return alphaChannel_;
+}
+
+uint64_t GLTexture2D::getMemorySize() const
+{
+    return memory_;
+}
+
 void GLTexture2D::update(const QImage image, const GLenum format)
 {
     if (size_ != image.size())
@@ -105,6 +137,7 @@ void GLTexture2D::update(const QImage image, const GLenum format)
     }
     else
     {
+        ScopedDuration uploadTime(&Metrics::recordUploadTime);
         glBindTexture(GL_TEXTURE_2D, textureId_);
         glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, image.width(), image.height(),
                         format, GL_UNSIGNED_BYTE, image.bits());
@@ -113,6 +146,7 @@ void GLTexture2D::update(const QImage image, const GLenum format)
 
 void GLTexture2D::update(const void* data, const GLenum format)
 {
+    ScopedDuration uploadTime(&Metrics::recordUploadTime);
     glBindTexture(GL_TEXTURE_2D, textureId_);
     glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, size_.width(), size_.height(),
                     format, GL_UNSIGNED_BYTE, data);
@@ -132,3 +166,8 @@ bool GLTexture2D::isValid() const
 {
     return textureId_ != 0;
 }
+
+uint64_t GLTexture2D::getAllocatedMemory()
+{
+    return allocatedMemory;
+}
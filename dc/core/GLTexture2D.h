@@ -69,6 +69,9 @@ public:
      */
     void update(const void* data, const GLenum format = GL_RGBA);
 
+    /** Check if the image used to init the texture has an alpha channel. */
+    bool hasAlphaChannel() const;
+
     /** Get the texture size. */
     const QSize& getSize() const;
 
@@ -84,9 +87,17 @@ public:
     /** Get the GL texture id. */
     GLuint getTextureId() const;
 
+    /** Get the GPU memory allocated for this texture, in bytes. */
+    uint64_t getMemorySize() const;
+
+    /** Get the GPU memory allocated by all the textures, in bytes. */
+    static uint64_t getAllocatedMemory();
+
 private:
     GLuint textureId_;
     QSize size_;
+    uint64_t memory_;
+    bool alphaChannel_;
 };
 
 #endif // GLTEXTURE2D_H
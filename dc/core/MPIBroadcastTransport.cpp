@@ -0,0 +1,115 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+#include "MPIBroadcastTransport.h"
+
+#define RANK0 0
+
+MPIBroadcastSender::MPIBroadcastSender( MPIChannelPtr mpiChannel )
+    : _mpiChannel( mpiChannel )
+{}
+
+void MPIBroadcastSender::send( const MPIHeader& header, std::string& data )
+{
+    // Wait for the previous message before reusing its buffers
+    _mpiChannel->wait( _requests );
+
+    _header = header;
+    _data.swap( data );
+
+    _mpiChannel->broadcastAsync( _header, _data, _requests );
+}
+
+void MPIBroadcastSender::flush()
+{
+    _mpiChannel->wait( _requests );
+}
+
+MPIBroadcastReceiver::MPIBroadcastReceiver( MPIChannelPtr mpiChannel )
+    : _mpiChannel( mpiChannel )
+    , _currentBuffer( 0 )
+    , _payload( 0 )
+    , _started( false )
+    , _receivingNext( false )
+{}
+
+const char* MPIBroadcastReceiver::receive( MPIHeader& header )
+{
+    if( !_started )
+    {
+        _mpiChannel->receiveHeaderAsync( _nextHeader, RANK0,
+                                         _nextHeaderRequests );
+        _receiveNextMessage();
+        _started = true;
+    }
+    else if( !_receivingNext )
+        _receiveNextMessage();
+
+    _mpiChannel->wait( _payloadRequests );
+
+    header = _header;
+    const char* payload = _payload;
+
+    // Start receiving the next message before this one is processed, if its
+    // header has already arrived.
+    _receivingNext = header.type != MPI_MESSAGE_TYPE_QUIT &&
+                     _mpiChannel->test( _nextHeaderRequests );
+    if( _receivingNext )
+        _receiveNextMessage();
+
+    return payload;
+}
+
+void MPIBroadcastReceiver::_receiveNextMessage()
+{
+    _mpiChannel->wait( _nextHeaderRequests );
+    _header = _nextHeader;
+    _currentBuffer = 1 - _currentBuffer;
+
+    SerializeBuffer& buffer = _buffers[_currentBuffer];
+    buffer.setSize( _header.size );
+    _payload = _mpiChannel->receiveBroadcastAsync( buffer.data(), _header.size,
+                                                   RANK0, _payloadRequests );
+
+    // Collective operations must be started in the same order as on the
+    // master, so the next header can only be requested after this payload.
+    if( _header.type != MPI_MESSAGE_TYPE_QUIT )
+        _mpiChannel->receiveHeaderAsync( _nextHeader, RANK0,
+                                         _nextHeaderRequests );
+}
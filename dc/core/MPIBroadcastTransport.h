@@ -0,0 +1,103 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+#ifndef MPIBROADCASTTRANSPORT_H
+#define MPIBROADCASTTRANSPORT_H
+
+#include "BroadcastTransport.h"
+#include "MPIChannel.h"
+#include "SerializeBuffer.h"
+
+/**
+ * Send messages with non-blocking MPI broadcasts.
+ *
+ * Each message is transferred while the next one is being prepared, the
+ * previous message is only waited for when a new one is sent.
+ */
+class MPIBroadcastSender : public BroadcastSender
+{
+public:
+    /** Constructor */
+    MPIBroadcastSender( MPIChannelPtr mpiChannel );
+
+    void send( const MPIHeader& header, std::string& data ) override;
+    void flush() override;
+
+private:
+    MPIChannelPtr _mpiChannel;
+
+    // The message being transferred, which must stay valid until then
+    MPIHeader _header;
+    std::string _data;
+    MPIRequests _requests;
+};
+
+/**
+ * Receive messages with non-blocking MPI broadcasts.
+ *
+ * Messages are received in two rotating buffers, so that the next message is
+ * already being transferred while the current one is processed. Payloads
+ * shared by the processes of a host are read directly from the shared memory
+ * of the MPIChannel, which also keeps two of them.
+ */
+class MPIBroadcastReceiver : public BroadcastReceiver
+{
+public:
+    /** Constructor */
+    MPIBroadcastReceiver( MPIChannelPtr mpiChannel );
+
+    const char* receive( MPIHeader& header ) override;
+
+private:
+    MPIChannelPtr _mpiChannel;
+
+    SerializeBuffer _buffers[2];
+    int _currentBuffer;
+    const char* _payload;
+    MPIHeader _header;
+    MPIRequests _payloadRequests;
+    MPIHeader _nextHeader;
+    MPIRequests _nextHeaderRequests;
+    bool _started;
+    bool _receivingNext;
+
+    void _receiveNextMessage();
+};
+
+#endif // MPIBROADCASTTRANSPORT_H
@@ -43,12 +43,34 @@
 
 #include "log.h"
 
+#include <cassert>
+#include <cstring>
+
 #define MPI_CHECK( func ) {                                   \
     const int err = ( func );                                 \
     if( err != MPI_SUCCESS )                                \
         put_flog( LOG_ERROR, "Error detected! (%d)", err );   \
     }
 
+namespace
+{
+// MPI implementations already segment large broadcasts along their
+// broadcast tree, so each payload is a single collective operation.
+void postBroadcast(char* data, const size_t size, const int root,
+                   MPI_Comm comm, MPIRequests& requests)
+{
+    MPI_Request request;
+    MPI_CHECK(MPI_Ibcast((void *)data, size, MPI_BYTE, root, comm, &request));
+    requests.requests.push_back(request);
+}
+
+// The processes of a host share two slots, so that the next payload can be
+// received while the current one is decoded. Larger payloads use the flat
+// broadcast, which all the processes agree on from the size in the header.
+const size_t SHARED_SLOT_SIZE = 32 << 20;
+const unsigned int SHARED_SLOT_COUNT = 2;
+}
+
 MPIChannel::MPIChannel(int argc, char * argv[])
     : mpiContext_(new MPIContext(argc, argv))
     , mpiComm_(MPI_COMM_WORLD)
@@ -57,6 +79,7 @@ MPIChannel::MPIChannel(int argc, char * argv[])
 {
     MPI_Comm_rank(MPI_COMM_WORLD, &mpiRank_);
     MPI_Comm_size(MPI_COMM_WORLD, &mpiSize_);
+    initTopology();
 }
 
 MPIChannel::MPIChannel(const MPIChannel& parent, const int color, const int key)
@@ -68,14 +91,145 @@ MPIChannel::MPIChannel(const MPIChannel& parent, const int color, const int key)
     MPI_Comm_split(parent.mpiComm_, color, key, &mpiComm_);
     MPI_Comm_rank(mpiComm_, &mpiRank_);
     MPI_Comm_size(mpiComm_, &mpiSize_);
+    initTopology();
 }
 
 MPIChannel::~MPIChannel()
 {
+    freeSharedBuffer();
+    if (leadersComm_ != MPI_COMM_NULL)
+        MPI_Comm_free(&leadersComm_);
+    MPI_Comm_free(&nodeComm_);
     if (mpiComm_ != MPI_COMM_WORLD)
         MPI_Comm_free(&mpiComm_);
 }
 
+void MPIChannel::initTopology()
+{
+    sharedWindow_ = MPI_WIN_NULL;
+    sharedBuffer_ = 0;
+    nextSharedSlot_ = 0;
+
+    // Ordering by rank makes the lowest rank of each host its node leader, so
+    // that the master process (rank 0) always leads its node.
+    MPI_CHECK(MPI_Comm_split_type(mpiComm_, MPI_COMM_TYPE_SHARED, mpiRank_,
+                                  MPI_INFO_NULL, &nodeComm_));
+    MPI_Comm_rank(nodeComm_, &nodeRank_);
+    MPI_Comm_size(nodeComm_, &nodeSize_);
+
+    MPI_CHECK(MPI_Comm_split(mpiComm_, nodeRank_ == 0 ? 0 : MPI_UNDEFINED,
+                             mpiRank_, &leadersComm_));
+    int leaderRank = -1;
+    if (leadersComm_ != MPI_COMM_NULL)
+        MPI_Comm_rank(leadersComm_, &leaderRank);
+    leaderRanks_.resize(mpiSize_);
+    MPI_CHECK(MPI_Allgather(&leaderRank, 1, MPI_INT, leaderRanks_.data(), 1,
+                            MPI_INT, mpiComm_));
+
+    int maxNodeSize = 0;
+    MPI_CHECK(MPI_Allreduce(&nodeSize_, &maxNodeSize, 1, MPI_INT, MPI_MAX,
+                            mpiComm_));
+    topologyAware_ = maxNodeSize > 1;
+
+    if (topologyAware_ && mpiRank_ == 0)
+        put_flog(LOG_DEBUG, "topology-aware broadcasts, up to %d processes "
+                 "per host", maxNodeSize);
+
+    if (topologyAware_ && nodeSize_ > 1)
+        allocateSharedBuffer();
+}
+
+void MPIChannel::allocateSharedBuffer()
+{
+    // Only the node leader allocates memory, the others map its segment
+    const size_t size = SHARED_SLOT_COUNT * SHARED_SLOT_SIZE;
+    void* baseptr = 0;
+    MPI_CHECK(MPI_Win_allocate_shared(nodeRank_ == 0 ? size : 0, 1,
+                                      MPI_INFO_NULL, nodeComm_, &baseptr,
+                                      &sharedWindow_));
+    MPI_Aint segmentSize = 0;
+    int dispUnit = 0;
+    MPI_CHECK(MPI_Win_shared_query(sharedWindow_, 0, &segmentSize, &dispUnit,
+                                   &baseptr));
+    MPI_CHECK(MPI_Win_lock_all(MPI_MODE_NOCHECK, sharedWindow_));
+
+    sharedBuffer_ = static_cast<char*>(baseptr);
+}
+
+void MPIChannel::freeSharedBuffer()
+{
+    if (sharedWindow_ == MPI_WIN_NULL)
+        return;
+
+    MPI_Win_unlock_all(sharedWindow_);
+    MPI_Win_free(&sharedWindow_);
+    sharedBuffer_ = 0;
+}
+
+bool MPIChannel::isTwoLevelBroadcast(const int src, const size_t size) const
+{
+    return topologyAware_ && size > 0 && size <= SHARED_SLOT_SIZE &&
+           leaderRanks_[src] >= 0;
+}
+
+char* MPIChannel::twoLevelBroadcast(char* data, const size_t size,
+                                    const int src, MPIRequests& requests)
+{
+    // Between hosts, the data is sent only once to each node leader
+    if (src == mpiRank_ || nodeSize_ == 1)
+        postBroadcast(data, size, leaderRanks_[src], leadersComm_, requests);
+
+    if (nodeSize_ == 1)
+        return data;
+
+    const unsigned int slotIndex = nextSharedSlot_++ % SHARED_SLOT_COUNT;
+    char* slot = sharedBuffer_ + slotIndex * SHARED_SLOT_SIZE;
+
+    // The slot is free once all the processes of the host have started this
+    // broadcast: they are done with the payload it held two broadcasts ago.
+    postNodeBarrier(requests);
+    requests.continuations.push_back([this, data, size, src, slot](MPIRequests& r)
+    {
+        if (nodeRank_ != 0)
+        {
+            // Wait for the node leader to publish the data
+            postNodeBarrier(r);
+            r.continuations.push_back([this](MPIRequests&)
+            {
+                MPI_Win_sync(sharedWindow_);
+            });
+            return;
+        }
+        if (src == mpiRank_)
+        {
+            std::memcpy(slot, data, size);
+            publishToNode(r);
+            return;
+        }
+        postBroadcast(slot, size, leaderRanks_[src], leadersComm_, r);
+        r.continuations.push_back([this](MPIRequests& r2)
+        {
+            publishToNode(r2);
+        });
+    });
+
+    // The sender keeps its own data, the other processes decode from the slot
+    return src == mpiRank_ ? data : slot;
+}
+
+void MPIChannel::publishToNode(MPIRequests& requests)
+{
+    MPI_Win_sync(sharedWindow_);
+    postNodeBarrier(requests);
+}
+
+void MPIChannel::postNodeBarrier(MPIRequests& requests)
+{
+    MPI_Request request;
+    MPI_CHECK(MPI_Ibarrier(nodeComm_, &request));
+    requests.requests.push_back(request);
+}
+
 int MPIChannel::getRank() const
 {
     return mpiRank_;
@@ -86,6 +240,16 @@ int MPIChannel::getSize() const
     return mpiSize_;
 }
 
+bool MPIChannel::isTopologyAware() const
+{
+    return topologyAware_;
+}
+
+int MPIChannel::getNodeSize() const
+{
+    return nodeSize_;
+}
+
 bool MPIChannel::isThreadSafe() const
 {
     return mpiContext_->hasMultithreadSupport();
@@ -104,28 +268,11 @@ int MPIChannel::globalSum(const int localValue) const
     return globalValue;
 }
 
-bool MPIChannel::isMessageAvailable(const int src)
-{
-    int flag;
-    MPI_Status status;
-    MPI_Iprobe(src, 0, mpiComm_, &flag, &status);
-
-    return (bool)flag;
-}
-
 bool MPIChannel::isValid(const int dest) const
 {
     return dest != mpiRank_ && dest >= 0 && dest < mpiSize_;
 }
 
-void MPIChannel::send(const MPIHeader& header, const int dest)
-{
-    if (!isValid(dest))
-        return;
-
-    MPI_CHECK(MPI_Send((void *)&header, sizeof(MPIHeader), MPI_BYTE, dest, 0, mpiComm_));
-}
-
 void MPIChannel::send(const MPIMessageType type, const std::string& serializedData, const int dest)
 {
     if (!isValid(dest))
@@ -136,12 +283,7 @@ void MPIChannel::send(const MPIMessageType type, const std::string& serializedDa
 
 void MPIChannel::sendAll(const MPIMessageType type)
 {
-    MPIHeader mh;
-    mh.size = 0;
-    mh.type = type;
-
-    for(int i=0; i<mpiSize_; ++i)
-        send(mh, i);
+    broadcast(type, std::string());
 }
 
 void MPIChannel::broadcast(const MPIMessageType type, const std::string& serializedData)
@@ -150,21 +292,48 @@ void MPIChannel::broadcast(const MPIMessageType type, const std::string& seriali
     mh.size = serializedData.size();
     mh.type = type;
 
-    for(int i=0; i<mpiSize_; ++i)
-        send(mh, i);
+    // Blocking and non-blocking collective operations do not match each other,
+    // so all broadcasts use the non-blocking implementation.
+    MPIRequests requests;
+    broadcastAsync(mh, serializedData, requests);
+    wait(requests);
+}
 
-    MPI_CHECK(MPI_Bcast((void *)serializedData.data(), serializedData.size(),
-                         MPI_BYTE, mpiRank_, mpiComm_));
+void MPIChannel::broadcastAsync(const MPIHeader& header,
+                                const std::string& serializedData,
+                                MPIRequests& requests)
+{
+    assert(header.size == serializedData.size());
+
+    // The fixed-size header is broadcasted too, which costs O(log(N)) steps
+    // instead of one point-to-point send to each of the N processes.
+    postBroadcast((char *)&header, sizeof(MPIHeader), mpiRank_, mpiComm_,
+                  requests);
+
+    char* data = (char *)serializedData.data();
+    if (isTwoLevelBroadcast(mpiRank_, serializedData.size()))
+        twoLevelBroadcast(data, serializedData.size(), mpiRank_, requests);
+    else
+        postBroadcast(data, serializedData.size(), mpiRank_, mpiComm_,
+                      requests);
 }
 
 MPIHeader MPIChannel::receiveHeader(const int src)
 {
-    MPI_Status status;
     MPIHeader mh;
-    MPI_CHECK(MPI_Recv((void *)&mh, sizeof(MPIHeader), MPI_BYTE, src, 0, mpiComm_, &status));
+    MPIRequests requests;
+    receiveHeaderAsync(mh, src, requests);
+    wait(requests);
     return mh;
 }
 
+void MPIChannel::receiveHeaderAsync(MPIHeader& header, const int src,
+                                    MPIRequests& requests)
+{
+    postBroadcast((char *)&header, sizeof(MPIHeader), src, mpiComm_,
+                  requests);
+}
+
 ProbeResult MPIChannel::probe(const int src, const int tag)
 {
     MPI_Status status;
@@ -184,7 +353,69 @@ void MPIChannel::receive(char* dataBuffer, const size_t messageSize, const int s
 
 void MPIChannel::receiveBroadcast(char* dataBuffer, const size_t messageSize, const int src)
 {
-    MPI_CHECK(MPI_Bcast((void *)dataBuffer, messageSize, MPI_BYTE, src, mpiComm_));
+    MPIRequests requests;
+    const char* data = receiveBroadcastAsync(dataBuffer, messageSize, src,
+                                             requests);
+    wait(requests);
+    if (data != dataBuffer)
+        std::memcpy(dataBuffer, data, messageSize);
+}
+
+const char* MPIChannel::receiveBroadcastAsync(char* dataBuffer,
+                                              const size_t messageSize,
+                                              const int src,
+                                              MPIRequests& requests)
+{
+    if (isTwoLevelBroadcast(src, messageSize))
+        return twoLevelBroadcast(dataBuffer, messageSize, src, requests);
+
+    postBroadcast(dataBuffer, messageSize, src, mpiComm_, requests);
+    return dataBuffer;
+}
+
+bool MPIChannel::test(MPIRequests& requests)
+{
+    while (true)
+    {
+        int flag = 1;
+        if (!requests.requests.empty())
+        {
+            MPI_CHECK(MPI_Testall(requests.requests.size(),
+                                  requests.requests.data(), &flag,
+                                  MPI_STATUSES_IGNORE));
+        }
+        if (!flag)
+            return false;
+
+        requests.requests.clear();
+        if (requests.continuations.empty())
+            return true;
+
+        // The next step may start new requests, which are tested right away
+        std::function<void(MPIRequests&)> next = requests.continuations.front();
+        requests.continuations.pop_front();
+        next(requests);
+    }
+}
+
+void MPIChannel::wait(MPIRequests& requests)
+{
+    while (true)
+    {
+        if (!requests.requests.empty())
+        {
+            MPI_CHECK(MPI_Waitall(requests.requests.size(),
+                                  requests.requests.data(),
+                                  MPI_STATUSES_IGNORE));
+            requests.requests.clear();
+        }
+        if (requests.continuations.empty())
+            return;
+
+        std::function<void(MPIRequests&)> next = requests.continuations.front();
+        requests.continuations.pop_front();
+        next(requests);
+    }
 }
 
 std::vector<uint64_t> MPIChannel::gatherAll(const uint64_t value)
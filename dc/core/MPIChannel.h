@@ -45,9 +45,28 @@
 
 #include <mpi.h>
 
+#include <deque>
+#include <functional>
+
 class MPIContext;
 typedef boost::shared_ptr<MPIContext> MPIContextPtr;
 
+/** The pending requests of non-blocking MPIChannel operations. */
+struct MPIRequests
+{
+    /** The MPI requests in progress. */
+    std::vector<MPI_Request> requests;
+
+    /** The next steps of the operations, run once the requests complete. */
+    std::deque<std::function<void(MPIRequests&)>> continuations;
+
+    /** @return true if there are no operations in progress. */
+    bool empty() const
+    {
+        return requests.empty() && continuations.empty();
+    }
+};
+
 /**
  * The result of an MPIChannel::probe() operation
  */
@@ -71,6 +90,12 @@ struct ProbeResult
 
 /**
  * Handle MPI communications between all DisplayCluster instances.
+ *
+ * When several processes of the channel run on the same host, broadcasts from
+ * a node leader (the lowest rank of each host) are topology-aware: the payload
+ * is sent once per host to the node leaders, which receive it directly in an
+ * MPI-3 shared-memory window allocated for their host at construction. The
+ * other processes of the host read it from there.
  */
 class MPIChannel
 {
@@ -102,6 +127,12 @@ public:
     /** Get the number of processes in this channel. */
     int getSize() const;
 
+    /** @return true if broadcasts are relayed by one process per host. */
+    bool isTopologyAware() const;
+
+    /** Get the number of processes of this channel on the local host. */
+    int getNodeSize() const;
+
     /** Is the channel thread-safe. Depends on the MPI implementation. */
     bool isThreadSafe() const;
 
@@ -124,20 +155,37 @@ public:
     void send(const MPIMessageType type, const std::string& serializedData, const int dest);
 
     /**
-     * Send a signal to all processes
+     * Send a signal to all processes.
+     * This is a collective operation, the other processes must call
+     * receiveHeader().
      * @param type The type of signal
      */
     void sendAll(const MPIMessageType type);
 
     /**
-     * Send a brodcast message to all other processes
+     * Send a brodcast message to all other processes.
+     * This is a collective operation, the other processes must call
+     * receiveHeader() followed by receiveBroadcast().
      * @param type The message type
      * @param serializedData The serialized data
      */
     void broadcast(const MPIMessageType type, const std::string& serializedData);
 
-    /** Nonblocking probe for messages from a given source */
-    bool isMessageAvailable(const int src);
+    /**
+     * Start a non-blocking broadcast to all other processes.
+     * This is a collective operation, the other processes must call
+     * receiveHeaderAsync() followed by receiveBroadcastAsync().
+     * On a topology-aware channel, the previous broadcast must be completed
+     * before a new one is started.
+     * @param header The message header, which must stay valid until the
+     *        requests are completed
+     * @param serializedData The serialized data of size header.size, which
+     *        must stay valid until the requests are completed
+     * @param requests The requests to wait for, appended to the given ones
+     * @see wait()
+     */
+    void broadcastAsync(const MPIHeader& header, const std::string& serializedData,
+                        MPIRequests& requests);
 
     /**
      * Perform a blocking probe operation that returns if a message is pending
@@ -148,14 +196,26 @@ public:
     ProbeResult probe(const int src = MPI_ANY_SOURCE, const int tag = MPI_ANY_TAG);
 
     /**
-     * Receive a header from a specific process.
+     * Receive a header broadcasted by a specific process.
      * This call is blocking.
-     * @see isMessageAvailable()
+     * @see broadcast()
+     * @see sendAll()
      * @param src The source process
      * @return The header containing the message type and size
      */
     MPIHeader receiveHeader(const int src);
 
+    /**
+     * Start receiving a header broadcasted by a specific process.
+     * @param header The header to receive, which must stay valid until the
+     *        requests are completed
+     * @param src The source process
+     * @param requests The requests to wait for, appended to the given ones
+     * @see broadcastAsync()
+     */
+    void receiveHeaderAsync(MPIHeader& header, const int src,
+                            MPIRequests& requests);
+
     /**
      * Receive a message from a specific process.
      * This call is blocking.
@@ -177,6 +237,36 @@ public:
      */
     void receiveBroadcast(char* dataBuffer, const size_t messageSize, const int src);
 
+    /**
+     * Start receiving a broadcast.
+     * On a topology-aware channel, the previous broadcast must be completed
+     * before a new one is started.
+     * @see receiveHeaderAsync()
+     * @param dataBuffer The target data buffer, which must stay valid until
+     *        the requests are completed
+     * @param messageSize The number of bytes to receive
+     * @param src The source process
+     * @param requests The requests to wait for, appended to the given ones
+     * @return the payload once the requests are completed: either dataBuffer,
+     *         or the shared memory of the host, which stays valid until this
+     *         process starts the second next broadcast on the channel
+     */
+    const char* receiveBroadcastAsync(char* dataBuffer, const size_t messageSize,
+                                      const int src, MPIRequests& requests);
+
+    /**
+     * Check if non-blocking operations have completed.
+     * @param requests The pending requests, cleared if they have completed
+     * @return true if all the requests have completed
+     */
+    bool test(MPIRequests& requests);
+
+    /**
+     * Block until non-blocking operations have completed.
+     * @param requests The pending requests, cleared on return
+     */
+    void wait(MPIRequests& requests);
+
     /**
      * Gather the values accross all the processes.
      * @param value The local value
@@ -190,8 +280,29 @@ private:
     int mpiRank_;
     int mpiSize_;
 
-    void send(const MPIHeader& header, const int dest);
+    // Processes on the same host and the slots of their shared buffer
+    MPI_Comm nodeComm_;
+    int nodeRank_;
+    int nodeSize_;
+    MPI_Win sharedWindow_;
+    char* sharedBuffer_;
+    unsigned int nextSharedSlot_;
+
+    // Node leaders, and the rank in leadersComm_ of each rank (or -1)
+    MPI_Comm leadersComm_;
+    std::vector<int> leaderRanks_;
+    bool topologyAware_;
+
     bool isValid(const int dest) const;
+
+    void initTopology();
+    void allocateSharedBuffer();
+    void freeSharedBuffer();
+    bool isTwoLevelBroadcast(const int src, const size_t size) const;
+    char* twoLevelBroadcast(char* data, const size_t size, const int src,
+                            MPIRequests& requests);
+    void publishToNode(MPIRequests& requests);
+    void postNodeBarrier(MPIRequests& requests);
 };
 
 #endif // MPICHANNEL_H
@@ -53,17 +53,42 @@ enum MPIMessageType
     MPI_MESSAGE_TYPE_OPTIONS,
     MPI_MESSAGE_TYPE_MARKERS,
     MPI_MESSAGE_TYPE_REQUEST_FRAME,
-    MPI_MESSAGE_TYPE_TIMESTAMP
+    MPI_MESSAGE_TYPE_TIMESTAMP,
+    MPI_MESSAGE_TYPE_REQUEST_TRACE,
+    MPI_MESSAGE_TYPE_TRACE,
+    MPI_MESSAGE_TYPE_METRICS
+};
+
+/** The compression algorithm of an MPI message payload. */
+enum MPICompression
+{
+    MPI_COMPRESSION_NONE,
+    MPI_COMPRESSION_LZ4,
+    MPI_COMPRESSION_ZLIB
 };
 
 /** Fixed-size message header. */
 struct MPIHeader
 {
+    /** Constructor for an empty uncompressed message. */
+    MPIHeader()
+        : type( MPI_MESSAGE_TYPE_NONE )
+        , size( 0 )
+        , compression( MPI_COMPRESSION_NONE )
+        , uncompressedSize( 0 )
+    {}
+
     /** Message type. */
     MPIMessageType type;
 
     /** Size of the message payload. */
     uint32_t size;
+
+    /** Compression algorithm of the payload. */
+    MPICompression compression;
+
+    /** Size of the payload after decompression. */
+    uint32_t uncompressedSize;
 };
 
 #endif // MPIHEADER_H
@@ -0,0 +1,235 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#include "MPISendScheduler.h"
+
+#include "Metrics.h"
+
+#include <deflect/Frame.h>
+
+#include <algorithm>
+
+namespace
+{
+size_t getCost( const deflect::Frame& frame )
+{
+    size_t cost = 0;
+    for( const deflect::Segment& segment : frame.segments )
+        cost += segment.imageData.size();
+    return std::max( cost, size_t( 1 ));
+}
+
+boost::posix_time::ptime now()
+{
+    return boost::posix_time::microsec_clock::universal_time();
+}
+}
+
+const double MPISendScheduler::DEFAULT_STREAM_WEIGHT = 1.0;
+const double MPISendScheduler::MIN_STREAM_WEIGHT = 0.001;
+
+MPISendScheduler::Statistics::Statistics()
+    : count( 0 )
+    , superseded( 0 )
+    , meanLatencyMs( 0.0 )
+    , maxLatencyMs( 0.0 )
+{
+}
+
+MPISendScheduler::StreamQueue::StreamQueue()
+    : startTag( 0.0 )
+    , finishTag( 0.0 )
+{
+}
+
+MPISendScheduler::MPISendScheduler()
+    : _virtualTime( 0.0 )
+{
+    resetStatistics();
+}
+
+void MPISendScheduler::pushControl( const MPIMessageType type,
+                                    std::string serializedData )
+{
+    PendingControl message = { type, std::move( serializedData ), now() };
+
+    std::lock_guard<std::mutex> lock( _mutex );
+    _controlQueue.push_back( std::move( message ));
+}
+
+void MPISendScheduler::pushFrame( deflect::FramePtr frame )
+{
+    const double cost = getCost( *frame );
+
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    StreamQueue& queue = _streamQueues[frame->uri];
+    if( queue.frame )
+    {
+        ++_latencies[MESSAGE_CLASS_PIXELSTREAM].stats.superseded;
+        Metrics::recordSupersededFrame();
+    }
+    else
+        queue.startTag = std::max( _virtualTime, queue.finishTag );
+
+    queue.finishTag = queue.startTag + cost / _getWeight( frame->uri );
+    queue.frame = frame;
+    queue.time = now();
+}
+
+bool MPISendScheduler::pop( Message& message )
+{
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    if( !_controlQueue.empty( ))
+    {
+        PendingControl& next = _controlQueue.front();
+        message.type = next.type;
+        message.data.swap( next.data );
+        message.frame.reset();
+        _recordLatency( MESSAGE_CLASS_CONTROL, next.time );
+        _controlQueue.pop_front();
+        return true;
+    }
+
+    StreamQueues::iterator next = _streamQueues.end();
+    for( StreamQueues::iterator it = _streamQueues.begin();
+         it != _streamQueues.end(); ++it )
+    {
+        if( !it->second.frame )
+            continue;
+        if( next == _streamQueues.end() ||
+            it->second.finishTag < next->second.finishTag )
+        {
+            next = it;
+        }
+    }
+    if( next == _streamQueues.end( ))
+        return false;
+
+    StreamQueue& queue = next->second;
+    message.type = MPI_MESSAGE_TYPE_PIXELSTREAM;
+    message.data.clear();
+    message.frame = queue.frame;
+    _recordLatency( MESSAGE_CLASS_PIXELSTREAM, queue.time );
+
+    // Self-clocked fair queueing: virtual time follows the message in service
+    _virtualTime = queue.finishTag;
+    queue.frame.reset();
+
+    return true;
+}
+
+size_t MPISendScheduler::getQueueSize() const
+{
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    size_t size = _controlQueue.size();
+    for( StreamQueues::const_iterator it = _streamQueues.begin();
+         it != _streamQueues.end(); ++it )
+    {
+        if( it->second.frame )
+            ++size;
+    }
+    return size;
+}
+
+void MPISendScheduler::setStreamWeights( const std::map< QString, double >&
+                                         weights )
+{
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    _streamWeights = weights;
+
+    // Forget about the streams which are gone
+    StreamQueues::iterator it = _streamQueues.begin();
+    while( it != _streamQueues.end( ))
+    {
+        if( !it->second.frame && !_streamWeights.count( it->first ))
+            _streamQueues.erase( it++ );
+        else
+            ++it;
+    }
+}
+
+MPISendScheduler::Statistics
+MPISendScheduler::getStatistics( const MessageClass messageClass ) const
+{
+    std::lock_guard<std::mutex> lock( _mutex );
+    return _latencies[messageClass].stats;
+}
+
+void MPISendScheduler::resetStatistics()
+{
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    for( size_t i = 0; i < MESSAGE_CLASS_COUNT; ++i )
+    {
+        _latencies[i].stats = Statistics();
+        _latencies[i].totalLatencyMs = 0.0;
+    }
+}
+
+double MPISendScheduler::_getWeight( const QString& uri ) const
+{
+    std::map< QString, double >::const_iterator it = _streamWeights.find( uri );
+    if( it == _streamWeights.end( ))
+        return DEFAULT_STREAM_WEIGHT;
+    return std::max( it->second, MIN_STREAM_WEIGHT );
+}
+
+void MPISendScheduler::_recordLatency( const MessageClass messageClass,
+                                       const boost::posix_time::ptime&
+                                       enqueueTime )
+{
+    const double latencyMs = ( now() - enqueueTime ).total_microseconds() /
+                             1000.0;
+
+    if( messageClass == MESSAGE_CLASS_CONTROL )
+        Metrics::recordControlQueueTime( latencyMs );
+    else
+        Metrics::recordStreamQueueTime( latencyMs );
+
+    LatencyAccumulator& accumulator = _latencies[messageClass];
+    accumulator.totalLatencyMs += latencyMs;
+    ++accumulator.stats.count;
+    accumulator.stats.meanLatencyMs = accumulator.totalLatencyMs /
+                                      accumulator.stats.count;
+    accumulator.stats.maxLatencyMs = std::max( accumulator.stats.maxLatencyMs,
+                                               latencyMs );
+}
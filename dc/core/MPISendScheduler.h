@@ -0,0 +1,198 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#ifndef MPISENDSCHEDULER_H
+#define MPISENDSCHEDULER_H
+
+#include "types.h"
+#include "MPIHeader.h"
+
+#include <QString>
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/noncopyable.hpp>
+
+#include <deque>
+#include <map>
+#include <mutex>
+
+/**
+ * Schedule the messages sent from the master application to the walls.
+ *
+ * Control messages (DisplayGroup, Options, Markers...) are always sent first,
+ * in the order in which they were pushed.
+ *
+ * Pixel stream frames share the remaining bandwidth by weighted fair queueing:
+ * each stream is served in proportion to its weight (typically the visible
+ * area of its window), so that one heavy stream can not starve the others.
+ * A new frame supersedes the frame of the same stream that is still waiting
+ * to be sent.
+ *
+ * This class is thread-safe.
+ */
+class MPISendScheduler : public boost::noncopyable
+{
+public:
+    /** The classes of messages handled by the scheduler. */
+    enum MessageClass
+    {
+        MESSAGE_CLASS_CONTROL,
+        MESSAGE_CLASS_PIXELSTREAM,
+        MESSAGE_CLASS_COUNT
+    };
+
+    /** A message to be sent. */
+    struct Message
+    {
+        /** The type of message. */
+        MPIMessageType type;
+
+        /** The serialized data of a control message. */
+        std::string data;
+
+        /** The frame of a pixel stream message, serialized by the sender. */
+        deflect::FramePtr frame;
+    };
+
+    /** Queuing statistics for one class of messages. */
+    struct Statistics
+    {
+        Statistics();
+
+        /** Number of messages sent. */
+        size_t count;
+
+        /** Number of messages dropped because a newer one superseded them. */
+        size_t superseded;
+
+        /** Average time spent in the queue in milliseconds. */
+        double meanLatencyMs;
+
+        /** Maximum time spent in the queue in milliseconds. */
+        double maxLatencyMs;
+    };
+
+    /** Default weight of streams for which setStreamWeights() is not set. */
+    static const double DEFAULT_STREAM_WEIGHT;
+
+    /** Smallest weight of a stream, so that hidden streams still progress. */
+    static const double MIN_STREAM_WEIGHT;
+
+    /** Constructor. */
+    MPISendScheduler();
+
+    /**
+     * Push a control message, to be sent before any pixel stream frame.
+     * @param type The message type
+     * @param serializedData The serialized message, moved into the queue
+     */
+    void pushControl( MPIMessageType type, std::string serializedData );
+
+    /**
+     * Push a pixel stream frame.
+     * @param frame The frame, replacing any pending frame of the same stream
+     */
+    void pushFrame( deflect::FramePtr frame );
+
+    /**
+     * Get the next message to send.
+     * @param message The message to send, if any.
+     * @return false if there are no messages waiting to be sent.
+     */
+    bool pop( Message& message );
+
+    /** @return the number of messages waiting to be sent. */
+    size_t getQueueSize() const;
+
+    /**
+     * Set the weights of the streams, replacing all the previous ones.
+     * @param weights The weight of each stream, indexed by uri. Weights must be
+     *        strictly positive.
+     */
+    void setStreamWeights( const std::map< QString, double >& weights );
+
+    /**
+     * Get the queuing statistics since the last call to resetStatistics().
+     * @param messageClass The class of messages
+     */
+    Statistics getStatistics( MessageClass messageClass ) const;
+
+    /** Reset the queuing statistics of all the message classes. */
+    void resetStatistics();
+
+private:
+    struct PendingControl
+    {
+        MPIMessageType type;
+        std::string data;
+        boost::posix_time::ptime time;
+    };
+
+    struct StreamQueue
+    {
+        StreamQueue();
+
+        deflect::FramePtr frame;
+        boost::posix_time::ptime time;
+        double startTag;
+        double finishTag;
+    };
+
+    struct LatencyAccumulator
+    {
+        Statistics stats;
+        double totalLatencyMs;
+    };
+
+    mutable std::mutex _mutex;
+
+    std::deque< PendingControl > _controlQueue;
+
+    typedef std::map< QString, StreamQueue > StreamQueues;
+    StreamQueues _streamQueues;
+    std::map< QString, double > _streamWeights;
+    double _virtualTime;
+
+    LatencyAccumulator _latencies[MESSAGE_CLASS_COUNT];
+
+    double _getWeight( const QString& uri ) const;
+    void _recordLatency( MessageClass messageClass,
+                         const boost::posix_time::ptime& enqueueTime );
+};
+
+#endif // MPISENDSCHEDULER_H
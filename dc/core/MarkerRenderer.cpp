@@ -55,8 +55,16 @@ MarkerRenderer::MarkerRenderer()
 void MarkerRenderer::render()
 {
     const MarkersMap& map = _markers->getMarkers();
+    if( map.empty() || ( !_texture.isValid() && !_generateTexture( )))
+        return;
+
     for( MarkersMap::const_iterator it = map.begin(); it != map.end(); ++it )
         _render( it->second );
+
+    glPushAttrib( GL_ENABLE_BIT );
+    glDisable( GL_DEPTH_TEST );
+    _quadBatch.render();
+    glPopAttrib();
 }
 
 void MarkerRenderer::setMarkers( MarkersPtr markers )
@@ -66,29 +74,12 @@ void MarkerRenderer::setMarkers( MarkersPtr markers )
 
 void MarkerRenderer::_render( const Marker& marker )
 {
-    if ( !_texture.isValid() && !_generateTexture( ))
-        return;
-
     const QPointF pos = marker.getPosition();
+    const QRectF rect( pos.x() - 0.5 * MARKER_SIZE_PIXELS,
+                       pos.y() - 0.5 * MARKER_SIZE_PIXELS,
+                       MARKER_SIZE_PIXELS, MARKER_SIZE_PIXELS );
 
-    glPushAttrib( GL_ENABLE_BIT | GL_TEXTURE_BIT );
-
-    glDisable( GL_DEPTH_TEST );
-    glEnable( GL_BLEND );
-    glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
-
-    glPushMatrix();
-
-    glTranslatef( pos.x(), pos.y(), 0.f );
-    glScalef( MARKER_SIZE_PIXELS, MARKER_SIZE_PIXELS, 1.f );
-    glTranslatef( -0.5f, -0.5f, 0.f ); // Center unit quad
-
-    _quad.setTexture( _texture.getTextureId( ));
-    _quad.render();
-
-    glPopMatrix();
-
-    glPopAttrib();
+    _quadBatch.add( rect, UNIT_RECTF, _texture.getTextureId(), true );
 }
 
 bool MarkerRenderer::_generateTexture()
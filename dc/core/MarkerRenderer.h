@@ -43,7 +43,7 @@
 #include "types.h"
 #include "Renderable.h"
 #include "GLTexture2D.h"
-#include "GLQuad.h"
+#include "GLQuadBatch.h"
 #include "Markers.h"
 
 #include <QObject>
@@ -73,7 +73,7 @@ private:
     Q_DISABLE_COPY( MarkerRenderer )
 
     GLTexture2D _texture;
-    GLQuad _quad;
+    GLQuadBatch _quadBatch;
     MarkersPtr _markers;
 
     bool _generateTexture();
@@ -68,6 +68,16 @@ void MasterFromWallChannel::processMessages()
             emit receivedRequestFrame(uri);
             break;
         }
+        case MPI_MESSAGE_TYPE_TRACE:
+            emit receivedTrace(QByteArray(buffer_.data(), result.size));
+            break;
+        case MPI_MESSAGE_TYPE_METRICS:
+        {
+            ProcessMetrics metrics;
+            buffer_.deserialize(metrics);
+            emit receivedMetrics(metrics);
+            break;
+        }
         case MPI_MESSAGE_TYPE_QUIT:
             processMessages_ = false;
             break;
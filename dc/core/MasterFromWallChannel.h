@@ -41,6 +41,7 @@
 #define MASTERFROMWALLCHANNEL_H
 
 #include "types.h"
+#include "Metrics.h"
 #include "MPIHeader.h"
 #include "SerializeBuffer.h"
 
@@ -70,6 +71,18 @@ signals:
      */
     void receivedRequestFrame( QString uri );
 
+    /**
+     * Emitted when a wall process sent its Profiler events
+     * @param traceEvents The events, as returned by Profiler::getTraceEvents()
+     */
+    void receivedTrace( QByteArray traceEvents );
+
+    /**
+     * Emitted when a wall process sent its performance metrics
+     * @param metrics The metrics of the process
+     */
+    void receivedMetrics( ProcessMetrics metrics );
+
 private:
     Q_DISABLE_COPY( MasterFromWallChannel )
 
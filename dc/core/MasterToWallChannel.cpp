@@ -39,68 +39,205 @@
 
 #include "MasterToWallChannel.h"
 
-#include "MPIChannel.h"
+#include "BroadcastTransport.h"
 #include "DisplayGroup.h"
 #include "ContentWindow.h"
+#include "Content.h"
 #include "Options.h"
 #include "Markers.h"
+#include "Profiler.h"
+#include "log.h"
 
 #include <deflect/Frame.h>
 
-MasterToWallChannel::MasterToWallChannel( MPIChannelPtr mpiChannel )
-    : _mpiChannel( mpiChannel )
+#include <algorithm>
+
+namespace
 {
+const qint64 STATISTICS_LOG_INTERVAL_MS = 10000;
 }
 
-template< typename T >
-void MasterToWallChannel::broadcast( const T& object,
-                                     const MPIMessageType type )
+MasterToWallChannel::MasterToWallChannel( BroadcastSenderPtr sender )
+    : _sender( sender )
+{
+    _displayGroupEncoder.enableContentRegistry();
+    _statisticsTimer.start();
+}
+
+void MasterToWallChannel::_broadcast( const MPIMessageType type,
+                                      std::string& serializedData,
+                                      const bool compress )
 {
-    const std::string& serializedString = _buffer.serialize( object );
+    PROFILE_SCOPE( "mpi", "broadcast" );
+
+    // Compression also overlaps with the transfer of the previous message
+    MPIHeader header;
+    header.type = type;
+    header.uncompressedSize = serializedData.size();
+    header.compression = compress ? _compressor.compress( serializedData )
+                                  : MPI_COMPRESSION_NONE;
+    header.size = serializedData.size();
 
-    _mpiChannel->broadcast( type, serializedString );
+    _sender->send( header, serializedData );
 }
 
 template< typename T >
-void MasterToWallChannel::broadcastAsync( const T& object,
+void MasterToWallChannel::broadcastAsync( BinaryEncoder& encoder,
+                                          const T& object,
                                           const MPIMessageType type )
 {
-    const std::string serializedStringCopy = _asyncBuffer.serialize( object );
+    std::string serializedData;
+    encoder.encode( object, serializedData );
+    _scheduler.pushControl( type, std::move( serializedData ));
 
-    QMetaObject::invokeMethod( this, "_broadcast", Qt::QueuedConnection,
-                               Q_ARG( MPIMessageType, type ),
-                               Q_ARG( std::string, serializedStringCopy ));
+    QMetaObject::invokeMethod( this, "_processQueue", Qt::QueuedConnection );
 }
 
 void MasterToWallChannel::sendAsync( DisplayGroupPtr displayGroup )
 {
-    broadcastAsync( displayGroup, MPI_MESSAGE_TYPE_DISPLAYGROUP );
+    _updateStreamWeights( *displayGroup );
+    broadcastAsync( _displayGroupEncoder, displayGroup,
+                    MPI_MESSAGE_TYPE_DISPLAYGROUP );
 }
 
 void MasterToWallChannel::sendAsync( OptionsPtr options )
 {
-    broadcastAsync( options, MPI_MESSAGE_TYPE_OPTIONS );
+    broadcastAsync( _asyncEncoder, options, MPI_MESSAGE_TYPE_OPTIONS );
 }
 
 void MasterToWallChannel::sendAsync( MarkersPtr markers )
 {
-    broadcastAsync( markers, MPI_MESSAGE_TYPE_MARKERS );
+    broadcastAsync( _asyncEncoder, markers, MPI_MESSAGE_TYPE_MARKERS );
 }
 
 void MasterToWallChannel::send( deflect::FramePtr frame )
 {
     assert( !frame->segments.empty() && "received an empty frame" );
-    broadcast( frame, MPI_MESSAGE_TYPE_PIXELSTREAM );
+    _scheduler.pushFrame( frame );
+
+    QMetaObject::invokeMethod( this, "_processQueue", Qt::QueuedConnection );
+}
+
+void MasterToWallChannel::sendTraceRequest()
+{
+    _scheduler.pushControl( MPI_MESSAGE_TYPE_REQUEST_TRACE, std::string( ));
+
+    QMetaObject::invokeMethod( this, "_processQueue", Qt::QueuedConnection );
 }
 
 void MasterToWallChannel::sendQuit()
 {
-    _mpiChannel->sendAll( MPI_MESSAGE_TYPE_QUIT );
+    std::string noData;
+    _broadcast( MPI_MESSAGE_TYPE_QUIT, noData, false );
+    _sender->flush();
 }
 
-// cppcheck-suppress passedByValue
-void MasterToWallChannel::_broadcast( const MPIMessageType type,
-                                      const std::string data )
+MPISendScheduler::Statistics MasterToWallChannel::getSendStatistics(
+        const MPISendScheduler::MessageClass messageClass ) const
+{
+    return _scheduler.getStatistics( messageClass );
+}
+
+size_t MasterToWallChannel::getQueueSize() const
+{
+    return _scheduler.getQueueSize();
+}
+
+MessageCompressor::Statistics
+MasterToWallChannel::getCompressionStatistics() const
+{
+    return _compressor.getStatistics();
+}
+
+void MasterToWallChannel::setCompressionThreshold( const size_t threshold )
+{
+    _compressor.setThreshold( threshold );
+}
+
+void MasterToWallChannel::_updateStreamWeights( const DisplayGroup& group )
+{
+    // Streams are weighted by the fraction of the wall covered by their window
+    const QRectF& wall = group.getCoordinates();
+    const qreal wallArea = wall.width() * wall.height();
+    if( wallArea <= 0.0 )
+        return;
+
+    std::map< QString, double > weights;
+    for( ContentWindowPtr window : group.getContentWindows( ))
+    {
+        ContentPtr content = window->getContent();
+        if( content->getType() != CONTENT_TYPE_PIXEL_STREAM )
+            continue;
+
+        const QRectF& coords = window->isFocused() ?
+                                   window->getFocusedCoordinates() :
+                                   window->getCoordinates();
+        const QRectF visibleArea = coords & wall;
+        const double area = visibleArea.width() * visibleArea.height() /
+                            wallArea;
+        const double weight = std::max( area,
+                                        MPISendScheduler::MIN_STREAM_WEIGHT );
+        double& streamWeight = weights[content->getURI()];
+        streamWeight = std::max( streamWeight, weight );
+    }
+    _scheduler.setStreamWeights( weights );
+}
+
+void MasterToWallChannel::_logStatistics()
 {
-    _mpiChannel->broadcast( type, data );
+    if( _statisticsTimer.elapsed() < STATISTICS_LOG_INTERVAL_MS )
+        return;
+
+    const MPISendScheduler::Statistics control =
+            _scheduler.getStatistics( MPISendScheduler::MESSAGE_CLASS_CONTROL );
+    const MPISendScheduler::Statistics streams =
+        _scheduler.getStatistics( MPISendScheduler::MESSAGE_CLASS_PIXELSTREAM );
+
+    put_flog( LOG_DEBUG, "control: %d sent, latency mean %.1f max %.1f ms; "
+              "pixel streams: %d sent, %d superseded, "
+              "latency mean %.1f max %.1f ms",
+              (int)control.count, control.meanLatencyMs, control.maxLatencyMs,
+              (int)streams.count, (int)streams.superseded,
+              streams.meanLatencyMs, streams.maxLatencyMs );
+
+    const MessageCompressor::Statistics compression =
+            _compressor.getStatistics();
+    put_flog( LOG_DEBUG, "compression: %d/%d control messages, "
+              "%d -> %d bytes (ratio %.2f) in %.1f ms",
+              (int)compression.compressed, (int)compression.count,
+              (int)compression.uncompressedBytes,
+              (int)compression.compressedBytes, compression.getRatio(),
+              compression.timeMs );
+
+    _scheduler.resetStatistics();
+    _compressor.resetStatistics();
+    _statisticsTimer.restart();
+}
+
+void MasterToWallChannel::_processQueue()
+{
+    MPISendScheduler::Message message;
+    if( !_scheduler.pop( message ))
+        return;
+
+    // Encoding the frame overlaps with the transfer of the previous message.
+    // The frame buffer is swapped with the one of the previous message, so
+    // the two buffers are reused without allocation.
+    // Only control messages are compressed, frames are mostly JPEG images.
+    if( message.frame )
+    {
+        {
+            PROFILE_SCOPE( "mpi", "encodeFrame" );
+            _encoder.encode( message.frame, _frameData );
+        }
+        _broadcast( message.type, _frameData, false );
+    }
+    else
+        _broadcast( message.type, message.data, true );
+
+    // Nothing else to overlap with, complete the transfer now
+    if( _scheduler.getQueueSize() == 0 )
+        _sender->flush();
+
+    _logStatistics();
 }
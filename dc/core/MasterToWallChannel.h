@@ -41,10 +41,12 @@
 #define MASTERTOWALLCHANNEL_H
 
 #include "types.h"
-#include "MPIHeader.h"
-#include "SerializeBuffer.h"
+#include "BinaryCodec.h"
+#include "MPISendScheduler.h"
+#include "MessageCompressor.h"
 
 #include <QObject>
+#include <QElapsedTimer>
 
 /**
  * Sending channel from the master application to the wall processes.
@@ -53,23 +55,55 @@
  *
  * The methods in this class are NOT thread-safe.
  *
- * The send() functions are fully synchronous and rely on Qt::QueuedConnection
- * for safe inter-thread communication.
- *
  * The sendAsync() functions are a workaround for objects that cannot be passed
  * by copy and also cannot provide a thread-safe serialize() function.
  * They can be called directly from the main thread (Qt::DirectConnection).
  * The given object is serialized synchronously (in the calling thread), then
  * the serialized data is sent asynchronously in the MasterToWallChannel's
  * thread.
+ * The Contents of a DisplayGroup are only sent if they are new or modified.
+ *
+ * The send( deflect::FramePtr ) function can also be called directly from any
+ * thread. Messages waiting to be sent are ordered by an MPISendScheduler:
+ * control messages first, then pixel stream frames shared fairly between the
+ * streams according to the visible area of their windows.
+ *
+ * Messages are sent by a BroadcastSender, which can be MPI or shared memory.
+ * MPI broadcasts are non-blocking: the next message is serialized while the
+ * previous one is being transferred.
+ *
+ * Control messages larger than the compression threshold are compressed.
  */
 class MasterToWallChannel : public QObject
 {
     Q_OBJECT
 
 public:
-    /** Constructor */
-    MasterToWallChannel( MPIChannelPtr mpiChannel );
+    /**
+     * Constructor
+     * @param sender The transport of the messages to the walls
+     */
+    MasterToWallChannel( BroadcastSenderPtr sender );
+
+    /**
+     * Get the queuing statistics of the messages sent to the walls.
+     * @param messageClass The class of messages
+     */
+    MPISendScheduler::Statistics
+    getSendStatistics( MPISendScheduler::MessageClass messageClass ) const;
+
+    /** @return the number of messages waiting to be sent to the walls. */
+    size_t getQueueSize() const;
+
+    /** Get the compression statistics of the control messages. */
+    MessageCompressor::Statistics getCompressionStatistics() const;
+
+    /**
+     * Set the minimum size of the control messages to compress.
+     * Must be called before moving this object to its thread.
+     * @param threshold The size in bytes, 0 to disable compression.
+     */
+    void setCompressionThreshold( size_t threshold );
 
 public slots:
     /**
@@ -92,10 +126,16 @@ public slots:
 
     /**
      * Send pixel stream frame to the wall processes.
-     * @param frame The frame to send
+     * @param frame The frame to send, superseding any frame of the same stream
+     *        which is still waiting to be sent.
      */
     void send( deflect::FramePtr frame );
 
+    /**
+     * Request the wall processes to send their Profiler events to the master.
+     */
+    void sendTraceRequest();
+
     /**
      * Send quit message to the wall processes, terminating the application.
      */
@@ -104,17 +144,27 @@ public slots:
 private:
     Q_DISABLE_COPY( MasterToWallChannel )
 
-    MPIChannelPtr _mpiChannel;
-    SerializeBuffer _buffer;
-    SerializeBuffer _asyncBuffer;
+    BroadcastSenderPtr _sender;
+    BinaryEncoder _asyncEncoder;
+    BinaryEncoder _displayGroupEncoder;
+    BinaryEncoder _encoder;
+    std::string _frameData;
 
+    MPISendScheduler _scheduler;
+    MessageCompressor _compressor;
+    QElapsedTimer _statisticsTimer;
+
+    void _broadcast( MPIMessageType type, std::string& serializedData,
+                     bool compress );
     template< typename T >
-    void broadcast( const T& object, const MPIMessageType type );
-    template< typename T >
-    void broadcastAsync( const T& object, const MPIMessageType type );
+    void broadcastAsync( BinaryEncoder& encoder, const T& object,
+                         const MPIMessageType type );
+
+    void _updateStreamWeights( const DisplayGroup& displayGroup );
+    void _logStatistics();
 
 private slots:
-    void _broadcast( MPIMessageType type, std::string data );
+    void _processQueue();
 };
 
 #endif // MASTERTOWALLCHANNEL_H
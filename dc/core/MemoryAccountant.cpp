@@ -0,0 +1,163 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+#include "MemoryAccountant.h"
+
+#include "log.h"
+
+#include <algorithm>
+#include <vector>
+
+const size_t MemoryAccountant::DEFAULT_BUDGET_BYTES = size_t( 2048 ) * 1024 * 1024;
+
+MemoryAccountant::MemoryAccountant()
+    : _budget( DEFAULT_BUDGET_BYTES )
+    , _usage( 0 )
+    , _frame( 1 )
+    , _evictions( 0 )
+    , _overBudget( false )
+{
+}
+
+void MemoryAccountant::setBudget( const size_t bytes )
+{
+    _budget = bytes;
+}
+
+size_t MemoryAccountant::getBudget() const
+{
+    return _budget;
+}
+
+void MemoryAccountant::add( Client& client, const QString& window,
+                            const QString& type )
+{
+    const Entry entry = { window, type, 0, false, 0 };
+    _entries[&client] = entry;
+}
+
+void MemoryAccountant::remove( Client& client )
+{
+    _entries.erase( &client );
+}
+
+void MemoryAccountant::setVisible( Client& client, const bool visible )
+{
+    Entries::iterator it = _entries.find( &client );
+    if( it == _entries.end( ))
+        return;
+
+    it->second.visible = visible;
+}
+
+size_t MemoryAccountant::update()
+{
+    _usage = 0;
+    for( auto& it : _entries )
+    {
+        it.second.usage = it.first->getMemoryUsage();
+        _usage += it.second.usage;
+        if( it.second.visible )
+            it.second.lastVisibleFrame = _frame;
+    }
+
+    size_t evicted = 0;
+    if( _usage > _budget )
+    {
+        std::vector< Entries::iterator > candidates;
+        for( Entries::iterator it = _entries.begin(); it != _entries.end();
+             ++it )
+        {
+            if( !it->second.visible && it->second.usage > 0 )
+                candidates.push_back( it );
+        }
+        std::sort( candidates.begin(), candidates.end(),
+                   []( Entries::iterator a, Entries::iterator b )
+                   { return a->second.lastVisibleFrame <
+                            b->second.lastVisibleFrame; } );
+
+        for( Entries::iterator it : candidates )
+        {
+            if( _usage <= _budget )
+                break;
+
+            it->first->releaseMemory();
+            const size_t usage = it->first->getMemoryUsage();
+            _usage -= it->second.usage - std::min( usage, it->second.usage );
+            it->second.usage = usage;
+            ++evicted;
+        }
+    }
+    _evictions += evicted;
+
+    const bool overBudget = _usage > _budget;
+    if( overBudget && !_overBudget )
+        put_flog( LOG_WARN, "visible contents use %zu MB, over the budget of "
+                  "%zu MB", _usage / 1024 / 1024, _budget / 1024 / 1024 );
+    _overBudget = overBudget;
+
+    ++_frame;
+    return evicted;
+}
+
+size_t MemoryAccountant::getUsage() const
+{
+    return _usage;
+}
+
+uint64_t MemoryAccountant::getEvictionCount() const
+{
+    return _evictions;
+}
+
+std::map< QString, size_t > MemoryAccountant::getUsagePerWindow() const
+{
+    std::map< QString, size_t > usage;
+    for( const auto& it : _entries )
+        usage[it.second.window] += it.second.usage;
+    return usage;
+}
+
+std::map< QString, size_t > MemoryAccountant::getUsagePerType() const
+{
+    std::map< QString, size_t > usage;
+    for( const auto& it : _entries )
+        usage[it.second.type] += it.second.usage;
+    return usage;
+}
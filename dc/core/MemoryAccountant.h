@@ -0,0 +1,144 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+#ifndef MEMORYACCOUNTANT_H
+#define MEMORYACCOUNTANT_H
+
+#include <QString>
+
+#include <boost/noncopyable.hpp>
+
+#include <map>
+#include <stdint.h>
+
+/**
+ * Keep the memory used by the contents of a wall process within a budget.
+ *
+ * Contents register with the accountant and report if they are visible in
+ * each frame. When the memory used by all the contents exceeds the budget,
+ * the contents which are not visible release their memory, starting with the
+ * least recently visible ones. Visible contents are never evicted.
+ *
+ * This class is not thread-safe, it must be used from the rendering thread.
+ */
+class MemoryAccountant : public boost::noncopyable
+{
+public:
+    /** An object whose memory is accounted for. */
+    class Client
+    {
+    public:
+        virtual ~Client() {}
+
+        /** @return the memory currently used by the object, in bytes. */
+        virtual size_t getMemoryUsage() const = 0;
+
+        /**
+         * Release as much memory as possible. The object must allocate it
+         * again when it becomes visible.
+         */
+        virtual void releaseMemory() = 0;
+    };
+
+    /** Default memory budget in bytes. */
+    static const size_t DEFAULT_BUDGET_BYTES;
+
+    /** Constructor. */
+    MemoryAccountant();
+
+    /** Set the memory budget in bytes. */
+    void setBudget( size_t bytes );
+
+    /** @return the memory budget in bytes. */
+    size_t getBudget() const;
+
+    /**
+     * Register a client.
+     * @param client The client, which must be removed before its destruction
+     * @param window The identifier of the window of the client
+     * @param type The type of the client
+     */
+    void add( Client& client, const QString& window, const QString& type );
+
+    /** Unregister a client. */
+    void remove( Client& client );
+
+    /** Set if a client is visible in the current frame. */
+    void setVisible( Client& client, bool visible );
+
+    /**
+     * Update the memory usage of the clients and evict the ones which are
+     * not visible until the usage is within the budget. Called once per frame.
+     * @return the number of clients which were evicted.
+     */
+    size_t update();
+
+    /** @return the memory used by all the clients at the last update. */
+    size_t getUsage() const;
+
+    /** @return the number of evictions since the creation of the object. */
+    uint64_t getEvictionCount() const;
+
+    /** @return the memory used by the clients of each window. */
+    std::map< QString, size_t > getUsagePerWindow() const;
+
+    /** @return the memory used by the clients of each type. */
+    std::map< QString, size_t > getUsagePerType() const;
+
+private:
+    struct Entry
+    {
+        QString window;
+        QString type;
+        size_t usage;
+        bool visible;
+        uint64_t lastVisibleFrame;
+    };
+
+    typedef std::map< Client*, Entry > Entries;
+    Entries _entries;
+
+    size_t _budget;
+    size_t _usage;
+    uint64_t _frame;
+    uint64_t _evictions;
+    bool _overBudget;
+};
+
+#endif // MEMORYACCOUNTANT_H
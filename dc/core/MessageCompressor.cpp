@@ -0,0 +1,223 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+#include "MessageCompressor.h"
+
+#include "SerializeBuffer.h"
+
+#include <QByteArray>
+#include <QtEndian>
+
+#if ENABLE_LZ4_COMPRESSION
+#  include <lz4.h>
+#endif
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace
+{
+// Favor speed, messages are compressed at interaction rate
+const int ZLIB_COMPRESSION_LEVEL = 1;
+
+double elapsedMs( const boost::posix_time::ptime& start )
+{
+    const boost::posix_time::ptime now =
+            boost::posix_time::microsec_clock::universal_time();
+    return ( now - start ).total_microseconds() / 1000.0;
+}
+}
+
+const size_t MessageCompressor::DEFAULT_THRESHOLD = 32768;
+
+MessageCompressor::Statistics::Statistics()
+    : count( 0 )
+    , compressed( 0 )
+    , uncompressedBytes( 0 )
+    , compressedBytes( 0 )
+    , timeMs( 0.0 )
+{}
+
+double MessageCompressor::Statistics::getRatio() const
+{
+    if( compressedBytes == 0 )
+        return 1.0;
+    return double( uncompressedBytes ) / compressedBytes;
+}
+
+MessageCompressor::MessageCompressor()
+    : _threshold( DEFAULT_THRESHOLD )
+{}
+
+MPICompression MessageCompressor::getDefaultAlgorithm()
+{
+#if ENABLE_LZ4_COMPRESSION
+    return MPI_COMPRESSION_LZ4;
+#else
+    return MPI_COMPRESSION_ZLIB;
+#endif
+}
+
+void MessageCompressor::setThreshold( const size_t threshold )
+{
+    _threshold = threshold;
+}
+
+size_t MessageCompressor::getThreshold() const
+{
+    return _threshold;
+}
+
+MPICompression MessageCompressor::compress( std::string& data )
+{
+    const size_t size = data.size();
+    if( _threshold == 0 || size < _threshold ||
+        size > size_t( std::numeric_limits< int >::max( )))
+    {
+        _record( size, size, 0.0 );
+        return MPI_COMPRESSION_NONE;
+    }
+
+    const boost::posix_time::ptime start =
+            boost::posix_time::microsec_clock::universal_time();
+
+    const MPICompression algorithm = getDefaultAlgorithm();
+#if ENABLE_LZ4_COMPRESSION
+    _buffer.resize( LZ4_compressBound( size ));
+    const int compressedSize = LZ4_compress_default( data.data(), &_buffer[0],
+                                                     size, _buffer.size( ));
+    _buffer.resize( compressedSize > 0 ? compressedSize : size );
+#else
+    const QByteArray compressed = qCompress( (const uchar*)data.data(), size,
+                                             ZLIB_COMPRESSION_LEVEL );
+    _buffer.assign( compressed.constData(), compressed.size( ));
+#endif
+
+    const double timeMs = elapsedMs( start );
+    if( _buffer.size() >= size )
+    {
+        _record( size, size, timeMs );
+        return MPI_COMPRESSION_NONE;
+    }
+
+    // Swap instead of copy, the two buffers keep their capacity for reuse
+    data.swap( _buffer );
+    _record( size, data.size(), timeMs );
+    return algorithm;
+}
+
+void MessageCompressor::decompress( const MPIHeader& header, const char* data,
+                                    SerializeBuffer& output )
+{
+    const boost::posix_time::ptime start =
+            boost::posix_time::microsec_clock::universal_time();
+
+    output.setSize( header.uncompressedSize );
+
+    switch( header.compression )
+    {
+    case MPI_COMPRESSION_NONE:
+        if( header.size != header.uncompressedSize )
+            throw std::runtime_error( "Invalid uncompressed message size" );
+        std::memcpy( output.data(), data, header.size );
+        break;
+    case MPI_COMPRESSION_LZ4:
+    {
+#if ENABLE_LZ4_COMPRESSION
+        const int size = LZ4_decompress_safe( data, output.data(), header.size,
+                                              header.uncompressedSize );
+        if( size < 0 || uint32_t( size ) != header.uncompressedSize )
+            throw std::runtime_error( "Invalid LZ4 compressed message" );
+#else
+        throw std::runtime_error( "LZ4 compression is not supported" );
+#endif
+        break;
+    }
+    case MPI_COMPRESSION_ZLIB:
+    {
+        // qCompress() prepends the uncompressed size, check it before
+        // qUncompress() allocates memory for it
+        if( header.size < sizeof( quint32 ) ||
+            qFromBigEndian< quint32 >( (const uchar*)data ) !=
+                header.uncompressedSize )
+        {
+            throw std::runtime_error( "Invalid zlib compressed message" );
+        }
+        const QByteArray uncompressed = qUncompress( (const uchar*)data,
+                                                     header.size );
+        if( uint32_t( uncompressed.size( )) != header.uncompressedSize )
+            throw std::runtime_error( "Invalid zlib compressed message" );
+        std::memcpy( output.data(), uncompressed.constData(),
+                     header.uncompressedSize );
+        break;
+    }
+    default:
+        throw std::runtime_error( "Unknown message compression" );
+    }
+
+    _record( header.uncompressedSize, header.size, elapsedMs( start ));
+}
+
+MessageCompressor::Statistics MessageCompressor::getStatistics() const
+{
+    std::lock_guard< std::mutex > lock( _mutex );
+    return _statistics;
+}
+
+void MessageCompressor::resetStatistics()
+{
+    std::lock_guard< std::mutex > lock( _mutex );
+    _statistics = Statistics();
+}
+
+void MessageCompressor::_record( const size_t uncompressedSize,
+                                 const size_t compressedSize,
+                                 const double timeMs )
+{
+    std::lock_guard< std::mutex > lock( _mutex );
+    ++_statistics.count;
+    if( compressedSize != uncompressedSize )
+        ++_statistics.compressed;
+    _statistics.uncompressedBytes += uncompressedSize;
+    _statistics.compressedBytes += compressedSize;
+    _statistics.timeMs += timeMs;
+}
@@ -0,0 +1,140 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+#ifndef MESSAGECOMPRESSOR_H
+#define MESSAGECOMPRESSOR_H
+
+#include "MPIHeader.h"
+
+#include <boost/noncopyable.hpp>
+
+#include <mutex>
+#include <string>
+
+class SerializeBuffer;
+
+/**
+ * Compress the payload of the messages exchanged between processes.
+ *
+ * Only messages larger than a configurable threshold are compressed, and only
+ * if compression actually reduces their size. LZ4 is used when available,
+ * otherwise zlib at its fastest level.
+ *
+ * The statistics are thread-safe, the other methods are not.
+ */
+class MessageCompressor : public boost::noncopyable
+{
+public:
+    /** Compression statistics. */
+    struct Statistics
+    {
+        Statistics();
+
+        /** Number of messages processed. */
+        size_t count;
+
+        /** Number of messages which were (de)compressed. */
+        size_t compressed;
+
+        /** Total size of the messages before compression. */
+        size_t uncompressedBytes;
+
+        /** Total size of the messages after compression. */
+        size_t compressedBytes;
+
+        /** Total time spent (de)compressing in milliseconds. */
+        double timeMs;
+
+        /** @return the ratio uncompressedBytes / compressedBytes. */
+        double getRatio() const;
+    };
+
+    /** Default minimum size of the messages to compress. */
+    static const size_t DEFAULT_THRESHOLD;
+
+    /** Constructor. */
+    MessageCompressor();
+
+    /** @return the best compression algorithm available in this build. */
+    static MPICompression getDefaultAlgorithm();
+
+    /**
+     * Set the minimum size of the messages to compress.
+     * @param threshold The size in bytes, 0 to disable compression.
+     */
+    void setThreshold( size_t threshold );
+
+    /** @return the minimum size of the messages to compress. */
+    size_t getThreshold() const;
+
+    /**
+     * Compress a message if it is larger than the threshold.
+     * @param data The message, replaced by its compressed version.
+     * @return the algorithm used, MPI_COMPRESSION_NONE if data is unchanged.
+     */
+    MPICompression compress( std::string& data );
+
+    /**
+     * Decompress a message.
+     * @param header The header of the message
+     * @param data The compressed payload, of size header.size
+     * @param output The buffer for the uncompressed payload
+     * @throw std::runtime_error if the data is invalid
+     */
+    void decompress( const MPIHeader& header, const char* data,
+                     SerializeBuffer& output );
+
+    /** Get the statistics since the last call to resetStatistics(). */
+    Statistics getStatistics() const;
+
+    /** Reset the statistics. */
+    void resetStatistics();
+
+private:
+    size_t _threshold;
+    std::string _buffer;
+
+    mutable std::mutex _mutex;
+    Statistics _statistics;
+
+    void _record( size_t uncompressedSize, size_t compressedSize,
+                  double timeMs );
+};
+
+#endif // MESSAGECOMPRESSOR_H
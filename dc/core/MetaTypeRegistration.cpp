@@ -41,6 +41,7 @@
 #include "types.h"
 
 #include "ContentWindow.h"
+#include "Metrics.h"
 #include "MPIHeader.h"
 
 #include <QMetaType>
@@ -59,6 +60,7 @@ struct MetaTypeRegistration
         qRegisterMetaType< ContentWindow::WindowState >( "ContentWindow::WindowState" );
         qRegisterMetaType< ContentWindow::WindowBorder >( "ContentWindow::WindowBorder" );
         qRegisterMetaType< MPIMessageType >( "MPIMessageType" );
+        qRegisterMetaType< ProcessMetrics >( "ProcessMetrics" );
         qRegisterMetaType< std::string >( "std::string" );
         qRegisterMetaType< QUuid >( "QUuid" );
         qRegisterMetaTypeStreamOperators< QUuid >( "QUuid" );
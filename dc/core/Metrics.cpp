@@ -0,0 +1,182 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+#include "Metrics.h"
+
+#include <algorithm>
+#include <mutex>
+
+namespace
+{
+// Bucket bounds in milliseconds, around the frame periods of 60, 30 and 20 Hz
+const double BUCKET_BOUNDS[] = { 1.0, 2.0, 5.0, 10.0, 16.7, 20.0, 33.3, 50.0,
+                                 100.0, 250.0, 500.0, 1000.0 };
+
+struct RecordedDurations
+{
+    RecordedDurations() : skippedFrames( 0 ), supersededFrames( 0 ) {}
+
+    std::mutex mutex;
+    DurationHistogram frameTimes;
+    DurationHistogram decodeTimes;
+    DurationHistogram uploadTimes;
+    DurationHistogram gpuWaitTimes;
+    DurationHistogram wakeTimes;
+    DurationHistogram controlQueueTimes;
+    DurationHistogram streamQueueTimes;
+    uint64_t skippedFrames;
+    uint64_t supersededFrames;
+};
+
+RecordedDurations& getRecordedDurations()
+{
+    static RecordedDurations durations;
+    return durations;
+}
+
+void record( DurationHistogram RecordedDurations::*histogram,
+             const double milliseconds )
+{
+    RecordedDurations& durations = getRecordedDurations();
+    const std::lock_guard< std::mutex > lock( durations.mutex );
+    (durations.*histogram).add( milliseconds );
+}
+}
+
+DurationHistogram::DurationHistogram()
+    : counts( getBounds().size() + 1, 0 )
+    , count( 0 )
+    , sum( 0.0 )
+{
+}
+
+const std::vector< double >& DurationHistogram::getBounds()
+{
+    static const std::vector< double > bounds( std::begin( BUCKET_BOUNDS ),
+                                               std::end( BUCKET_BOUNDS ));
+    return bounds;
+}
+
+void DurationHistogram::add( const double milliseconds )
+{
+    const std::vector< double >& bounds = getBounds();
+    const size_t bucket = std::lower_bound( bounds.begin(), bounds.end(),
+                                            milliseconds ) - bounds.begin();
+    ++counts[bucket];
+    ++count;
+    sum += milliseconds;
+}
+
+ProcessMetrics::ProcessMetrics()
+    : rank( 0 )
+    , textureMemory( 0 )
+    , queueDepth( 0 )
+    , skippedFrames( 0 )
+    , supersededFrames( 0 )
+    , cpuTime( 0.0 )
+    , uploadBacklog( 0 )
+    , maxUploadFrameTime( 0.0 )
+    , memoryBudget( 0 )
+    , evictions( 0 )
+{
+}
+
+void Metrics::recordFrameTime( const double milliseconds )
+{
+    record( &RecordedDurations::frameTimes, milliseconds );
+}
+
+void Metrics::recordDecodeTime( const double milliseconds )
+{
+    record( &RecordedDurations::decodeTimes, milliseconds );
+}
+
+void Metrics::recordUploadTime( const double milliseconds )
+{
+    record( &RecordedDurations::uploadTimes, milliseconds );
+}
+
+void Metrics::recordGPUWaitTime( const double milliseconds )
+{
+    record( &RecordedDurations::gpuWaitTimes, milliseconds );
+}
+
+void Metrics::recordWakeTime( const double milliseconds )
+{
+    record( &RecordedDurations::wakeTimes, milliseconds );
+}
+
+void Metrics::recordSkippedFrame()
+{
+    RecordedDurations& durations = getRecordedDurations();
+    const std::lock_guard< std::mutex > lock( durations.mutex );
+    ++durations.skippedFrames;
+}
+
+void Metrics::recordControlQueueTime( const double milliseconds )
+{
+    record( &RecordedDurations::controlQueueTimes, milliseconds );
+}
+
+void Metrics::recordStreamQueueTime( const double milliseconds )
+{
+    record( &RecordedDurations::streamQueueTimes, milliseconds );
+}
+
+void Metrics::recordSupersededFrame()
+{
+    RecordedDurations& durations = getRecordedDurations();
+    const std::lock_guard< std::mutex > lock( durations.mutex );
+    ++durations.supersededFrames;
+}
+
+void Metrics::getDurations( ProcessMetrics& metrics )
+{
+    RecordedDurations& durations = getRecordedDurations();
+    const std::lock_guard< std::mutex > lock( durations.mutex );
+    metrics.frameTimes = durations.frameTimes;
+    metrics.decodeTimes = durations.decodeTimes;
+    metrics.uploadTimes = durations.uploadTimes;
+    metrics.gpuWaitTimes = durations.gpuWaitTimes;
+    metrics.wakeTimes = durations.wakeTimes;
+    metrics.controlQueueTimes = durations.controlQueueTimes;
+    metrics.streamQueueTimes = durations.streamQueueTimes;
+    metrics.skippedFrames = durations.skippedFrames;
+    metrics.supersededFrames = durations.supersededFrames;
+}
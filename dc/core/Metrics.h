@@ -0,0 +1,258 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <QMetaType>
+
+#include <boost/noncopyable.hpp>
+#include <boost/serialization/map.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <chrono>
+#include <map>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/**
+ * A histogram of durations with fixed buckets, in the layout of a Prometheus
+ * histogram.
+ */
+struct DurationHistogram
+{
+    /** Create an empty histogram. */
+    DurationHistogram();
+
+    /**
+     * The upper bounds of the buckets in milliseconds, in increasing order.
+     * An additional last bucket counts the values above the largest bound.
+     */
+    static const std::vector< double >& getBounds();
+
+    /** Add a duration to the histogram. */
+    void add( double milliseconds );
+
+    /** Number of values in each bucket, of size getBounds().size() + 1 */
+    std::vector< uint64_t > counts;
+
+    /** Total number of values. */
+    uint64_t count;
+
+    /** Sum of the values in milliseconds. */
+    double sum;
+
+    template< class Archive >
+    void serialize( Archive& ar, const unsigned int )
+    {
+        ar & counts;
+        ar & count;
+        ar & sum;
+    }
+};
+
+/**
+ * The performance metrics of one process, periodically reported by the
+ * walls to the master application.
+ *
+ * Histograms are cumulative since the start of the process.
+ */
+struct ProcessMetrics
+{
+    /** Constructor. */
+    ProcessMetrics();
+
+    /** The MPI rank of the process. */
+    int rank;
+
+    /** Time between the start of two consecutive frames. */
+    DurationHistogram frameTimes;
+
+    /** Time spent decoding movie frames and images. */
+    DurationHistogram decodeTimes;
+
+    /** Time spent uploading textures to the GPU. */
+    DurationHistogram uploadTimes;
+
+    /** Time spent waiting for the GPU to complete the previous frames. */
+    DurationHistogram gpuWaitTimes;
+
+    /** Time for idle processes to resume rendering after a change. */
+    DurationHistogram wakeTimes;
+
+    /** Time control messages wait in the send queue of the master. */
+    DurationHistogram controlQueueTimes;
+
+    /** Time pixel stream frames wait in the send queue of the master. */
+    DurationHistogram streamQueueTimes;
+
+    /** The frame rate of each pixel stream, indexed by uri. */
+    std::map< std::string, double > streamsFps;
+
+    /** The GPU memory allocated for textures, in bytes. */
+    uint64_t textureMemory;
+
+    /** Number of messages or frames waiting to be processed. */
+    uint64_t queueDepth;
+
+    /** Number of frames skipped because nothing changed on the wall. */
+    uint64_t skippedFrames;
+
+    /** Number of pixel stream frames superseded before the master sent them. */
+    uint64_t supersededFrames;
+
+    /** CPU time used by the process, in seconds. */
+    double cpuTime;
+
+    /** Number of texture uploads postponed to the next frame. */
+    uint64_t uploadBacklog;
+
+    /** Longest time spent uploading in a frame since the last report, in ms. */
+    double maxUploadFrameTime;
+
+    /** Memory used by the contents of each window, indexed by window id. */
+    std::map< std::string, uint64_t > windowsMemory;
+
+    /** Memory used by the contents of each type, indexed by type name. */
+    std::map< std::string, uint64_t > contentTypesMemory;
+
+    /** The memory budget of the contents, in bytes. */
+    uint64_t memoryBudget;
+
+    /** Number of contents evicted to stay within the memory budget. */
+    uint64_t evictions;
+
+    template< class Archive >
+    void serialize( Archive& ar, const unsigned int )
+    {
+        ar & rank;
+        ar & frameTimes;
+        ar & decodeTimes;
+        ar & uploadTimes;
+        ar & gpuWaitTimes;
+        ar & wakeTimes;
+        ar & controlQueueTimes;
+        ar & streamQueueTimes;
+        ar & streamsFps;
+        ar & textureMemory;
+        ar & queueDepth;
+        ar & skippedFrames;
+        ar & supersededFrames;
+        ar & cpuTime;
+        ar & uploadBacklog;
+        ar & maxUploadFrameTime;
+        ar & windowsMemory;
+        ar & contentTypesMemory;
+        ar & memoryBudget;
+        ar & evictions;
+    }
+};
+
+/**
+ * Record the durations reported in the ProcessMetrics of this process.
+ *
+ * This class is thread-safe.
+ */
+class Metrics
+{
+public:
+    /** Record the time between the start of two frames. */
+    static void recordFrameTime( double milliseconds );
+
+    /** Record the time spent decoding a movie frame or an image. */
+    static void recordDecodeTime( double milliseconds );
+
+    /** Record the time spent uploading a texture. */
+    static void recordUploadTime( double milliseconds );
+
+    /** Record the time spent waiting for the GPU at the end of a frame. */
+    static void recordGPUWaitTime( double milliseconds );
+
+    /**
+     * Record the time between a change seen by an idle process and the
+     * moment all the processes resumed rendering.
+     */
+    static void recordWakeTime( double milliseconds );
+
+    /** Record a frame which was not rendered because nothing changed. */
+    static void recordSkippedFrame();
+
+    /** Record the time a control message waited before being sent. */
+    static void recordControlQueueTime( double milliseconds );
+
+    /** Record the time a pixel stream frame waited before being sent. */
+    static void recordStreamQueueTime( double milliseconds );
+
+    /** Record a pixel stream frame replaced by a newer one before sending. */
+    static void recordSupersededFrame();
+
+    /** Copy the values recorded so far into the given metrics. */
+    static void getDurations( ProcessMetrics& metrics );
+};
+
+/**
+ * Record the duration of the enclosing scope with one of the Metrics
+ * functions, for instance Metrics::recordUploadTime.
+ */
+class ScopedDuration : public boost::noncopyable
+{
+public:
+    typedef void (*RecordFunction)( double );
+
+    explicit ScopedDuration( RecordFunction record )
+        : _record( record )
+        , _start( std::chrono::steady_clock::now( ))
+    {}
+
+    ~ScopedDuration()
+    {
+        const std::chrono::duration< double, std::milli > elapsed =
+                std::chrono::steady_clock::now() - _start;
+        _record( elapsed.count( ));
+    }
+
+private:
+    const RecordFunction _record;
+    const std::chrono::steady_clock::time_point _start;
+};
+
+Q_DECLARE_METATYPE( ProcessMetrics )
+
+#endif // METRICS_H
@@ -46,26 +46,47 @@
 #include "MovieContent.h"
 #include "WallToWallChannel.h"
 
+#include <boost/bind.hpp>
+
 Movie::Movie( const QString& uri )
-    : _ffmpegMovie( new FFMPEGMovie( uri ))
+    : _uri( uri )
     , _paused( false )
     , _loop( true )
-    , _isVisible( true )
+    , _isVisible( false )
+    , _textureUpdated( false )
     , _sharedTimestamp( 0.0 )
 {
+}
+
+Movie::~Movie() {}
+
+void Movie::setLoaded( const bool loaded )
+{
+    if( loaded == bool( _ffmpegMovie ))
+        return;
+
+    if( !loaded )
+    {
+        _texture.free();
+        _futurePicture = std::future<PicturePtr>();
+        _ffmpegMovie.reset();
+        _isVisible = false;
+        return;
+    }
+
+    _ffmpegMovie.reset( new FFMPEGMovie( _uri ));
+
     // Observed bug [DISCL-295]: opening a movie might fail on WallProcesses
     // despite correctly reading metadata on the MasterProcess.
     // bool FFMPEGMovie::openVideoStreamDecoder(): could not open codec
     // error: -11 Resource temporarily unavailable
     if( !_ffmpegMovie->isValid( ))
         put_flog( LOG_WARN, "Movie is invalid: %s",
-                  uri.toLocal8Bit().constData( ));
+                  _uri.toLocal8Bit().constData( ));
     else
         _ffmpegMovie->startDecoding();
 }
 
-Movie::~Movie() {}
-
 void Movie::setVisible( const bool isVisible )
 {
     _isVisible = isVisible;
@@ -97,31 +118,32 @@ void Movie::renderPreview()
     _previewQuad.render();
 }
 
-void Movie::preRenderUpdate( ContentWindowPtr window, const QRect& wallArea )
+void Movie::preRenderUpdate( ContentWindowPtr window,
+                             const QRegion& wallArea )
 {
-    if( !_ffmpegMovie->isValid( ))
+    MovieContent& movie = static_cast<MovieContent&>( *window->getContent( ));
+    setPause( movie.getControlState() & STATE_PAUSED );
+    setLoop( movie.getControlState() & STATE_LOOP );
+
+    // Processes which do not decode the movie keep following the timestamp
+    setVisible( _isLoaded() && _isVisibleIn( wallArea ));
+    if( !_isLoaded( ))
         return;
 
-    if( !_texture.isValid( ))
+    if( !_texture.isValid() && _isVisible )
     {
-        _generateTexture();
-        _quad.setTexture( _texture.getTextureId( ));
-        _previewQuad.setTexture( _texture.getTextureId( ));
+        const size_t size = _ffmpegMovie->getWidth() *
+                            _ffmpegMovie->getHeight() * 4;
+        _scheduleUpload( *window, wallArea, size,
+                         boost::bind( &Movie::_generateTexture, this ));
     }
 
     _quad.setTexCoords( window->getZoomRect( ));
-
-    MovieContent& movie = static_cast<MovieContent&>( *window->getContent( ));
-    setPause( movie.getControlState() & STATE_PAUSED );
-    setLoop( movie.getControlState() & STATE_LOOP );
-
-    setVisible( QRectF( wallArea ).intersects( _qmlItem->getSceneRect( )));
 }
 
 void Movie::preRenderSync( WallToWallChannel& wallToWallChannel )
 {
-    if( !_ffmpegMovie->isValid( ))
-        return;
+    _textureUpdated = false;
 
     if( !_paused )
     {
@@ -132,11 +154,14 @@ void Movie::preRenderSync( WallToWallChannel& wallToWallChannel )
     if( !_isVisible )
         return;
 
-    if( _futurePicture.valid() && is_ready( _futurePicture ))
+    // Keep the decoded frame until the texture has been created
+    if( _texture.isValid() && _futurePicture.valid() &&
+        is_ready( _futurePicture ))
     {
         try
         {
             _texture.update( _futurePicture.get()->getData(), GL_RGBA );
+            _textureUpdated = true;
         }
         catch( const std::exception& e )
         {
@@ -153,13 +178,41 @@ void Movie::preRenderSync( WallToWallChannel& wallToWallChannel )
         _futurePicture = _ffmpegMovie->getFrame( _sharedTimestamp );
 }
 
+bool Movie::isModified()
+{
+    if( !_isVisible )
+        return false;
+
+    return !_paused || _textureUpdated || _futurePicture.valid();
+}
+
+size_t Movie::getMemoryUsage() const
+{
+    return _texture.getMemorySize();
+}
+
+void Movie::releaseMemory()
+{
+    _texture.free();
+}
+
+bool Movie::_isLoaded() const
+{
+    return _ffmpegMovie && _ffmpegMovie->isValid();
+}
+
 bool Movie::_generateTexture()
 {
     QImage image( _ffmpegMovie->getWidth(), _ffmpegMovie->getHeight(),
                   QImage::Format_RGB32 );
     image.fill( 0 );
 
-    return _texture.init( image );
+    if( !_texture.init( image ))
+        return false;
+
+    _quad.setTexture( _texture.getTextureId( ));
+    _previewQuad.setTexture( _texture.getTextureId( ));
+    return true;
 }
 
 double Movie::_getDelay() const
@@ -172,8 +225,9 @@ void Movie::_updateTimestamp( WallToWallChannel& wallToWallChannel )
     _timer.setCurrentTime( wallToWallChannel.getTime( ));
 
     // Don't increment the timestamp until all the processes have caught up
-    const bool isInSync = _getDelay() <= _ffmpegMovie->getFrameDuration();
-    if( !wallToWallChannel.allReady( !_isVisible || isInSync ))
+    const bool isInSync = !_isVisible ||
+                          _getDelay() <= _ffmpegMovie->getFrameDuration();
+    if( !wallToWallChannel.allReady( isInSync ))
         return;
 
     _sharedTimestamp += ElapsedTimer::toSeconds( _timer.getElapsedTime( ));
@@ -182,8 +236,7 @@ void Movie::_updateTimestamp( WallToWallChannel& wallToWallChannel )
 void Movie::_synchronizeTimestamp( WallToWallChannel& wallToWallChannel )
 {
     // Elect a leader among processes which have decoded a frame
-    const bool isCandidate = _ffmpegMovie->isValid() && _isVisible;
-    const int leader = wallToWallChannel.electLeader( isCandidate );
+    const int leader = wallToWallChannel.electLeader( _isVisible );
 
     if( leader < 0 )
         return;
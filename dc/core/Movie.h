@@ -49,18 +49,28 @@
 
 class FFMPEGMovie;
 
+/**
+ * A movie rendered on the Wall.
+ *
+ * The movie is decoded only by the processes which load it, but all of them
+ * share the same timestamp so that the movie is in sync when it appears on
+ * other screens.
+ */
 class Movie : public WallContent
 {
 public:
     Movie( const QString& uri );
     ~Movie();
 
+    void setLoaded( bool loaded ) override;
+
     void setVisible( bool isVisible );
 
     void setPause( bool pause );
     void setLoop( bool loop );
 
 private:
+    QString _uri;
     std::unique_ptr<FFMPEGMovie> _ffmpegMovie;
 
     GLTexture2D _texture;
@@ -70,6 +80,7 @@ private:
     bool _paused;
     bool _loop;
     bool _isVisible;
+    bool _textureUpdated;
 
     ElapsedTimer _timer;
     double _sharedTimestamp;
@@ -78,9 +89,13 @@ private:
     void render() override;
     void renderPreview() override;
     void preRenderUpdate( ContentWindowPtr window,
-                          const QRect& wallArea ) override;
+                          const QRegion& wallArea ) override;
     void preRenderSync( WallToWallChannel& wallToWallChannel ) override;
+    bool isModified() override;
+    size_t getMemoryUsage() const override;
+    void releaseMemory() override;
 
+    bool _isLoaded() const;
     bool _generateTexture();
 
     double _getDelay() const;
@@ -0,0 +1,173 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+#include "OffscreenRenderer.h"
+
+#include "FpsRenderer.h"
+#include "TestPattern.h"
+#include "log.h"
+
+#include <QGraphicsScene>
+#include <QOpenGLFramebufferObject>
+#include <QOpenGLPaintDevice>
+#include <QPainter>
+
+#include <stdexcept>
+
+struct OffscreenRenderer::Screen
+{
+    QRect sceneRect;
+    QPoint globalIndex;
+    TestPatternPtr testPattern;
+    FpsRenderer fpsRenderer;
+    std::unique_ptr< QOpenGLFramebufferObject > fbo;
+};
+
+OffscreenRenderer::OffscreenRenderer( QGraphicsScene& scene )
+    : _scene( scene )
+    , _frameIndex( 0 )
+{
+    QSurfaceFormat format;
+    format.setDepthBufferSize( 24 );
+    format.setStencilBufferSize( 8 );
+    // Contents are rendered with the fixed-function pipeline
+    format.setProfile( QSurfaceFormat::CompatibilityProfile );
+
+    _surface.setFormat( format );
+    _surface.create();
+    _context.setFormat( format );
+    if( !_surface.isValid() || !_context.create() ||
+        !_context.makeCurrent( &_surface ))
+    {
+        throw std::runtime_error( "Could not create an offscreen OpenGL "
+                                  "context" );
+    }
+}
+
+OffscreenRenderer::~OffscreenRenderer()
+{
+    _context.makeCurrent( &_surface );
+    _screens.clear();
+    _context.doneCurrent();
+}
+
+void OffscreenRenderer::addScreen( const QRect& sceneRect,
+                                   const QPoint& globalIndex,
+                                   TestPatternPtr testPattern )
+{
+    _context.makeCurrent( &_surface );
+
+    QOpenGLFramebufferObjectFormat format;
+    format.setAttachment( QOpenGLFramebufferObject::CombinedDepthStencil );
+
+    std::unique_ptr< Screen > screen( new Screen );
+    screen->sceneRect = sceneRect;
+    screen->globalIndex = globalIndex;
+    screen->testPattern = testPattern;
+    screen->fbo.reset( new QOpenGLFramebufferObject( sceneRect.size(),
+                                                     format ));
+    if( !screen->fbo->isValid( ))
+        throw std::runtime_error( "Could not create an offscreen framebuffer" );
+
+    _screens.push_back( std::move( screen ));
+}
+
+void OffscreenRenderer::render()
+{
+    _context.makeCurrent( &_surface );
+
+    for( const auto& screen : _screens )
+    {
+        screen->fbo->bind();
+        {
+            QOpenGLPaintDevice device( screen->sceneRect.size( ));
+            QPainter painter( &device );
+
+            _scene.render( &painter, QRectF( QPointF(),
+                                             screen->sceneRect.size( )),
+                           screen->sceneRect );
+
+            // Same overlays as WallWindow::drawForeground, in scene coordinates
+            painter.translate( -screen->sceneRect.topLeft( ));
+            if( screen->testPattern && screen->testPattern->isVisible( ))
+                screen->testPattern->draw( &painter, screen->sceneRect );
+            else if( screen->fpsRenderer.isVisible( ))
+                screen->fpsRenderer.draw( &painter, screen->sceneRect );
+        }
+        screen->fbo->release();
+    }
+}
+
+void OffscreenRenderer::finishFrame()
+{
+    ++_frameIndex;
+    if( _dumpFolder.isEmpty( ))
+        return;
+
+    _context.makeCurrent( &_surface );
+    for( const auto& screen : _screens )
+    {
+        const QString filename = QString( "%1/frame_%2_screen_%3_%4.png" )
+                .arg( _dumpFolder ).arg( _frameIndex, 6, 10, QChar( '0' ))
+                .arg( screen->globalIndex.x( )).arg( screen->globalIndex.y( ));
+        if( !screen->fbo->toImage().save( filename ))
+            put_flog( LOG_WARN, "could not save frame: '%s'",
+                      filename.toLocal8Bit().constData( ));
+    }
+}
+
+void OffscreenRenderer::setFrameDumpFolder( const QString& folder )
+{
+    _dumpFolder = folder;
+}
+
+void OffscreenRenderer::setShowFps( const bool value )
+{
+    for( const auto& screen : _screens )
+        screen->fpsRenderer.setVisible( value );
+}
+
+void OffscreenRenderer::displayTestPattern( const bool value )
+{
+    for( const auto& screen : _screens )
+    {
+        if( screen->testPattern )
+            screen->testPattern->setVisible( value );
+    }
+}
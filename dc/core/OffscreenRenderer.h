@@ -0,0 +1,126 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+#ifndef OFFSCREENRENDERER_H
+#define OFFSCREENRENDERER_H
+
+#include "types.h"
+
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QRect>
+#include <QString>
+
+#include <boost/noncopyable.hpp>
+
+#include <memory>
+#include <vector>
+
+class QGraphicsScene;
+class QOpenGLFramebufferObject;
+
+/**
+ * Render the screens of a wall process without any window.
+ *
+ * Each screen is rendered into a framebuffer object of a single offscreen
+ * OpenGL context, so that all the screens share their textures. The context
+ * is provided by the Qt platform plugin, for instance a GLX or EGL pbuffer
+ * surface with Mesa on a machine without a display.
+ *
+ * The rendered frames can optionally be saved to disk as images.
+ */
+class OffscreenRenderer : public boost::noncopyable
+{
+public:
+    /**
+     * Create the offscreen OpenGL context and make it current.
+     * @param scene The scene to render
+     * @throw std::runtime_error if the context could not be created.
+     */
+    OffscreenRenderer( QGraphicsScene& scene );
+
+    /** Destructor. */
+    ~OffscreenRenderer();
+
+    /**
+     * Add a screen to render.
+     * @param sceneRect The portion of the scene rendered on the screen
+     * @param globalIndex The index of the screen on the wall, for the images
+     * @param testPattern The test pattern of the screen
+     */
+    void addScreen( const QRect& sceneRect, const QPoint& globalIndex,
+                    TestPatternPtr testPattern );
+
+    /**
+     * Render the scene in the framebuffer of each screen.
+     * The GL commands are only submitted, the offscreen context is left
+     * current so that the caller can wait for them with a GLFrameSync.
+     */
+    void render();
+
+    /**
+     * Finish the frame, saving the framebuffers if setFrameDumpFolder() was
+     * called.
+     */
+    void finishFrame();
+
+    /**
+     * Save the rendered frames as images in the given folder.
+     * @param folder The destination folder, or an empty string to disable
+     */
+    void setFrameDumpFolder( const QString& folder );
+
+    /** Show or hide the fps counter. */
+    void setShowFps( bool value );
+
+    /** Display or hide the test pattern. */
+    void displayTestPattern( bool value );
+
+private:
+    struct Screen;
+
+    QGraphicsScene& _scene;
+    QOffscreenSurface _surface;
+    QOpenGLContext _context;
+    std::vector< std::unique_ptr< Screen >> _screens;
+    QString _dumpFolder;
+    uint64_t _frameIndex;
+};
+
+#endif // OFFSCREENRENDERER_H
@@ -54,6 +54,8 @@
 #include "PDFContent.h"
 #include "log.h"
 
+#include <boost/bind.hpp>
+
 namespace
 {
 const int INVALID_PAGE_NUMBER = -1;
@@ -130,9 +132,9 @@ QImage PDF::renderToImage( const QSize& imageSize, const QRectF& region ) const
                                     imageSize.width(), imageSize.height( ));
 }
 
-const QSize& PDF::getTextureSize() const
+QSize PDF::getTextureSize() const
 {
-    return texture_.getSize();
+    return texture_ ? texture_->getSize() : QSize();
 }
 
 const QRectF& PDF::getTextureRegion() const
@@ -140,8 +142,19 @@ const QRectF& PDF::getTextureRegion() const
     return textureRect_;
 }
 
+QString PDF::getTextureKey( const QSize& textureSize,
+                           const QRectF& pdfRegion ) const
+{
+    const QString page = QString( "%1#%2" ).arg( filename_ ).arg( pageNumber_ );
+    return ContentCache::makeKey( page, textureSize, pdfRegion );
+}
+
 void PDF::updateTexture( const QSize& textureSize, const QRectF& pdfRegion )
 {
+    // Another window may have rendered the same texture in the meantime
+    if( findSharedTexture( textureSize, pdfRegion ))
+        return;
+
     const QImage image = renderToImage( textureSize, pdfRegion );
 
     if( image.isNull( ))
@@ -151,22 +164,43 @@ void PDF::updateTexture( const QSize& textureSize, const QRectF& pdfRegion )
         return;
     }
 
-    texture_.update( image, GL_BGRA );
+    // The texture may be shared with other windows, so a new one is created
+    // instead of updating it in place.
+    texture_.reset( new GLTexture2D );
+    texture_->init( image, GL_BGRA );
+    textureRect_ = pdfRegion;
+    _share( getTextureKey( textureSize, pdfRegion ), texture_ );
+}
+
+bool PDF::findSharedTexture( const QSize& textureSize, const QRectF& pdfRegion )
+{
+    boost::shared_ptr<GLTexture2D> texture =
+            _findShared<GLTexture2D>( getTextureKey( textureSize, pdfRegion ));
+    if( !texture )
+        return false;
+
+    texture_ = texture;
     textureRect_ = pdfRegion;
+    return true;
 }
 
 void PDF::render()
 {
-    if( !texture_.isValid( ))
+    if( !texture_ )
         return;
 
-    quad_.setTexture( texture_.getTextureId( ));
+    quad_.setTexture( texture_->getTextureId( ));
     quad_.render();
 }
 
 void PDF::renderPreview()
 {
-    if( !texturePreview_.isValid( ))
+    if( !texturePreview_ )
+    {
+        const QString key = getTextureKey( PREVIEW_SIZE, UNIT_RECTF );
+        texturePreview_ = _findShared<GLTexture2D>( key );
+    }
+    if( !texturePreview_ )
     {
         const QImage image = renderToImage( PREVIEW_SIZE );
         if( image.isNull( ))
@@ -174,10 +208,12 @@ void PDF::renderPreview()
             put_flog( LOG_ERROR, "Could not render document preview for: '%s'",
                       filename_.toLocal8Bit().constData( ));
         }
-        texturePreview_.update( image, GL_BGRA );
+        texturePreview_.reset( new GLTexture2D );
+        texturePreview_->update( image, GL_BGRA );
+        _share( getTextureKey( PREVIEW_SIZE, UNIT_RECTF ), texturePreview_ );
     }
 
-    quad_.setTexture( texturePreview_.getTextureId( ));
+    quad_.setTexture( texturePreview_->getTextureId( ));
     quad_.render();
 }
 
@@ -227,21 +263,47 @@ bool PDF::isValid( const int pageNumber ) const
     return pageNumber >=0 && pageNumber < pdfDoc_->numPages();
 }
 
-void PDF::preRenderUpdate( ContentWindowPtr window, const QRect& /*wallArea*/ )
+void PDF::preRenderUpdate( ContentWindowPtr window, const QRegion& wallArea )
 {
     if( window->isResizing() || _qmlItem->isAnimating( ))
         return;
 
+    if( !_isVisibleIn( wallArea ))
+        return;
+
     PDFContent& content = static_cast<PDFContent&>( *window->getContent( ));
 
     const bool pageHasChanged = (pageNumber_ != content.getPage( ));
     setPage( content.getPage( ));
 
     const QSize& renderSize = _qmlItem->getSceneRect().size().toSize();
-    if( pageHasChanged || texture_.getSize() != renderSize ||
+    if( pageHasChanged || getTextureSize() != renderSize ||
         textureRect_ != window->getZoomRect( ) )
     {
-        updateTexture( renderSize, window->getZoomRect( ));
+        if( findSharedTexture( renderSize, window->getZoomRect( )))
+            return;
+
+        const size_t size = renderSize.width() * renderSize.height() * 4;
+        _scheduleUpload( *window, wallArea, size,
+                         boost::bind( &PDF::updateTexture, this, renderSize,
+                                      window->getZoomRect( )));
     }
 }
 
+
+size_t PDF::getMemoryUsage() const
+{
+    size_t usage = 0;
+    if( texture_ )
+        usage += texture_->getMemorySize() / texture_.use_count();
+    if( texturePreview_ )
+        usage += texturePreview_->getMemorySize() / texturePreview_.use_count();
+    return usage;
+}
+
+void PDF::releaseMemory()
+{
+    texture_.reset();
+    texturePreview_.reset();
+    textureRect_ = QRectF();
+}
@@ -77,8 +77,8 @@ private:
     int pageNumber_;
     QString filename_;
 
-    GLTexture2D texture_;
-    GLTexture2D texturePreview_;
+    boost::shared_ptr<GLTexture2D> texture_;
+    boost::shared_ptr<GLTexture2D> texturePreview_;
     GLQuad quad_;
     QRectF textureRect_;
 
@@ -87,13 +87,19 @@ private:
     void closePage();
     bool isValid( const int pageNumber ) const;
 
-    const QSize& getTextureSize() const;
+    QSize getTextureSize() const;
     const QRectF& getTextureRegion() const;
+    QString getTextureKey( const QSize& textureSize,
+                           const QRectF& pdfRegion ) const;
     void updateTexture( const QSize& textureSize, const QRectF& pdfRegion );
+    bool findSharedTexture( const QSize& textureSize,
+                            const QRectF& pdfRegion );
     void render() override;
     void renderPreview() override;
     void preRenderUpdate( ContentWindowPtr window,
-                          const QRect& wallArea ) override;
+                          const QRegion& wallArea ) override;
+    size_t getMemoryUsage() const override;
+    void releaseMemory() override;
 };
 
 #endif // PDF_H
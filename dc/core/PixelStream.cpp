@@ -41,8 +41,10 @@
 #include "ContentWindow.h"
 #include "WallToWallChannel.h"
 #include "log.h"
+#include "PixelStreamContent.h"
 #include "PixelStreamSegmentRenderer.h"
 #include "FpsCounter.h"
+#include "Profiler.h"
 
 #include <deflect/Frame.h>
 #include <deflect/SegmentDecoder.h>
@@ -59,6 +61,8 @@ PixelStream::PixelStream( const QString& uri )
     , width_( 0 )
     , height_ ( 0 )
     , buffersSwapped_( false )
+    , modified_( false )
+    , pixelFormat_( deflect::RGBA )
 {
 }
 
@@ -77,6 +81,11 @@ QString PixelStream::getStatistics() const
     return fpsCounter_.toString();
 }
 
+float PixelStream::getFps() const
+{
+    return fpsCounter_.getFps();
+}
+
 QList<QObject*> PixelStream::getSegments() const
 {
     return segmentsList_;
@@ -87,11 +96,14 @@ void PixelStream::render()
     glPushMatrix();
     glScalef( 1.f/(float)width_, 1.f/(float)height_, 0.f );
 
+    // Only draw the segments visible on the screen being rendered
+    const QRectF& screenArea = _qmlItem->getExposedSceneRect();
     BOOST_FOREACH( PixelStreamSegmentRendererPtr renderer, segmentRenderers_ )
     {
-        if( isVisible( renderer->getRect( )))
-            renderer->render();
+        if( screenArea.intersects( getSceneCoordinates( renderer->getRect( ))))
+            renderer->render( quadBatch_ );
     }
+    quadBatch_.render();
 
     glPopMatrix();
 }
@@ -101,15 +113,22 @@ void PixelStream::renderPreview()
     // PixelStreams don't support zooming and don't have previews
 }
 
-void PixelStream::preRenderUpdate( ContentWindowPtr, const QRect& wallArea )
+void PixelStream::preRenderUpdate( ContentWindowPtr window,
+                                   const QRegion& wallArea )
 {
+    const PixelStreamContent& content =
+            static_cast<const PixelStreamContent&>( *window->getContent( ));
+    pixelFormat_ = content.getPixelFormat();
+
     sceneRect_ = _qmlItem->getSceneRect();
     wallArea_ = wallArea;
 }
 
 void PixelStream::preRenderSync( WallToWallChannel& wallToWallChannel )
 {
-    if( isDecodingInProgress( wallToWallChannel ))
+    // Keep rendering until the decoded frame can be uploaded
+    modified_ = isDecodingInProgress( wallToWallChannel );
+    if( modified_ )
         return;
 
     // After swapping the buffers, wait until decoding has finished to update
@@ -121,25 +140,50 @@ void PixelStream::preRenderSync( WallToWallChannel& wallToWallChannel )
         recomputeDimensions( frontBuffer_ );
         refreshSegmentsList( frontBuffer_ );
         buffersSwapped_ = false;
+        modified_ = true;
     }
 
     // The window may have moved, so always check if some segments have become
     // visible to upload them.
-    updateVisibleTextures();
+    if( updateVisibleTextures( ))
+        modified_ = true;
 
     if( !backBuffer_.empty( ))
     {
         swapBuffers();
         adjustFrameDecodersCount( frontBuffer_.size( ));
+        modified_ = true;
     }
 
     // The window may have moved, so always check if some segments have become
     // visible to decode them.
-    decodeVisibleTextures();
+    if( decodeVisibleTextures( ))
+        modified_ = true;
+}
+
+bool PixelStream::isModified()
+{
+    return modified_;
+}
+
+size_t PixelStream::getMemoryUsage() const
+{
+    size_t usage = 0;
+    BOOST_FOREACH( PixelStreamSegmentRendererPtr renderer, segmentRenderers_ )
+        usage += renderer->getTextureMemory();
+    return usage;
+}
+
+void PixelStream::releaseMemory()
+{
+    BOOST_FOREACH( PixelStreamSegmentRendererPtr renderer, segmentRenderers_ )
+        renderer->releaseTexture();
 }
 
 bool PixelStream::isDecodingInProgress( WallToWallChannel& wallToWallChannel )
 {
+    PROFILE_SCOPE( "window", "isDecodingInProgress" );
+
     // determine if threads are running on any processes for this PixelStream
     int localThreadsRunning = 0;
 
@@ -166,7 +210,7 @@ void PixelStream::updateRenderers( const deflect::Segments& segments )
     }
 }
 
-void PixelStream::updateVisibleTextures()
+bool PixelStream::updateVisibleTextures()
 {
     bool textureWasUpdated = false;
     for( size_t i=0; i<frontBuffer_.size(); ++i )
@@ -181,7 +225,8 @@ void PixelStream::updateVisibleTextures()
                                          frontBuffer_[i].parameters.height,
                                          QImage::Format_RGB32 );
 
-            segmentRenderers_[i]->updateTexture( textureWrapper );
+            segmentRenderers_[i]->updateTexture( textureWrapper,
+                                                 frontBufferFormats_[i] );
 
             textureWasUpdated = true;
         }
@@ -192,6 +237,7 @@ void PixelStream::updateVisibleTextures()
         fpsCounter_.tick();
         emit statisticsChanged();
     }
+    return textureWasUpdated;
 }
 
 void PixelStream::swapBuffers()
@@ -201,6 +247,15 @@ void PixelStream::swapBuffers()
     frontBuffer_ = backBuffer_;
     backBuffer_.clear();
 
+    // Compressed segments are always decoded to RGBA, the others are uploaded
+    // as sent by the streamer.
+    frontBufferFormats_.resize( frontBuffer_.size( ));
+    for( size_t i = 0; i < frontBuffer_.size(); ++i )
+    {
+        frontBufferFormats_[i] = frontBuffer_[i].parameters.compressed ?
+                                     deflect::RGBA : pixelFormat_;
+    }
+
     buffersSwapped_ = true;
 }
 
@@ -217,17 +272,22 @@ void PixelStream::recomputeDimensions( const deflect::Segments &segments )
     }
 }
 
-void PixelStream::decodeVisibleTextures()
+bool PixelStream::decodeVisibleTextures()
 {
     assert( frameDecoders_.size() == frontBuffer_.size( ));
 
+    bool decodingStarted = false;
     std::vector<PixelStreamSegmentDecoderPtr>::iterator frameDecoder_it = frameDecoders_.begin();
     deflect::Segments::iterator segment_it = frontBuffer_.begin();
     for( ; segment_it != frontBuffer_.end(); ++segment_it, ++frameDecoder_it )
     {
         if( segment_it->parameters.compressed && isVisible( *segment_it ))
+        {
             (*frameDecoder_it)->startDecoding( *segment_it );
+            decodingStarted = true;
+        }
     }
+    return decodingStarted;
 }
 
 void PixelStream::adjustFrameDecodersCount( const size_t count )
@@ -295,7 +355,8 @@ QRectF PixelStream::getSceneCoordinates( const QRect& segment ) const
 
 bool PixelStream::isVisible( const QRect& segment ) const
 {
-    return wallArea_.intersects( getSceneCoordinates( segment ));
+    const QRect sceneRect = getSceneCoordinates( segment ).toAlignedRect();
+    return wallArea_.intersects( sceneRect );
 }
 
 bool PixelStream::isVisible( const deflect::Segment& segment ) const
@@ -43,7 +43,9 @@
 
 #include "types.h"
 #include "FpsCounter.h"
+#include "GLQuadBatch.h"
 
+#include <deflect/ImageWrapper.h>
 #include <deflect/Segment.h>
 
 #include <QtCore/QObject>
@@ -113,6 +115,7 @@ public:
     void setNewFrame( deflect::FramePtr frame );
 
     QString getStatistics() const;
+    float getFps() const;
     QList<QObject*> getSegments() const;
 
 signals:
@@ -133,14 +136,25 @@ private:
     deflect::Segments backBuffer_;
     bool buffersSwapped_;
 
+    // Set during preRenderSync() if the stream must be rendered again or if
+    // work is in progress which requires more frames to complete
+    bool modified_;
+
+    // The pixel format of the uncompressed segments sent by the streamer
+    deflect::PixelFormat pixelFormat_;
+
+    // The pixel format of each segment of the front buffer, once decoded
+    std::vector<deflect::PixelFormat> frontBufferFormats_;
+
     // The list of decoded images for the next frame
     std::vector<PixelStreamSegmentDecoderPtr> frameDecoders_;
 
     // For each segment, object for image parameters, decoding and rendering
     std::vector<PixelStreamSegmentRendererPtr> segmentRenderers_;
+    GLQuadBatch quadBatch_;
 
     QRectF sceneRect_;
-    QRectF wallArea_;
+    QRegion wallArea_;
 
     FpsCounter fpsCounter_;
 
@@ -149,15 +163,18 @@ private:
     void render() override;
     void renderPreview() override;
     void preRenderUpdate( ContentWindowPtr window,
-                          const QRect& wallArea ) override;
+                          const QRegion& wallArea ) override;
     void preRenderSync( WallToWallChannel& wallToWallChannel ) override;
+    bool isModified() override;
+    size_t getMemoryUsage() const override;
+    void releaseMemory() override;
     bool isDecodingInProgress( WallToWallChannel& wallToWallChannel );
 
     void updateRenderers( const deflect::Segments& segments );
-    void updateVisibleTextures();
+    bool updateVisibleTextures();
     void swapBuffers();
     void recomputeDimensions( const deflect::Segments& segments );
-    void decodeVisibleTextures();
+    bool decodeVisibleTextures();
 
     void adjustFrameDecodersCount( const size_t count );
     void adjustSegmentRendererCount( const size_t count );
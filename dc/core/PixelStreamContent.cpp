@@ -43,8 +43,13 @@
 
 BOOST_CLASS_EXPORT_GUID( PixelStreamContent, "PixelStreamContent" )
 
+PixelStreamContent::PixelStreamContent()
+    : _pixelFormat( deflect::RGBA )
+{}
+
 PixelStreamContent::PixelStreamContent( const QString& uri )
     : Content( uri )
+    , _pixelFormat( deflect::RGBA )
 {}
 
 CONTENT_TYPE PixelStreamContent::getType() const
@@ -61,3 +66,17 @@ bool PixelStreamContent::hasFixedAspectRatio() const
 {
     return _uri == "dock";
 }
+
+deflect::PixelFormat PixelStreamContent::getPixelFormat() const
+{
+    return _pixelFormat;
+}
+
+void PixelStreamContent::setPixelFormat( const deflect::PixelFormat format )
+{
+    if( _pixelFormat == format )
+        return;
+
+    _pixelFormat = format;
+    emit modified();
+}
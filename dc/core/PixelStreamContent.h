@@ -42,6 +42,8 @@
 #include "Content.h"
 #include <boost/serialization/base_object.hpp>
 
+#include <deflect/ImageWrapper.h>
+
 class PixelStreamContent : public Content
 {
 public:
@@ -63,18 +65,35 @@ public:
     /** @return true if the streamer can handle aspect ratio changes. */
     bool hasFixedAspectRatio() const override;
 
+    /** @return the pixel format of the uncompressed segments of the stream. */
+    deflect::PixelFormat getPixelFormat() const;
+
+    /**
+     * Set the pixel format of the uncompressed segments of the stream.
+     * Only deflect::RGBA (default) and deflect::BGRA are supported by Walls.
+     * Compressed segments are always decoded as deflect::RGBA.
+     * @param format the pixel format used by the streamer
+     */
+    void setPixelFormat( deflect::PixelFormat format );
+
 private:
     friend class boost::serialization::access;
 
     // Default constructor required for boost::serialization
-    PixelStreamContent() {}
+    PixelStreamContent();
 
     template<class Archive>
-    void serialize( Archive & ar, const unsigned int )
+    void serialize( Archive & ar, const unsigned int version )
     {
         // serialize base class information (with NVP for xml archives)
         ar & BOOST_SERIALIZATION_BASE_OBJECT_NVP( Content );
+        if( version >= 1 )
+            ar & boost::serialization::make_nvp( "pixelFormat", _pixelFormat );
     }
+
+    deflect::PixelFormat _pixelFormat;
 };
 
+BOOST_CLASS_VERSION( PixelStreamContent, 1 )
+
 #endif
@@ -48,10 +48,6 @@ PixelStreamInteractionDelegate::PixelStreamInteractionDelegate( ContentWindow&
     : ContentInteractionDelegate( contentWindow )
     , _eventReceiversCount( 0 )
 {
-    connect( &contentWindow, SIGNAL( coordinatesChanged( )),
-             this, SLOT( _sendSizeChangedEvent( )));
-    connect( &contentWindow, SIGNAL( focusedChanged( )),
-             this, SLOT( _sendSizeChangedEvent( )));
 }
 
 void PixelStreamInteractionDelegate::touchBegin( const QPointF position )
@@ -191,14 +187,13 @@ bool PixelStreamInteractionDelegate::hasEventReceivers() const
     return _eventReceiversCount > 0;
 }
 
-void PixelStreamInteractionDelegate::_sendSizeChangedEvent()
+void PixelStreamInteractionDelegate::sendViewSizeChangedEvent( const QSize&
+                                                               size )
 {
-    const QRectF& win = getWindowCoord();
-
     deflect::Event deflectEvent;
     deflectEvent.type = deflect::Event::EVT_VIEW_SIZE_CHANGED;
-    deflectEvent.dx = win.width();
-    deflectEvent.dy = win.height();
+    deflectEvent.dx = size.width();
+    deflectEvent.dy = size.height();
 
     emit notify( deflectEvent );
 }
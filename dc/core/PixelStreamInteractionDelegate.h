@@ -82,13 +82,18 @@ public:
     /** Does this delegate already have registered EventReceiver(s) */
     bool hasEventReceivers() const;
 
+    /**
+     * Ask the EventReceivers to stream at the given size.
+     *
+     * Sends a deflect::Event::EVT_VIEW_SIZE_CHANGED event.
+     * @param size The size in pixels, see PixelStreamWindowManager.
+     */
+    void sendViewSizeChangedEvent( const QSize& size );
+
 signals:
     /** @internal Notify registered EventReceivers that an Event occured. */
     void notify( deflect::Event event );
 
-private slots:
-    void _sendSizeChangedEvent();
-
 private:
     deflect::Event _getNormEvent( const QPointF& position ) const;
 
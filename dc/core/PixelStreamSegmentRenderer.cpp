@@ -50,9 +50,10 @@ const QRect& PixelStreamSegmentRenderer::getRect() const
     return rect_;
 }
 
-void PixelStreamSegmentRenderer::updateTexture(const QImage& image)
+void PixelStreamSegmentRenderer::updateTexture(const QImage& image,
+                                               const deflect::PixelFormat format)
 {
-    texture_.update(image, GL_RGBA);
+    texture_.update(image, format == deflect::BGRA ? GL_BGRA : GL_RGBA);
     textureNeedsUpdate_ = false;
 }
 
@@ -66,6 +67,17 @@ void PixelStreamSegmentRenderer::setTextureNeedsUpdate()
     textureNeedsUpdate_ = true;
 }
 
+void PixelStreamSegmentRenderer::releaseTexture()
+{
+    texture_.free();
+    textureNeedsUpdate_ = true;
+}
+
+size_t PixelStreamSegmentRenderer::getTextureMemory() const
+{
+    return texture_.getMemorySize();
+}
+
 void PixelStreamSegmentRenderer::setParameters( const deflect::SegmentParameters& param )
 {
     rect_.setX( param.x );
@@ -74,23 +86,11 @@ void PixelStreamSegmentRenderer::setParameters( const deflect::SegmentParameters
     rect_.setHeight( param.height );
 }
 
-bool PixelStreamSegmentRenderer::render()
+bool PixelStreamSegmentRenderer::render( GLQuadBatch& batch )
 {
     if(!texture_.isValid())
         return false;
 
-    // OpenGL transformation
-    glPushMatrix();
-
-    glTranslatef(rect_.x(), rect_.y(), 0.);
-    // The following draw calls assume normalized coordinates, so we must
-    // pre-multiply by this segment's dimensions
-    glScalef(rect_.width(), rect_.height(), 0.);
-
-    quad_.setTexture( texture_.getTextureId( ));
-    quad_.render();
-
-    glPopMatrix();
-
+    batch.add( rect_, UNIT_RECTF, texture_.getTextureId( ));
     return true;
 }
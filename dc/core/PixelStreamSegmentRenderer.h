@@ -41,7 +41,9 @@
 
 #include "types.h"
 #include "GLTexture2D.h"
-#include "GLQuad.h"
+#include "GLQuadBatch.h"
+
+#include <deflect/ImageWrapper.h>
 
 #include <boost/noncopyable.hpp>
 
@@ -63,9 +65,11 @@ public:
      * Update the texture.
      *
      * This call is blocking (texture upload to GPU).
-     * @param image The new texture to upload, in (GL_)RGBA format.
+     * @param image The new texture to upload.
+     * @param format The pixel format of the image data, RGBA or BGRA.
      */
-    void updateTexture(const QImage &image);
+    void updateTexture(const QImage &image,
+                       deflect::PixelFormat format = deflect::RGBA);
 
     /** Has the texture been marked as oudated with setTextureOutdated() */
     bool textureNeedsUpdate() const;
@@ -73,20 +77,26 @@ public:
     /** Mark the texture as being outdated */
     void setTextureNeedsUpdate();
 
+    /** Free the texture, which must be updated again before rendering. */
+    void releaseTexture();
+
+    /** Get the GPU memory used by the texture, in bytes. */
+    size_t getTextureMemory() const;
+
     /** Set the position and size paramters. (0,0) == top-left of the stream. */
     void setParameters( const deflect::SegmentParameters& param );
 
     /**
-     * Render the current texture.
+     * Add the current texture to a batch of quads to render.
      *
-     * Assume that the GL matrices have been set to the normalized dimensions of the stream.
-     * @return true on successful render; false if no texture available.
+     * The quad is positioned in the pixel coordinates of the stream.
+     * @param batch The batch to add the quad to.
+     * @return true on success; false if no texture available.
      */
-    bool render();
+    bool render( GLQuadBatch& batch );
 
 private:
     GLTexture2D texture_;
-    GLQuad quad_;
     QRect rect_;
     bool textureNeedsUpdate_;
 };
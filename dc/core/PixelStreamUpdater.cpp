@@ -51,9 +51,10 @@ PixelStreamUpdater::PixelStreamUpdater()
 {
 }
 
-void PixelStreamUpdater::synchronizeFramesSwap( const SyncFunction&
+bool PixelStreamUpdater::synchronizeFramesSwap( const SyncFunction&
                                                 versionCheckFunc )
 {
+    bool swapped = false;
     PixelStreamMap::const_iterator streamIt = _pixelStreamMap.begin();
     for( ; streamIt != _pixelStreamMap.end(); ++streamIt )
     {
@@ -64,8 +65,31 @@ void PixelStreamUpdater::synchronizeFramesSwap( const SyncFunction&
         {
             streamIt.value()->setNewFrame( swapSyncFrame.get( ));
             emit requestFrame( uri );
+            swapped = true;
         }
     }
+    return swapped;
+}
+
+std::map< std::string, double > PixelStreamUpdater::getStreamsFps() const
+{
+    std::map< std::string, double > streamsFps;
+    PixelStreamMap::const_iterator streamIt = _pixelStreamMap.begin();
+    for( ; streamIt != _pixelStreamMap.end(); ++streamIt )
+        streamsFps[streamIt.key().toStdString()] = streamIt.value()->getFps();
+    return streamsFps;
+}
+
+size_t PixelStreamUpdater::getPendingFramesCount() const
+{
+    size_t count = 0;
+    SwapSyncFramesMap::const_iterator frameIt = _swapSyncFrames.begin();
+    for( ; frameIt != _swapSyncFrames.end(); ++frameIt )
+    {
+        if( frameIt.value().isPending( ))
+            ++count;
+    }
+    return count;
 }
 
 void PixelStreamUpdater::updatePixelStream( deflect::FramePtr frame )
@@ -47,6 +47,9 @@
 #include <QtCore/QObject>
 #include <QtCore/QMap>
 
+#include <map>
+#include <string>
+
 /**
  * Synchronize the update of PixelStreams and send new frame requests.
  */
@@ -58,8 +61,17 @@ public:
     /** Constructor. */
     PixelStreamUpdater();
 
-    /** Synchronize the update of the PixelStreams. */
-    void synchronizeFramesSwap( const SyncFunction& versionCheckFunc );
+    /**
+     * Synchronize the update of the PixelStreams.
+     * @return true if a new frame was swapped for any of the streams.
+     */
+    bool synchronizeFramesSwap( const SyncFunction& versionCheckFunc );
+
+    /** @return the frame rate of each PixelStream, indexed by uri. */
+    std::map< std::string, double > getStreamsFps() const;
+
+    /** @return the number of frames received but not swapped yet. */
+    size_t getPendingFramesCount() const;
 
 public slots:
     /** Update the appropriate PixelStream with the given frame. */
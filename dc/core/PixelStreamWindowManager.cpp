@@ -45,13 +45,59 @@
 #include "DisplayGroup.h"
 #include "localstreamer/DockPixelStreamer.h"
 #include "log.h"
+#include "PixelStreamContent.h"
 #include "PixelStreamInteractionDelegate.h"
 
 #include <deflect/Frame.h>
 
+#include <cmath>
+
 namespace
 {
 const QSize EMPTY_STREAM_SIZE( 640, 480 );
+
+// Hysteresis for the view size negotiation: a smaller stream is only requested
+// when the window has shrunk below this fraction of the current view size.
+const qreal VIEW_SIZE_DOWNSCALE_THRESHOLD = 0.75;
+const qreal VIEW_SIZE_ASPECT_RATIO_TOLERANCE = 0.01;
+
+QSize getOnWallSize( const ContentWindow& window )
+{
+    const QRectF& coords = window.isFocused() ? window.getFocusedCoordinates()
+                                              : window.getCoordinates();
+    // Zooming in requires the stream resolution to grow accordingly
+    const QRectF& zoomRect = window.getZoomRect();
+    return QSizeF( coords.width() / zoomRect.width(),
+                   coords.height() / zoomRect.height( )).toSize();
+}
+
+bool needsViewSizeUpdate( const QSize& current, const QSize& required )
+{
+    if( required.isEmpty( ))
+        return false;
+
+    if( current.isEmpty( ))
+        return true;
+
+    // Growing: always update to preserve the image quality
+    if( required.width() > current.width() ||
+        required.height() > current.height( ))
+    {
+        return true;
+    }
+
+    // Interactive streamers (i.e. webbrowsers) must follow the window shape
+    const qreal currentAspectRatio = qreal(current.width()) / current.height();
+    const qreal requiredAspectRatio = qreal(required.width()) / required.height();
+    if( std::abs( requiredAspectRatio / currentAspectRatio - 1.0 ) >
+            VIEW_SIZE_ASPECT_RATIO_TOLERANCE )
+    {
+        return true;
+    }
+
+    // Shrinking: only update after a significant change
+    return required.width() < current.width() * VIEW_SIZE_DOWNSCALE_THRESHOLD;
+}
 }
 
 PixelStreamWindowManager::PixelStreamWindowManager( DisplayGroup& displayGroup )
@@ -91,7 +137,8 @@ void PixelStreamWindowManager::showWindow( const QString& uri )
 
 void PixelStreamWindowManager::openWindow( const QString& uri,
                                            const QPointF& pos,
-                                           const QSize& size )
+                                           const QSize& size,
+                                           const deflect::PixelFormat format )
 {
     if( getContentWindow( uri ))
     {
@@ -110,6 +157,7 @@ void PixelStreamWindowManager::openWindow( const QString& uri,
     ContentPtr content = ContentFactory::getPixelStreamContent( uri );
     if( size.isValid( ))
         content->setDimensions( size );
+    static_cast<PixelStreamContent*>( content.get( ))->setPixelFormat( format );
     ContentWindowPtr contentWindow( new ContentWindow( content ));
 
     ContentWindowController controller( *contentWindow, _displayGroup );
@@ -119,6 +167,11 @@ void PixelStreamWindowManager::openWindow( const QString& uri,
 
     _streamerWindows[ uri ] = contentWindow->getID();
     _displayGroup.addContentWindow( contentWindow );
+
+    connect( contentWindow.get(), &ContentWindow::modified,
+             this, [this, uri]() { _updateViewSize( uri ); });
+    connect( contentWindow.get(), &ContentWindow::focusedCoordinatesChanged,
+             this, [this, uri]() { _updateViewSize( uri ); });
 }
 
 void PixelStreamWindowManager::openPixelStreamWindow( const QString uri )
@@ -160,6 +213,13 @@ void PixelStreamWindowManager::registerEventReceiver( const QString uri,
     if( !exclusive || !delegate->hasEventReceivers( ))
         success = delegate->registerEventReceiver( receiver );
 
+    // Inform the new receiver of the size at which it should stream
+    if( success )
+    {
+        _streamerViewSizes.erase( uri );
+        _updateViewSize( uri );
+    }
+
     if( uri == DockPixelStreamer::getUniqueURI( ))
         contentWindow->setState( ContentWindow::SELECTED );
 
@@ -173,9 +233,16 @@ void PixelStreamWindowManager::onContentWindowRemoved( ContentWindowPtr window )
 
     const QString& uri = window->getContent()->getURI();
     _streamerWindows.erase( uri );
+    _streamerViewSizes.erase( uri );
     emit pixelStreamWindowClosed( uri );
 }
 
+QSize PixelStreamWindowManager::getViewSize( const QString& uri ) const
+{
+    ViewSizeMap::const_iterator it = _streamerViewSizes.find( uri );
+    return it != _streamerViewSizes.end() ? it->second : QSize();
+}
+
 void PixelStreamWindowManager::updateStreamDimensions( deflect::FramePtr frame )
 {
     const QSize size( frame->computeDimensions( ));
@@ -210,3 +277,21 @@ void PixelStreamWindowManager::updateSizeHints( const QString uri,
     ContentWindowController controller( *contentWindow, _displayGroup );
     controller.adjustSize( SIZE_1TO1 );
 }
+
+void PixelStreamWindowManager::_updateViewSize( const QString& uri )
+{
+    ContentWindowPtr contentWindow = getContentWindow( uri );
+    if( !contentWindow )
+        return;
+
+    const QSize& required = getOnWallSize( *contentWindow );
+    if( !needsViewSizeUpdate( getViewSize( uri ), required ))
+        return;
+
+    _streamerViewSizes[ uri ] = required;
+
+    PixelStreamInteractionDelegate* delegate =
+            static_cast<PixelStreamInteractionDelegate*>(
+                contentWindow->getInteractionDelegate( ));
+    delegate->sendViewSizeChangedEvent( required );
+}
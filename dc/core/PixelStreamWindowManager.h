@@ -47,11 +47,20 @@
 #include <map>
 
 #include "types.h"
+#include <deflect/ImageWrapper.h>
 #include <deflect/SizeHints.h>
 
 /**
  * Handles window creation, association and updates for pixel streamers, both
  * local and external. The association is one streamer to one window.
+ *
+ * It also negotiates the resolution of the streams with their sources: the
+ * on-wall size of each window is sent back to the streamer as a
+ * deflect::Event::EVT_VIEW_SIZE_CHANGED event, so that a small window does not
+ * receive (and broadcast to all walls) a full-resolution stream. A larger size
+ * is requested as soon as the window grows, is focused or maximized, while a
+ * smaller size is only requested after the window has shrunk significantly to
+ * avoid resizing the stream continuously.
  */
 class PixelStreamWindowManager : public QObject
 {
@@ -94,8 +103,10 @@ public:
      * @param pos the desired position for the center of the window in pixels.
      *        If pos.isNull(), the window is centered on the DisplayGroup.
      * @param size the desired size of the window in pixels.
+     * @param format the pixel format of the uncompressed stream segments.
      */
-    void openWindow( const QString& uri, const QPointF& pos, const QSize& size);
+    void openWindow( const QString& uri, const QPointF& pos, const QSize& size,
+                     deflect::PixelFormat format = deflect::RGBA );
 
 public slots:
     /**
@@ -124,6 +135,14 @@ public slots:
     void registerEventReceiver( QString uri, bool exclusive,
                                 deflect::EventReceiver* receiver );
 
+    /**
+     * Get the size last requested to the streamer for rendering its frames.
+     *
+     * @param uri the URI of the streamer
+     * @return the view size in pixels, or an empty size if none was requested
+     */
+    QSize getViewSize( const QString& uri ) const;
+
     /**
      * Update the dimension of the content according to the stream's dimension
      * @param frame the new stream frame to check its dimension
@@ -169,6 +188,11 @@ private:
 
     typedef std::map< QString, QUuid > ContentWindowMap;
     ContentWindowMap _streamerWindows;
+
+    typedef std::map< QString, QSize > ViewSizeMap;
+    ViewSizeMap _streamerViewSizes;
+
+    void _updateViewSize( const QString& uri );
 };
 
 #endif
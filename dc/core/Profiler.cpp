@@ -0,0 +1,307 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+#include "Profiler.h"
+
+#include <QFile>
+
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+
+namespace
+{
+std::atomic< bool > profilerEnabled( false );
+
+struct ProfilerEvent
+{
+    const char* category;
+    const char* name;
+    int64_t start;
+    int64_t duration;
+};
+
+/**
+ * A slot of a ring, guarded by a sequence lock: the sequence is odd while the
+ * owner thread writes the slot, and counts two per event written. The fields
+ * are relaxed atomics so that a reader racing with the writer is well defined,
+ * and detects the race with the sequence.
+ */
+struct EventSlot
+{
+    std::atomic< uint64_t > sequence;
+    std::atomic< const char* > category;
+    std::atomic< const char* > name;
+    std::atomic< int64_t > start;
+    std::atomic< int64_t > duration;
+};
+
+/** The events of one thread, written only by that thread. */
+class EventRing
+{
+public:
+    explicit EventRing( const int id )
+        : _id( id )
+        , _size( Profiler::EVENTS_PER_THREAD )
+        , _slots( new EventSlot[_size]( ))
+        , _writeIndex( 0 )
+    {}
+
+    int getId() const { return _id; }
+
+    void push( const ProfilerEvent& event )
+    {
+        const uint64_t index = _writeIndex.load( std::memory_order_relaxed );
+        EventSlot& slot = _slots[index % _size];
+        const uint64_t sequence = _getSequence( index );
+
+        slot.sequence.store( sequence - 1, std::memory_order_relaxed );
+        std::atomic_thread_fence( std::memory_order_release );
+        slot.category.store( event.category, std::memory_order_relaxed );
+        slot.name.store( event.name, std::memory_order_relaxed );
+        slot.start.store( event.start, std::memory_order_relaxed );
+        slot.duration.store( event.duration, std::memory_order_relaxed );
+        slot.sequence.store( sequence, std::memory_order_release );
+
+        _writeIndex.store( index + 1, std::memory_order_release );
+    }
+
+    std::vector< ProfilerEvent > getEvents() const
+    {
+        const uint64_t end = _writeIndex.load( std::memory_order_acquire );
+        const uint64_t begin = end > _size ? end - _size : 0;
+
+        std::vector< ProfilerEvent > events;
+        events.reserve( end - begin );
+        for( uint64_t i = begin; i < end; ++i )
+        {
+            const EventSlot& slot = _slots[i % _size];
+            const uint64_t sequence = _getSequence( i );
+            if( slot.sequence.load( std::memory_order_acquire ) != sequence )
+                continue; // overwritten by a newer event
+
+            ProfilerEvent event;
+            event.category = slot.category.load( std::memory_order_relaxed );
+            event.name = slot.name.load( std::memory_order_relaxed );
+            event.start = slot.start.load( std::memory_order_relaxed );
+            event.duration = slot.duration.load( std::memory_order_relaxed );
+
+            std::atomic_thread_fence( std::memory_order_acquire );
+            if( slot.sequence.load( std::memory_order_relaxed ) != sequence )
+                continue; // torn: the owner thread wrote the slot meanwhile
+
+            events.push_back( event );
+        }
+        return events;
+    }
+
+    std::string name;
+
+private:
+    const int _id;
+    const uint64_t _size;
+    std::unique_ptr< EventSlot[] > _slots;
+    std::atomic< uint64_t > _writeIndex;
+
+    /** @return the sequence of the slot once the event index is written. */
+    uint64_t _getSequence( const uint64_t index ) const
+    {
+        return 2 * ( index / _size + 1 );
+    }
+};
+
+/**
+ * All the rings of the process. The ring of a thread which exits is given to
+ * the next new thread, so that short-lived threads do not allocate new rings.
+ */
+class RingRegistry
+{
+public:
+    EventRing* acquire()
+    {
+        std::lock_guard< std::mutex > lock( _mutex );
+        if( !_freeRings.empty( ))
+        {
+            EventRing* ring = _freeRings.back();
+            _freeRings.pop_back();
+            ring->name.clear();
+            return ring;
+        }
+        _rings.emplace_back( new EventRing( _rings.size( )));
+        return _rings.back().get();
+    }
+
+    void release( EventRing* ring )
+    {
+        std::lock_guard< std::mutex > lock( _mutex );
+        _freeRings.push_back( ring );
+    }
+
+    void setName( EventRing* ring, const std::string& name )
+    {
+        std::lock_guard< std::mutex > lock( _mutex );
+        ring->name = name;
+    }
+
+    std::string getTraceEvents( const int pid, const std::string& processName )
+    {
+        std::lock_guard< std::mutex > lock( _mutex );
+
+        std::string trace = "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" +
+                            std::to_string( pid ) + ",\"args\":{\"name\":\"" +
+                            processName + "\"}}";
+        char buffer[256];
+        for( const auto& ring : _rings )
+        {
+            if( !ring->name.empty( ))
+            {
+                snprintf( buffer, sizeof( buffer ),
+                          ",\n{\"name\":\"thread_name\",\"ph\":\"M\","
+                          "\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                          pid, ring->getId(), ring->name.c_str( ));
+                trace += buffer;
+            }
+            for( const ProfilerEvent& event : ring->getEvents( ))
+            {
+                snprintf( buffer, sizeof( buffer ),
+                          ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\","
+                          "\"ts\":%" PRId64 ",\"dur\":%" PRId64 ","
+                          "\"pid\":%d,\"tid\":%d}",
+                          event.name, event.category, event.start,
+                          event.duration, pid, ring->getId( ));
+                trace += buffer;
+            }
+        }
+        return trace;
+    }
+
+private:
+    std::mutex _mutex;
+    std::vector< std::unique_ptr< EventRing >> _rings;
+    std::vector< EventRing* > _freeRings;
+};
+
+RingRegistry& getRegistry()
+{
+    static RingRegistry registry;
+    return registry;
+}
+
+struct ThreadRing
+{
+    ThreadRing()
+        : ring( getRegistry().acquire( ))
+    {}
+
+    ~ThreadRing()
+    {
+        getRegistry().release( ring );
+    }
+
+    EventRing* const ring;
+};
+
+EventRing* getThreadRing()
+{
+    static thread_local ThreadRing threadRing;
+    return threadRing.ring;
+}
+}
+
+const size_t Profiler::EVENTS_PER_THREAD;
+
+void Profiler::setEnabled( const bool enabled )
+{
+    profilerEnabled = enabled;
+}
+
+bool Profiler::isEnabled()
+{
+    return profilerEnabled.load( std::memory_order_relaxed );
+}
+
+void Profiler::setThreadName( const std::string& name )
+{
+    getRegistry().setName( getThreadRing(), name );
+}
+
+int64_t Profiler::now()
+{
+    using namespace std::chrono;
+    return duration_cast< microseconds >(
+                system_clock::now().time_since_epoch( )).count();
+}
+
+void Profiler::record( const char* category, const char* name,
+                       const int64_t start, const int64_t duration )
+{
+    const ProfilerEvent event = { category, name, start, duration };
+    getThreadRing()->push( event );
+}
+
+std::string Profiler::getTraceEvents( const int pid,
+                                      const std::string& processName )
+{
+    return getRegistry().getTraceEvents( pid, processName );
+}
+
+bool Profiler::writeChromeTrace( const QString& filename,
+                                 const std::vector< std::string >& traceEvents )
+{
+    QFile file( filename );
+    if( !file.open( QIODevice::WriteOnly | QIODevice::Text ))
+        return false;
+
+    file.write( "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n" );
+    bool first = true;
+    for( const std::string& events : traceEvents )
+    {
+        if( events.empty( ))
+            continue;
+        if( !first )
+            file.write( ",\n" );
+        file.write( events.data(), events.size( ));
+        first = false;
+    }
+    file.write( "\n]}\n" );
+    return file.error() == QFileDevice::NoError;
+}
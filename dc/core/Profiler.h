@@ -0,0 +1,142 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <QString>
+
+#include <boost/noncopyable.hpp>
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/**
+ * Low-overhead timing of the phases of the frames, for offline analysis.
+ *
+ * Each thread records the duration of its ProfilerScopes in its own ring
+ * buffer, which keeps the most recent EVENTS_PER_THREAD events. Only the
+ * owning thread writes to a buffer, so recording takes no lock.
+ *
+ * The events are exported in the Chrome trace event format (chrome://tracing)
+ * with one process per MPI rank. Timestamps come from the system clock, so
+ * the timelines of different hosts are only as aligned as their clocks.
+ */
+class Profiler
+{
+public:
+    /** Maximum number of events kept for each thread. */
+    static const size_t EVENTS_PER_THREAD = 16384;
+
+    /** Enable or disable the recording of events, disabled by default. */
+    static void setEnabled( bool enabled );
+
+    /** @return true if the events are recorded. */
+    static bool isEnabled();
+
+    /** Set the name of the calling thread in the traces. */
+    static void setThreadName( const std::string& name );
+
+    /** @return the current time in microseconds. */
+    static int64_t now();
+
+    /**
+     * Record an event of the calling thread.
+     * @param category The category of the event, must be a string literal
+     * @param name The name of the event, must be a string literal
+     * @param start The start time of the event, from now()
+     * @param duration The duration of the event in microseconds
+     */
+    static void record( const char* category, const char* name,
+                        int64_t start, int64_t duration );
+
+    /**
+     * Get the recorded events of all the threads of this process.
+     * @param pid The process identifier in the trace, typically the MPI rank
+     * @param processName The name of the process in the trace
+     * @return the Chrome trace events, separated by commas
+     */
+    static std::string getTraceEvents( int pid,
+                                       const std::string& processName );
+
+    /**
+     * Write the events of several processes to a Chrome trace file.
+     * @param filename The file to write
+     * @param traceEvents The events of each process from getTraceEvents()
+     * @return true on success
+     */
+    static bool writeChromeTrace( const QString& filename,
+                                  const std::vector< std::string >& traceEvents );
+};
+
+/**
+ * Record the duration of the enclosing scope if the Profiler is enabled.
+ * @see PROFILE_SCOPE
+ */
+class ProfilerScope : public boost::noncopyable
+{
+public:
+    ProfilerScope( const char* category, const char* name )
+        : _category( category )
+        , _name( name )
+        , _start( Profiler::isEnabled() ? Profiler::now() : -1 )
+    {}
+
+    ~ProfilerScope()
+    {
+        if( _start >= 0 )
+            Profiler::record( _category, _name, _start,
+                              Profiler::now() - _start );
+    }
+
+private:
+    const char* _category;
+    const char* _name;
+    const int64_t _start;
+};
+
+#define PROFILER_CONCAT_( a, b ) a ## b
+#define PROFILER_CONCAT( a, b ) PROFILER_CONCAT_( a, b )
+
+/** Record the duration of the enclosing scope under the given name. */
+#define PROFILE_SCOPE( category, name ) \
+    ProfilerScope PROFILER_CONCAT( profilerScope, __LINE__ )( category, name )
+
+#endif // PROFILER_H
@@ -0,0 +1,154 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+#include "QmlItemPool.h"
+
+#include "log.h"
+
+#include <QtDeclarative/QDeclarativeComponent>
+#include <QtDeclarative/QDeclarativeContext>
+#include <QtDeclarative/QDeclarativeEngine>
+#include <QtDeclarative/QDeclarativeItem>
+
+#include <QGraphicsScene>
+
+const int QmlItemPool::DEFAULT_MAX_IDLE_ITEMS = 64;
+
+QmlItemPool::Item::Item()
+    : context( 0 )
+    , item( 0 )
+{
+}
+
+QmlItemPool::QmlItemPool( QDeclarativeEngine& engine, const int maxIdleItems )
+    : _engine( engine )
+    , _maxIdleItems( maxIdleItems )
+{
+}
+
+QmlItemPool::~QmlItemPool()
+{
+    for( const QList< Item >& items : _idleItems )
+    {
+        for( const Item& item : items )
+            _destroy( item );
+    }
+}
+
+void QmlItemPool::preload( const QUrl& url )
+{
+    _getComponent( url );
+}
+
+QDeclarativeItem* QmlItemPool::create( const QUrl& url,
+                                       QDeclarativeContext& context )
+{
+    QDeclarativeComponent& component = _getComponent( url );
+    QObject* qmlObject = component.create( &context );
+    if( !qmlObject )
+    {
+        put_flog( LOG_ERROR, "could not create '%s': %s",
+                  url.toString().toLocal8Bit().constData(),
+                  component.errorString().toLocal8Bit().constData( ));
+        return 0;
+    }
+    return qobject_cast<QDeclarativeItem*>( qmlObject );
+}
+
+QmlItemPool::Item QmlItemPool::acquire( const QUrl& url,
+                                        const QString& modelName,
+                                        boost::shared_ptr<QObject> model,
+                                        const bool reuse )
+{
+    QList< Item >& idleItems = _idleItems[url];
+    if( reuse && !idleItems.isEmpty( ))
+    {
+        Item item = idleItems.takeLast();
+        item.context->setContextProperty( modelName, model.get( ));
+        item.model = model;
+        return item;
+    }
+
+    Item item;
+    item.url = url;
+    item.context = new QDeclarativeContext( _engine.rootContext( ));
+    item.context->setContextProperty( modelName, model.get( ));
+    item.model = model;
+    item.item = create( url, *item.context );
+    return item;
+}
+
+void QmlItemPool::release( const Item& item, const bool recycle )
+{
+    if( item.item )
+    {
+        item.item->setParentItem( 0 );
+        if( item.item->scene( ))
+            item.item->scene()->removeItem( item.item );
+    }
+
+    QList< Item >& idleItems = _idleItems[item.url];
+    if( !recycle || !item.item || idleItems.size() >= _maxIdleItems )
+    {
+        _destroy( item );
+        return;
+    }
+    // The model stays alive until the item is reused, because the bindings of
+    // the item may still be evaluated while it is idle.
+    idleItems.append( item );
+}
+
+int QmlItemPool::getIdleCount( const QUrl& url ) const
+{
+    return _idleItems.value( url ).size();
+}
+
+QDeclarativeComponent& QmlItemPool::_getComponent( const QUrl& url )
+{
+    ComponentPtr& component = _components[url];
+    if( !component )
+        component.reset( new QDeclarativeComponent( &_engine, url ));
+    return *component;
+}
+
+void QmlItemPool::_destroy( const Item& item )
+{
+    delete item.item;
+    delete item.context;
+}
@@ -0,0 +1,147 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+#ifndef QMLITEMPOOL_H
+#define QMLITEMPOOL_H
+
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <QUrl>
+
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+
+class QDeclarativeComponent;
+class QDeclarativeContext;
+class QDeclarativeEngine;
+class QDeclarativeItem;
+
+/**
+ * Create qml items from components which are only compiled once, and recycle
+ * the items of the windows which are closed.
+ *
+ * Pooled items keep the context in which they were created. Reusing an item
+ * only replaces the model exposed in its context, which is much faster than
+ * instantiating the full qml tree of a window again.
+ */
+class QmlItemPool : public boost::noncopyable
+{
+public:
+    /** An item created by the pool, with its own context. */
+    struct Item
+    {
+        Item();
+
+        /** The url of the qml component. */
+        QUrl url;
+
+        /** The context of the item, owned by the pool. */
+        QDeclarativeContext* context;
+
+        /** The item, owned by the pool. */
+        QDeclarativeItem* item;
+
+        /** The model exposed in the context, kept alive while it is bound. */
+        boost::shared_ptr<QObject> model;
+    };
+
+    /** The default maximum number of idle items kept for each component. */
+    static const int DEFAULT_MAX_IDLE_ITEMS;
+
+    /**
+     * Constructor.
+     * @param engine The engine used to compile the components
+     * @param maxIdleItems The maximum number of idle items kept for each
+     *        component, extra items are destroyed when they are released
+     */
+    QmlItemPool( QDeclarativeEngine& engine,
+                 int maxIdleItems = DEFAULT_MAX_IDLE_ITEMS );
+
+    /** Destructor, all the acquired items must have been released. */
+    ~QmlItemPool();
+
+    /** Compile a component ahead of its first use. */
+    void preload( const QUrl& url );
+
+    /**
+     * Create an item which is not recycled, such as a child item.
+     * @param url The url of the qml component
+     * @param context The context in which to create the item
+     * @return the new item, owned by the caller, or 0 on error
+     */
+    QDeclarativeItem* create( const QUrl& url, QDeclarativeContext& context );
+
+    /**
+     * Acquire an item, reusing an idle one if possible.
+     * @param url The url of the qml component
+     * @param modelName The name of the model in the context of the item
+     * @param model The model to expose in the context of the item
+     * @param reuse Create a new item even if an idle one is available if
+     *        false, for instance if the model is not in its default qml state
+     * @return the item, with a null item member on error
+     */
+    Item acquire( const QUrl& url, const QString& modelName,
+                  boost::shared_ptr<QObject> model, bool reuse = true );
+
+    /**
+     * Give an item back to the pool. It is removed from its scene and kept
+     * for reuse, or destroyed if the pool is full.
+     * @param item The item, which must not be used after this call
+     * @param recycle Destroy the item instead of reusing it if false, for
+     *        instance if its model is not in its default qml state
+     */
+    void release( const Item& item, bool recycle = true );
+
+    /** @return the number of idle items for the given component. */
+    int getIdleCount( const QUrl& url ) const;
+
+private:
+    typedef boost::shared_ptr<QDeclarativeComponent> ComponentPtr;
+
+    QDeclarativeEngine& _engine;
+    const int _maxIdleItems;
+    QMap< QUrl, ComponentPtr > _components;
+    QMap< QUrl, QList< Item > > _idleItems;
+
+    QDeclarativeComponent& _getComponent( const QUrl& url );
+    static void _destroy( const Item& item );
+};
+
+#endif // QMLITEMPOOL_H
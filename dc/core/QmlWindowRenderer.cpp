@@ -43,10 +43,8 @@
 #include "ContentWindow.h"
 #include "ContentWindowController.h"
 #include "PixelStream.h"
-
-#include <QtDeclarative/QDeclarativeComponent>
-
-#include <QGraphicsScene>
+#include "Profiler.h"
+#include "RenderContext.h"
 
 namespace
 {
@@ -54,32 +52,52 @@ const QString CONTENT_ITEM_OBJECT_NAME( "ContentItem" );
 const QString ZOOM_CONTEXT_ITEM_OBJECT_NAME( "ZoomContextItem" );
 const QUrl QML_WINDOW_URL( "qrc:/qml/core/WallContentWindow.qml" );
 const QUrl QML_PIXELSTREAM_URL( "qrc:/qml/core/PixelStream.qml" );
+
+/**
+ * Pooled items are only exchanged between windows in the default qml state.
+ * Giving a new model to an item in another state would play the transitions
+ * and behaviors (such as the one on border.color) of the state change.
+ */
+bool hasDefaultQmlState( const ContentWindow& window )
+{
+    return window.getState() == ContentWindow::NONE && !window.isFocused() &&
+           !window.getControlsVisible();
+}
 }
 
-QmlWindowRenderer::QmlWindowRenderer( QDeclarativeEngine& engine,
+QmlWindowRenderer::QmlWindowRenderer( RenderContext& renderContext,
                                       QDeclarativeItem& parentItem,
                                       ContentWindowPtr contentWindow,
                                       const bool isBackground )
-    : contentWindow_( contentWindow )
-    , windowContext_( new QDeclarativeContext( engine.rootContext( )))
-    , windowItem_( 0 )
-    , wallContent_( WallContent::create( *(contentWindow->getContent( ))))
+    : renderContext_( renderContext )
+    , contentWindow_( contentWindow )
+    , pooledItem_( renderContext.getQmlItemPool().acquire(
+                       QML_WINDOW_URL, "contentwindow", contentWindow,
+                       hasDefaultQmlState( *contentWindow )))
+    , windowContext_( pooledItem_.context )
+    , windowItem_( pooledItem_.item )
+    , pixelStreamItem_( 0 )
+    , contentItem_( 0 )
+    , zoomContextItem_( 0 )
+    , loadingPolicy_( renderContext.getContentLoadingPolicy( ))
+    , wallContentChanged_( false )
+    , stackingOrder_( 0 )
 {
-    windowContext_->setContextProperty( "contentwindow", contentWindow_.get( ));
-
-    windowItem_ = createQmlItem( QML_WINDOW_URL );
     windowItem_->setParentItem( &parentItem );
+    windowItem_->setProperty( "stackingOrder", stackingOrder_ );
 
-    ContentItem* contentItem =
+    contentItem_ =
        windowItem_->findChild<ContentItem*>( CONTENT_ITEM_OBJECT_NAME );
-    contentItem->setWallContent( wallContent_.get( ));
-    wallContent_->setQmlItem( contentItem );
+    zoomContextItem_ =
+      contentItem_->findChild<ContentItem*>( ZOOM_CONTEXT_ITEM_OBJECT_NAME );
 
-    ContentItem* zoomContextItem =
-      contentItem->findChild<ContentItem*>( ZOOM_CONTEXT_ITEM_OBJECT_NAME );
-    zoomContextItem->setWallContent( wallContent_.get( ));
+    // Synchronized contents take part in collective operations, so they must
+    // exist on all processes even if they are not displayed on this one.
+    const CONTENT_TYPE type = contentWindow_->getContent()->getType();
+    if( WallContent::isSynchronized( type ))
+        createWallContent();
 
-    if( contentWindow_->getContent()->getType() == CONTENT_TYPE_PIXEL_STREAM )
+    if( type == CONTENT_TYPE_PIXEL_STREAM )
         setupPixelStreamItem();
 
     windowItem_->setProperty( "isBackground", isBackground );
@@ -87,35 +105,71 @@ QmlWindowRenderer::QmlWindowRenderer( QDeclarativeEngine& engine,
 
 QmlWindowRenderer::~QmlWindowRenderer()
 {
-    QGraphicsScene* scene = windowItem_->scene();
-    scene->removeItem( windowItem_ );
-    delete windowItem_;
+    contentItem_->setWallContent( 0 );
+    zoomContextItem_->setWallContent( 0 );
+    if( pixelStreamItem_ )
+    {
+        delete pixelStreamItem_;
+        windowContext_->setContextProperty( "pixelstream", 0 );
+    }
+
+    renderContext_.getQmlItemPool().release(
+                pooledItem_, hasDefaultQmlState( *contentWindow_ ));
+}
+
+void QmlWindowRenderer::preload( QmlItemPool& pool )
+{
+    pool.preload( QML_WINDOW_URL );
+    pool.preload( QML_PIXELSTREAM_URL );
 }
 
 void QmlWindowRenderer::update( ContentWindowPtr contentWindow )
 {
-    // Could be optimized by checking for changes before updating the context
-    windowContext_->setContextProperty( "contentwindow", contentWindow.get( ));
-    contentWindow_ = contentWindow;
+    // Keep the same object in the context, so that the qml bindings are only
+    // re-evaluated for the properties which changed.
+    contentWindow_->update( *contentWindow );
 }
 
 void QmlWindowRenderer::setStackingOrder( const int value )
 {
+    if( value == stackingOrder_ )
+        return;
+
+    stackingOrder_ = value;
     windowItem_->setProperty( "stackingOrder", value );
 }
 
 void QmlWindowRenderer::preRenderUpdate( WallToWallChannel& wallChannel,
-                                         const QRect& visibleWallArea )
+                                         const QRegion& visibleWallArea )
 {
-    wallContent_->preRenderUpdate( contentWindow_, visibleWallArea );
+    {
+        PROFILE_SCOPE( "window", "preRenderUpdate" );
+        updateLoading( visibleWallArea );
+        if( !wallContent_ )
+            return;
+        wallContent_->updateVisibility( visibleWallArea );
+        wallContent_->preRenderUpdate( contentWindow_, visibleWallArea );
+    }
+    PROFILE_SCOPE( "window", "preRenderSync" );
     wallContent_->preRenderSync( wallChannel );
 }
 
 void QmlWindowRenderer::postRenderUpdate( WallToWallChannel& wallChannel )
 {
+    if( !wallContent_ )
+        return;
+
+    PROFILE_SCOPE( "window", "postRenderSync" );
     wallContent_->postRenderSync( wallChannel );
 }
 
+bool QmlWindowRenderer::isModified()
+{
+    if( wallContentChanged_ )
+        return true;
+    return wallContent_ && wallContent_->isModified();
+}
+
 WallContentPtr QmlWindowRenderer::getWallContent()
 {
     return wallContent_;
@@ -126,17 +180,68 @@ ContentWindowPtr QmlWindowRenderer::getContentWindow()
     return contentWindow_;
 }
 
-void QmlWindowRenderer::setupPixelStreamItem()
+void QmlWindowRenderer::updateLoading( const QRegion& visibleWallArea )
 {
-    PixelStream* stream = static_cast<PixelStream*>( wallContent_.get( ));
-    windowContext_->setContextProperty( "pixelstream", stream );
-    QDeclarativeItem* pixelStreamItem = createQmlItem( QML_PIXELSTREAM_URL );
-    pixelStreamItem->setParentItem( windowItem_ );
+    wallContentChanged_ = false;
+
+    const bool wasLoaded = loadingPolicy_.isLoaded();
+    const bool load = loadingPolicy_.update( contentItem_->getSceneRect(),
+                                             visibleWallArea );
+
+    const CONTENT_TYPE type = contentWindow_->getContent()->getType();
+    if( WallContent::isSynchronized( type ))
+    {
+        if( load != wasLoaded )
+        {
+            wallContent_->setLoaded( load );
+            wallContentChanged_ = true;
+        }
+        return;
+    }
+
+    if( load && !wallContent_ )
+        createWallContent();
+    else if( !load && wallContent_ )
+        deleteWallContent();
+}
+
+void QmlWindowRenderer::createWallContent()
+{
+    wallContent_ = WallContent::create( *contentWindow_->getContent( ));
+    if( !wallContent_ )
+        return;
+
+    wallContent_->setQmlItem( contentItem_ );
+    wallContent_->setUploadScheduler( &renderContext_.getUploadScheduler( ));
+    wallContent_->setMemoryAccountant( renderContext_.getMemoryAccountant(),
+                                       *contentWindow_ );
+    wallContent_->setContentCache( &renderContext_.getContentCache( ));
+
+    contentItem_->setWallContent( wallContent_.get( ));
+    zoomContextItem_->setWallContent( wallContent_.get( ));
+    wallContentChanged_ = true;
 }
 
-QDeclarativeItem* QmlWindowRenderer::createQmlItem( const QUrl& url )
+void QmlWindowRenderer::deleteWallContent()
 {
-    QDeclarativeComponent component( windowContext_->engine(), url );
-    QObject* qmlObject = component.create( windowContext_.get( ));
-    return qobject_cast<QDeclarativeItem*>( qmlObject );
+    // Free the GL objects now, from the render thread. Contents which can not
+    // release their memory yet (e.g. images still loading) are kept until a
+    // later frame.
+    wallContent_->releaseMemory();
+    if( wallContent_->getMemoryUsage() > 0 )
+        return;
+
+    contentItem_->setWallContent( 0 );
+    zoomContextItem_->setWallContent( 0 );
+    wallContent_.reset();
+    wallContentChanged_ = true;
+}
+
+void QmlWindowRenderer::setupPixelStreamItem()
+{
+    PixelStream* stream = static_cast<PixelStream*>( wallContent_.get( ));
+    windowContext_->setContextProperty( "pixelstream", stream );
+    pixelStreamItem_ = renderContext_.getQmlItemPool().create(
+                           QML_PIXELSTREAM_URL, *windowContext_ );
+    pixelStreamItem_->setParentItem( windowItem_ );
 }
@@ -42,8 +42,10 @@
 
 #include "types.h"
 
+#include "ContentLoadingPolicy.h"
+#include "QmlItemPool.h"
+
 #include <boost/noncopyable.hpp>
-#include <boost/scoped_ptr.hpp>
 
 #include <QGraphicsObject>
 
@@ -51,43 +53,74 @@
 #include <QtDeclarative/QDeclarativeContext>
 #include <QtDeclarative/QDeclarativeItem>
 
+class ContentItem;
+
 /**
  * Provide a Qml representation of a ContentWindow on the Wall.
+ *
+ * The WallContent is only created when the window comes near the screens of
+ * this process, and deleted after it has stayed away from them for a while,
+ * following the ContentLoadingPolicy of the RenderContext. Synchronized
+ * contents always exist and are loaded or unloaded instead.
+ *
+ * The qml item of the window comes from the QmlItemPool of the RenderContext,
+ * and goes back to it when the window is closed. Items are only reused by
+ * windows which are neither selected, focused nor showing their controls.
  */
 class QmlWindowRenderer : public boost::noncopyable
 {
 public:
     /** Constructor. */
-    QmlWindowRenderer( QDeclarativeEngine& engine,
+    QmlWindowRenderer( RenderContext& renderContext,
                        QDeclarativeItem& parentItem,
                        ContentWindowPtr contentWindow,
                        bool isBackground = false );
-    /** Destructor. */
+    /** Destructor, returns the qml item to the pool. */
     ~QmlWindowRenderer();
 
-    /** Update the qml object with a new data model. */
+    /** Compile the qml components of the windows ahead of their creation. */
+    static void preload( QmlItemPool& pool );
+
+    /**
+     * Update the data model of the qml object with a newer copy of it.
+     * Only the properties which changed are notified to the qml object.
+     */
     void update( ContentWindowPtr contentWindow );
 
+    /** Set the stacking order of the qml object, if it changed. */
     void setStackingOrder( int value );
 
     void preRenderUpdate( WallToWallChannel& wallChannel,
-                          const QRect& visibleWallArea );
+                          const QRegion& visibleWallArea );
     void postRenderUpdate( WallToWallChannel& wallChannel );
 
-    /** Get the WallContent. */
+    /** @return true if the content must be rendered again. */
+    bool isModified();
+
+    /** Get the WallContent, which is null while it is not loaded. */
     WallContentPtr getWallContent();
 
     /** Get the ContentWindow. */
     ContentWindowPtr getContentWindow();
 
 private:
+    RenderContext& renderContext_;
     ContentWindowPtr contentWindow_;
-    boost::scoped_ptr<QDeclarativeContext> windowContext_;
+    QmlItemPool::Item pooledItem_;
+    QDeclarativeContext* windowContext_;
     QDeclarativeItem* windowItem_;
+    QDeclarativeItem* pixelStreamItem_;
+    ContentItem* contentItem_;
+    ContentItem* zoomContextItem_;
     WallContentPtr wallContent_;
+    ContentLoadingPolicy loadingPolicy_;
+    bool wallContentChanged_;
+    int stackingOrder_;
 
+    void updateLoading( const QRegion& visibleWallArea );
+    void createWallContent();
+    void deleteWallContent();
     void setupPixelStreamItem();
-    QDeclarativeItem* createQmlItem( const QUrl& url );
 };
 
 #endif // QMLWINDOWRENDERER_H
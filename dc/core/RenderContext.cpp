@@ -40,6 +40,8 @@
 
 #include "configuration/WallConfiguration.h"
 #include "GLWindow.h"
+#include "Metrics.h"
+#include "OffscreenRenderer.h"
 #include "TestPattern.h"
 #include "WallWindow.h"
 #include "log.h"
@@ -48,14 +50,31 @@
 
 #include <boost/foreach.hpp>
 
-RenderContext::RenderContext( const WallConfiguration& configuration )
+RenderContext::RenderContext( const WallConfiguration& configuration,
+                              const bool offscreen )
     : scene_( QRectF( QPointF(), configuration.getTotalSize( )))
+    , frameSync_( configuration.getFramesInFlight( ))
+    , contentLoadingPolicy_( configuration.getPrefetchMargin(),
+                             configuration.getUnloadDelayMs( ))
+    , qmlItemPool_( engine_ )
+{
+    if( offscreen )
+        setupOffscreenRendering( configuration );
+    else
+    {
+        setupOpenGLWindows( configuration );
+        setupVSync();
+    }
+    uploadScheduler_.setBudget( configuration.getUploadBudgetBytes(),
+                                configuration.getUploadBudgetMs( ));
+    memoryAccountant_.setBudget( configuration.getMemoryBudgetBytes( ));
+}
+
+RenderContext::~RenderContext()
 {
-    setupOpenGLWindows( configuration );
-    setupVSync();
 }
 
-const QRect& RenderContext::getVisibleWallArea() const
+const QRegion& RenderContext::getVisibleWallArea() const
 {
     return visibleWallArea_;
 }
@@ -101,6 +120,30 @@ void RenderContext::setupOpenGLWindows( const WallConfiguration& config )
     }
 }
 
+void RenderContext::setupOffscreenRendering( const WallConfiguration& config )
+{
+    try
+    {
+        offscreenRenderer_.reset( new OffscreenRenderer( scene_ ));
+        for( int i = 0; i < config.getScreenCount(); ++i )
+        {
+            const QPoint screenIndex = config.getGlobalScreenIndex( i );
+            const QRect screenRect = config.getScreenRect( screenIndex );
+
+            visibleWallArea_ = visibleWallArea_.united( screenRect );
+
+            offscreenRenderer_->addScreen( screenRect, screenIndex,
+                                TestPatternPtr( new TestPattern( config, i )));
+        }
+    }
+    catch( const std::runtime_error& e )
+    {
+        put_flog( LOG_FATAL, "Error creating the offscreen renderer: '%s'",
+                  e.what( ));
+        throw std::runtime_error( "Failed creating the offscreen renderer." );
+    }
+}
+
 void RenderContext::setupVSync()
 {
     BOOST_FOREACH( WallWindowPtr window, windows_ )
@@ -114,6 +157,14 @@ void RenderContext::setupVSync()
 
 void RenderContext::updateGLWindows()
 {
+    if( offscreenRenderer_ )
+    {
+        // The offscreen context is current after rendering
+        offscreenRenderer_->render();
+        frameSync_.insertFence();
+        return;
+    }
+
     BOOST_FOREACH( WallWindowPtr window, windows_ )
     {
 #ifdef __APPLE__
@@ -124,13 +175,28 @@ void RenderContext::updateGLWindows()
         window->setBlockDrawCalls( false );
         window->viewport()->repaint();
         window->setBlockDrawCalls( true );
+
+        static_cast<QGLWidget*>( window->viewport( ))->makeCurrent();
+        frameSync_.insertFence();
 #endif
     }
-    glFinish();
+}
+
+void RenderContext::waitForGPU()
+{
+    // Without fences (e.g. on OSX), this falls back to glFinish()
+    ScopedDuration waitTime( &Metrics::recordGPUWaitTime );
+    frameSync_.endFrame();
 }
 
 void RenderContext::swapBuffers()
 {
+    if( offscreenRenderer_ )
+    {
+        offscreenRenderer_->finishFrame();
+        return;
+    }
+
     BOOST_FOREACH( WallWindowPtr window, windows_ )
     {
         if( !window->isExposed( ))
@@ -139,7 +205,6 @@ void RenderContext::swapBuffers()
         QGLWidget* glContext = static_cast<QGLWidget*>( window->viewport( ));
         glContext->makeCurrent();
         glContext->swapBuffers();
-        glFlush();
     }
 }
 
@@ -153,8 +218,36 @@ QDeclarativeEngine& RenderContext::getQmlEngine()
     return engine_;
 }
 
+QmlItemPool& RenderContext::getQmlItemPool()
+{
+    return qmlItemPool_;
+}
+
+UploadScheduler& RenderContext::getUploadScheduler()
+{
+    return uploadScheduler_;
+}
+
+MemoryAccountant& RenderContext::getMemoryAccountant()
+{
+    return memoryAccountant_;
+}
+
+ContentCache& RenderContext::getContentCache()
+{
+    return contentCache_;
+}
+
+const ContentLoadingPolicy& RenderContext::getContentLoadingPolicy() const
+{
+    return contentLoadingPolicy_;
+}
+
 void RenderContext::displayFps( const bool value )
 {
+    if( offscreenRenderer_ )
+        offscreenRenderer_->setShowFps( value );
+
     BOOST_FOREACH( WallWindowPtr window, windows_ )
     {
         window->setShowFps( value );
@@ -163,8 +256,19 @@ void RenderContext::displayFps( const bool value )
 
 void RenderContext::displayTestPattern( const bool value )
 {
+    if( offscreenRenderer_ )
+        offscreenRenderer_->displayTestPattern( value );
+
     BOOST_FOREACH( WallWindowPtr window, windows_ )
     {
         window->getTestPattern()->setVisible( value );
     }
 }
+
+void RenderContext::setFrameDumpFolder( const QString& folder )
+{
+    if( offscreenRenderer_ )
+        offscreenRenderer_->setFrameDumpFolder( folder );
+    else if( !folder.isEmpty( ))
+        put_flog( LOG_WARN, "frame dumps are only available offscreen" );
+}
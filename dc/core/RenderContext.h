@@ -42,15 +42,27 @@
 #include "types.h"
 
 #include "WallGraphicsScene.h"
+#include "ContentCache.h"
+#include "ContentLoadingPolicy.h"
+#include "GLFrameSync.h"
+#include "MemoryAccountant.h"
+#include "QmlItemPool.h"
+#include "UploadScheduler.h"
 
 #include <QRectF>
+#include <QRegion>
 #include <QColor>
 #include <QFont>
 
 #include <QtDeclarative/QDeclarativeEngine>
 
+#include <boost/scoped_ptr.hpp>
+
+class OffscreenRenderer;
+
 /**
- * A render context composed of multiple GL windows.
+ * A render context composed of multiple GL windows, or of offscreen
+ * framebuffers when no display is available.
  */
 class RenderContext
 {
@@ -58,19 +70,34 @@ public:
     /**
      * Create a new RenderContext and initialize the GLWindows.
      * @param configuration The configuration that describes the window settings
+     * @param offscreen Render the screens offscreen instead of in windows
      * @throw std::runtime_error if the context initialization failed.
      */
-    RenderContext( const WallConfiguration& configuration );
+    RenderContext( const WallConfiguration& configuration,
+                   bool offscreen = false );
 
-    /** Get the area of the wall which is visible in this context. */
-    const QRect& getVisibleWallArea() const;
+    /** Destructor. */
+    ~RenderContext();
+
+    /** Get the area of the wall covered by the screens of this context. */
+    const QRegion& getVisibleWallArea() const;
 
     /** Set the background color of all windows. */
     void setBackgroundColor( const QColor& color );
 
-    /** Render GL objects on all windows. */
+    /**
+     * Render GL objects on all windows. The GL commands are only submitted,
+     * call waitForGPU() before swapping the buffers.
+     */
     void updateGLWindows();
 
+    /**
+     * Wait for the GPU until less than WallConfiguration::getFramesInFlight()
+     * frames are pending. By default, the frame submitted by the last
+     * updateGLWindows() is complete when this function returns.
+     */
+    void waitForGPU();
+
     /** Swap GL buffers on all windows. */
     void swapBuffers();
 
@@ -80,21 +107,51 @@ public:
     /** Get the QML engine. */
     QDeclarativeEngine& getQmlEngine();
 
+    /** Get the pool of qml items, for the windows which come and go. */
+    QmlItemPool& getQmlItemPool();
+
+    /** Get the scheduler for the texture uploads of the contents. */
+    UploadScheduler& getUploadScheduler();
+
+    /** Get the accountant for the memory used by the contents. */
+    MemoryAccountant& getMemoryAccountant();
+
+    /** Get the cache shared by the contents of all the windows. */
+    ContentCache& getContentCache();
+
+    /** Get the policy for loading the contents, to be copied by windows. */
+    const ContentLoadingPolicy& getContentLoadingPolicy() const;
+
     /** Display or hide the test pattern. */
     void displayTestPattern( bool value );
 
     /** Display or hide the fps counter. */
     void displayFps( bool value );
 
+    /**
+     * Save the offscreen frames as images in the given folder.
+     * Only available in offscreen mode.
+     * @param folder The destination folder, or an empty string to disable
+     */
+    void setFrameDumpFolder( const QString& folder );
+
 private:
     void setupOpenGLWindows( const WallConfiguration& config );
+    void setupOffscreenRendering( const WallConfiguration& config );
     void setupVSync();
 
     WallGraphicsScene scene_;
     WallWindowPtrs windows_;
-    QRect visibleWallArea_;
+    GLFrameSync frameSync_;
+    boost::scoped_ptr<OffscreenRenderer> offscreenRenderer_;
+    QRegion visibleWallArea_;
+    UploadScheduler uploadScheduler_;
+    MemoryAccountant memoryAccountant_;
+    ContentCache contentCache_;
+    ContentLoadingPolicy contentLoadingPolicy_;
 
     QDeclarativeEngine engine_;
+    QmlItemPool qmlItemPool_;
 };
 
 #endif
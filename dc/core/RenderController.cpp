@@ -45,6 +45,7 @@
 
 #include "DisplayGroup.h"
 #include "Options.h"
+#include "Profiler.h"
 #include "WallToWallChannel.h"
 
 #include <boost/make_shared.hpp>
@@ -56,6 +57,10 @@ RenderController::RenderController( RenderContextPtr renderContext )
     , syncQuit_( false )
     , syncDisplayGroup_( boost::make_shared<DisplayGroup>( QSize( )))
     , syncOptions_( boost::make_shared<Options>( ))
+    , sceneChanged_( true )
+    , redrawNeeded_( true )
+    , objectsPrepared_( false )
+    , objectsSwapped_( false )
 {
     syncDisplayGroup_.setCallback( boost::bind(
                                        &DisplayGroupRenderer::setDisplayGroup,
@@ -75,6 +80,10 @@ RenderController::RenderController( RenderContextPtr renderContext )
     connect( displayGroupRenderer_.get(),
              SIGNAL( windowRemoved( QmlWindowPtr )),
              &pixelStreamUpdater_, SLOT( onWindowRemoved( QmlWindowPtr )));
+
+    // Qml animations and other changes to the items of the scene
+    connect( &renderContext_->getScene(), SIGNAL( changed( QList<QRectF> )),
+             this, SLOT( onSceneChanged( )));
 }
 
 DisplayGroupPtr RenderController::getDisplayGroup() const
@@ -89,12 +98,35 @@ PixelStreamUpdater& RenderController::getPixelStreamUpdater()
 
 void RenderController::preRenderUpdate( WallToWallChannel& wallChannel )
 {
-    const SyncFunction& versionCheckFunc =
-        boost::bind( &WallToWallChannel::checkVersion, &wallChannel, _1 );
-
-    synchronizeObjects( versionCheckFunc );
+    // All the processes take the same branch, as they render the same frames
+    if( !objectsPrepared_ )
+        prepareNextFrame( wallChannel );
+    objectsPrepared_ = false;
 
     displayGroupRenderer_->preRenderUpdate( wallChannel );
+
+    {
+        // Free the memory of hidden contents before uploading new textures
+        PROFILE_SCOPE( "frame", "evictContents" );
+        renderContext_->getMemoryAccountant().update();
+    }
+
+    UploadScheduler& uploadScheduler = renderContext_->getUploadScheduler();
+    size_t uploads = 0;
+    {
+        PROFILE_SCOPE( "frame", "processUploads" );
+        uploads = uploadScheduler.processUploads();
+    }
+    const bool uploadsPending = uploadScheduler.getBacklogSize() > 0;
+
+    // Pending updates must be synchronized before all processes can stop
+    // rendering, otherwise the version checks would never succeed.
+    redrawNeeded_ = sceneChanged_ || objectsSwapped_ || hasPendingUpdates() ||
+                    uploads > 0 || uploadsPending ||
+                    displayGroupRenderer_->isModified() ||
+                    syncOptions_.get()->getShowStatistics();
+    sceneChanged_ = false;
+    objectsSwapped_ = false;
 }
 
 void RenderController::postRenderUpdate( WallToWallChannel& wallChannel )
@@ -102,11 +134,26 @@ void RenderController::postRenderUpdate( WallToWallChannel& wallChannel )
     displayGroupRenderer_->postRenderUpdate( wallChannel );
 }
 
+void RenderController::prepareNextFrame( WallToWallChannel& wallChannel )
+{
+    const SyncFunction& versionCheckFunc =
+        boost::bind( &WallToWallChannel::checkVersion, &wallChannel, _1 );
+
+    PROFILE_SCOPE( "frame", "synchronizeObjects" );
+    objectsSwapped_ = synchronizeObjects( versionCheckFunc );
+    objectsPrepared_ = true;
+}
+
 bool RenderController::quitRendering() const
 {
     return syncQuit_.get();
 }
 
+bool RenderController::isRedrawNeeded() const
+{
+    return redrawNeeded_;
+}
+
 void RenderController::updateQuit()
 {
     syncQuit_.update( true );
@@ -127,14 +174,28 @@ void RenderController::updateMarkers( MarkersPtr markers )
     syncMarkers_.update( markers );
 }
 
-void RenderController::synchronizeObjects( const SyncFunction&
+void RenderController::onSceneChanged()
+{
+    sceneChanged_ = true;
+}
+
+bool RenderController::synchronizeObjects( const SyncFunction&
                                            versionCheckFunc )
 {
-    syncQuit_.sync( versionCheckFunc );
-    syncDisplayGroup_.sync( versionCheckFunc );
-    syncMarkers_.sync( versionCheckFunc );
-    syncOptions_.sync( versionCheckFunc );
-    pixelStreamUpdater_.synchronizeFramesSwap( versionCheckFunc );
+    bool swapped = syncQuit_.sync( versionCheckFunc );
+    swapped = syncDisplayGroup_.sync( versionCheckFunc ) || swapped;
+    swapped = syncMarkers_.sync( versionCheckFunc ) || swapped;
+    swapped = syncOptions_.sync( versionCheckFunc ) || swapped;
+    swapped = pixelStreamUpdater_.synchronizeFramesSwap( versionCheckFunc ) ||
+              swapped;
+    return swapped;
+}
+
+bool RenderController::hasPendingUpdates() const
+{
+    return syncQuit_.isPending() || syncDisplayGroup_.isPending() ||
+           syncMarkers_.isPending() || syncOptions_.isPending() ||
+           pixelStreamUpdater_.getPendingFramesCount() > 0;
 }
 
 void RenderController::setRenderOptions( OptionsPtr options )
@@ -70,15 +70,31 @@ public:
     /** Update and synchronize scene objects after rendering a frame. */
     void postRenderUpdate( WallToWallChannel& wallChannel );
 
+    /**
+     * Synchronize the objects received from the master application for the
+     * next frame, while the GPU still renders the current one. Otherwise this
+     * is done by the next preRenderUpdate().
+     */
+    void prepareNextFrame( WallToWallChannel& wallChannel );
+
     /** Do we need to stop rendering. */
     bool quitRendering() const;
 
+    /**
+     * Check if the last preRenderUpdate() changed the scene so that it must
+     * be rendered, or if some updates still need to be synchronized.
+     */
+    bool isRedrawNeeded() const;
+
 public slots:
     void updateQuit();
     void updateDisplayGroup( DisplayGroupPtr displayGroup );
     void updateOptions( OptionsPtr options );
     void updateMarkers( MarkersPtr markers );
 
+private slots:
+    void onSceneChanged();
+
 private:
     Q_DISABLE_COPY( RenderController )
 
@@ -92,7 +108,13 @@ private:
     SwapSyncObject<OptionsPtr> syncOptions_;
     SwapSyncObject<MarkersPtr> syncMarkers_;
 
-    void synchronizeObjects( const SyncFunction& versionCheckFunc );
+    bool sceneChanged_;
+    bool redrawNeeded_;
+    bool objectsPrepared_;
+    bool objectsSwapped_;
+
+    bool synchronizeObjects( const SyncFunction& versionCheckFunc );
+    bool hasPendingUpdates() const;
     void setRenderOptions( OptionsPtr options );
 };
 
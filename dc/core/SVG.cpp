@@ -41,13 +41,22 @@
 #include "log.h"
 #include "ContentWindow.h"
 
+#include <boost/bind.hpp>
+
 namespace
 {
 const int MULTI_SAMPLE_ANTI_ALIASING_SAMPLES = 8;
 const QSize PREVIEW_SIZE( 512, 512 );
+const size_t BYTES_PER_PIXEL = 4;
+
+size_t getFboMemorySize( const QGLFramebufferObject& fbo )
+{
+    return BYTES_PER_PIXEL * fbo.width() * fbo.height();
+}
 }
 
 SVG::SVG( const QString& uri )
+    : uri_( uri )
 {
     // flip the y texture coordinate since the textures are loaded upside down
     quad_.setTexCoords( QRectF( 0.0, 1.0, 1.0, -1.0 ));
@@ -97,22 +106,46 @@ void SVG::renderPreview()
     quad_.render();
 }
 
-void SVG::preRenderUpdate( ContentWindowPtr window, const QRect& wallArea )
+void SVG::preRenderUpdate( ContentWindowPtr window, const QRegion& wallArea )
 {
     if( window->isResizing() || _qmlItem->isAnimating( ))
         return;
 
-    if( !QRectF( wallArea ).intersects( _qmlItem->getSceneRect( )))
+    if( !_isVisibleIn( wallArea ))
         return;
 
     const QSize& renderSize = _qmlItem->getSceneRect().size().toSize();
     if( getTextureSize() != renderSize ||
         getTextureRegion() != window->getZoomRect( ))
     {
-        updateTexture( renderSize, window->getZoomRect( ));
+        if( findSharedTexture( renderSize, window->getZoomRect( )))
+            return;
+
+        const size_t size = renderSize.width() * renderSize.height() * 4;
+        _scheduleUpload( *window, wallArea, size,
+                         boost::bind( &SVG::updateTexture, this, renderSize,
+                                      window->getZoomRect( )));
     }
 }
 
+size_t SVG::getMemoryUsage() const
+{
+    size_t usage = 0;
+    if( textureData_.fbo )
+        usage += getFboMemorySize( *textureData_.fbo ) /
+                 textureData_.fbo.use_count();
+    if( previewFbo_ )
+        usage += getFboMemorySize( *previewFbo_ ) / previewFbo_.use_count();
+    return usage;
+}
+
+void SVG::releaseMemory()
+{
+    textureData_.fbo.reset();
+    textureData_.region = QRectF();
+    previewFbo_.reset();
+}
+
 QSize SVG::getTextureSize() const
 {
     return textureData_.fbo ? textureData_.fbo->size() : QSize();
@@ -128,25 +161,44 @@ void SVG::updateTexture( const QSize& textureSize, const QRectF& svgRegion )
     if( !svgRenderer_.isValid( ))
         return;
 
-    const bool recreateTextureFbo = !textureData_.fbo ||
-                                    getTextureSize() != textureSize;
+    if( getTextureSize() == textureSize && svgRegion == textureData_.region )
+        return;
 
-    if( recreateTextureFbo || svgRegion != textureData_.region )
-    {
-        if( recreateTextureFbo )
-            textureData_.fbo.reset( new QGLFramebufferObject( textureSize ));
+    // Another window may have rendered the same texture in the meantime
+    if( findSharedTexture( textureSize, svgRegion ))
+        return;
 
-        renderToTexture( svgRegion, textureData_.fbo );
-        textureData_.region = svgRegion;
-    }
+    // The texture may be shared with other windows, so a new one is created
+    // instead of rendering the new region in place.
+    textureData_.fbo.reset( new QGLFramebufferObject( textureSize ));
+    renderToTexture( svgRegion, textureData_.fbo );
+    textureData_.region = svgRegion;
+    _share( ContentCache::makeKey( uri_, textureSize, svgRegion ),
+            textureData_.fbo );
+}
 
-    assert( textureData_.fbo );
+bool SVG::findSharedTexture( const QSize& textureSize, const QRectF& svgRegion )
+{
+    const QString key = ContentCache::makeKey( uri_, textureSize, svgRegion );
+    FBOPtr fbo = _findShared<QGLFramebufferObject>( key );
+    if( !fbo )
+        return false;
+
+    textureData_.fbo = fbo;
+    textureData_.region = svgRegion;
+    return true;
 }
 
 void SVG::generatePreviewTexture()
 {
+    const QString key = ContentCache::makeKey( uri_, PREVIEW_SIZE, UNIT_RECTF );
+    previewFbo_ = _findShared<QGLFramebufferObject>( key );
+    if( previewFbo_ )
+        return;
+
     previewFbo_.reset( new QGLFramebufferObject( PREVIEW_SIZE ));
     renderToTexture( UNIT_RECTF, previewFbo_ );
+    _share( key, previewFbo_ );
 }
 
 bool SVG::setImageData( const QByteArray& imageData )
@@ -71,6 +71,7 @@ public:
     QSize getSize() const;
 
 private:
+    QString uri_;
     QRectF svgExtents_;
     QSvgRenderer svgRenderer_;
 
@@ -81,11 +82,15 @@ private:
     void render() override;
     void renderPreview() override;
     void preRenderUpdate( ContentWindowPtr window,
-                          const QRect& wallArea ) override;
+                          const QRegion& wallArea ) override;
+    size_t getMemoryUsage() const override;
+    void releaseMemory() override;
 
     QSize getTextureSize() const;
     const QRectF& getTextureRegion() const;
     void updateTexture( const QSize& textureSize, const QRectF& svgRegion );
+    bool findSharedTexture( const QSize& textureSize,
+                            const QRectF& svgRegion );
 
     void generatePreviewTexture();
     bool setImageData( const QByteArray& imageData );
@@ -0,0 +1,86 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+#ifndef SHAREDMEMORYBROADCASTTRANSPORT_H
+#define SHAREDMEMORYBROADCASTTRANSPORT_H
+
+#include "BroadcastTransport.h"
+#include "SharedMemoryRing.h"
+
+#include <memory>
+
+/**
+ * Send messages to the walls of the same host through a shared memory ring.
+ */
+class SharedMemoryBroadcastSender : public BroadcastSender
+{
+public:
+    /**
+     * Constructor.
+     * @param ring The ring, already opened by all the wall processes
+     */
+    SharedMemoryBroadcastSender( std::unique_ptr< SharedMemoryRing > ring );
+
+    void send( const MPIHeader& header, std::string& data ) override;
+    void flush() override;
+
+private:
+    std::unique_ptr< SharedMemoryRing > _ring;
+};
+
+/**
+ * Receive messages from the master of the same host through a shared memory
+ * ring. The messages are not copied.
+ */
+class SharedMemoryBroadcastReceiver : public BroadcastReceiver
+{
+public:
+    /**
+     * Constructor.
+     * @param ring The ring created by the master process
+     */
+    SharedMemoryBroadcastReceiver( std::unique_ptr< SharedMemoryRing > ring );
+
+    const char* receive( MPIHeader& header ) override;
+
+private:
+    std::unique_ptr< SharedMemoryRing > _ring;
+};
+
+#endif // SHAREDMEMORYBROADCASTTRANSPORT_H
@@ -0,0 +1,362 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+#include "SharedMemoryRing.h"
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+const unsigned int SharedMemoryRing::MAX_READERS = 256;
+
+/** The control block at the beginning of the shared memory. */
+struct RingControl
+{
+    uint64_t capacity;
+    uint32_t readerCount;
+
+    // Futex words, incremented each time a position changes
+    std::atomic< uint32_t > writeSignal;
+    std::atomic< uint32_t > readSignal;
+
+    std::atomic< uint64_t > writePosition;
+    std::atomic< uint64_t > readPositions[1]; // readerCount entries
+};
+
+namespace
+{
+const uint64_t PADDING = UINT64_MAX;
+const size_t ALIGNMENT = 8;
+
+/** Each message or fragment in the ring is preceded by a record header. */
+struct RecordHeader
+{
+    /** Size of the record including this header, or of the padding. */
+    uint64_t recordSize;
+
+    /** Size of the whole message, or PADDING up to the end of the ring. */
+    uint64_t messageSize;
+
+    /** Offset of this fragment in the message. */
+    uint64_t offset;
+
+    MPIHeader header;
+};
+
+size_t align( const size_t size )
+{
+    return ( size + ALIGNMENT - 1 ) / ALIGNMENT * ALIGNMENT;
+}
+
+size_t getControlSize( const unsigned int readerCount )
+{
+    return align( sizeof( RingControl ) +
+                  ( readerCount - 1 ) * sizeof( std::atomic< uint64_t > ));
+}
+
+void futexWait( std::atomic< uint32_t >& word, const uint32_t expected )
+{
+    syscall( SYS_futex, reinterpret_cast< uint32_t* >( &word ), FUTEX_WAIT,
+             expected, 0, 0, 0 );
+}
+
+void futexWakeAll( std::atomic< uint32_t >& word )
+{
+    syscall( SYS_futex, reinterpret_cast< uint32_t* >( &word ), FUTEX_WAKE,
+             INT_MAX, 0, 0, 0 );
+}
+
+void signal( std::atomic< uint32_t >& word )
+{
+    word.fetch_add( 1, std::memory_order_release );
+    futexWakeAll( word );
+}
+
+std::runtime_error systemError( const std::string& what,
+                                const std::string& name )
+{
+    return std::runtime_error( what + " '" + name + "': " +
+                               std::strerror( errno ));
+}
+}
+
+SharedMemoryRing::SharedMemoryRing( const std::string& name,
+                                    const size_t capacity,
+                                    const unsigned int readerCount )
+    : _name( name )
+    , _isWriter( true )
+    , _readerIndex( 0 )
+    , _mapping( 0 )
+    , _mappingSize( 0 )
+    , _control( 0 )
+    , _buffer( 0 )
+    , _capacity( align( capacity ))
+    , _position( 0 )
+    , _holdsMessage( false )
+{
+    if( readerCount == 0 || readerCount > MAX_READERS )
+        throw std::runtime_error( "Invalid number of shared memory readers" );
+    if( _capacity < 4 * sizeof( RecordHeader ))
+        throw std::runtime_error( "Shared memory ring is too small" );
+
+    const int fd = shm_open( name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600 );
+    if( fd < 0 )
+        throw systemError( "Could not create shared memory", name );
+
+    const size_t size = getControlSize( readerCount ) + _capacity;
+    if( ftruncate( fd, size ) != 0 )
+    {
+        ::close( fd );
+        shm_unlink( name.c_str( ));
+        throw systemError( "Could not allocate shared memory", name );
+    }
+    _map( fd, size );
+
+    _control = new( _mapping ) RingControl;
+    _control->capacity = _capacity;
+    _control->readerCount = readerCount;
+    _control->writeSignal = 0;
+    _control->readSignal = 0;
+    _control->writePosition = 0;
+    for( unsigned int i = 0; i < readerCount; ++i )
+        new( &_control->readPositions[i] ) std::atomic< uint64_t >( 0 );
+    _buffer = static_cast< char* >( _mapping ) + getControlSize( readerCount );
+}
+
+SharedMemoryRing::SharedMemoryRing( const std::string& name,
+                                    const unsigned int readerIndex )
+    : _name( name )
+    , _isWriter( false )
+    , _readerIndex( readerIndex )
+    , _mapping( 0 )
+    , _mappingSize( 0 )
+    , _control( 0 )
+    , _buffer( 0 )
+    , _capacity( 0 )
+    , _position( 0 )
+    , _holdsMessage( false )
+{
+    const int fd = shm_open( name.c_str(), O_RDWR, 0600 );
+    if( fd < 0 )
+        throw systemError( "Could not open shared memory", name );
+
+    struct stat info;
+    if( fstat( fd, &info ) != 0 )
+    {
+        ::close( fd );
+        throw systemError( "Could not open shared memory", name );
+    }
+    _map( fd, info.st_size );
+
+    _control = static_cast< RingControl* >( _mapping );
+    if( readerIndex >= _control->readerCount )
+        throw std::runtime_error( "Invalid shared memory reader index" );
+
+    _capacity = _control->capacity;
+    _buffer = static_cast< char* >( _mapping ) +
+              getControlSize( _control->readerCount );
+}
+
+SharedMemoryRing::~SharedMemoryRing()
+{
+    munmap( _mapping, _mappingSize );
+}
+
+void SharedMemoryRing::_map( const int fd, const size_t size )
+{
+    _mapping = mmap( 0, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+    ::close( fd );
+    if( _mapping == MAP_FAILED )
+        throw systemError( "Could not map shared memory", _name );
+    _mappingSize = size;
+}
+
+void SharedMemoryRing::unlink()
+{
+    shm_unlink( _name.c_str( ));
+}
+
+const std::string& SharedMemoryRing::getName() const
+{
+    return _name;
+}
+
+void SharedMemoryRing::write( const MPIHeader& header, const char* data )
+{
+    const size_t maxFragmentSize =
+            ( _capacity / 2 - sizeof( RecordHeader )) / ALIGNMENT * ALIGNMENT;
+
+    // Small messages are written in one piece, even if empty
+    size_t offset = 0;
+    do
+    {
+        const size_t size = std::min< size_t >( header.size - offset,
+                                                maxFragmentSize );
+        _writeRecord( header, data + offset, size, offset );
+        offset += size;
+    }
+    while( offset < header.size );
+}
+
+void SharedMemoryRing::_writeRecord( const MPIHeader& header, const char* data,
+                                     const size_t size, const uint64_t offset )
+{
+    const size_t recordSize = align( sizeof( RecordHeader ) + size );
+
+    // Records are contiguous, skip the end of the ring if it is too small
+    const size_t ringOffset = _position % _capacity;
+    const size_t padding = _capacity - ringOffset < recordSize ?
+                               _capacity - ringOffset : 0;
+    _waitForSpace( _position + padding + recordSize );
+
+    if( padding >= sizeof( RecordHeader ))
+    {
+        RecordHeader* record =
+                reinterpret_cast< RecordHeader* >( _buffer + ringOffset );
+        record->recordSize = padding;
+        record->messageSize = PADDING;
+    }
+    _position += padding;
+
+    RecordHeader* record = reinterpret_cast< RecordHeader* >(
+                               _buffer + _position % _capacity );
+    record->recordSize = recordSize;
+    record->messageSize = header.size;
+    record->offset = offset;
+    record->header = header;
+    std::memcpy( record + 1, data, size );
+    _position += recordSize;
+
+    _control->writePosition.store( _position, std::memory_order_release );
+    signal( _control->writeSignal );
+}
+
+void SharedMemoryRing::_waitForSpace( const uint64_t end )
+{
+    while( true )
+    {
+        const uint32_t readSignal =
+                _control->readSignal.load( std::memory_order_acquire );
+
+        uint64_t slowestReader = _position;
+        for( unsigned int i = 0; i < _control->readerCount; ++i )
+            slowestReader = std::min< uint64_t >(
+                slowestReader, _control->readPositions[i].load(
+                                   std::memory_order_acquire ));
+        if( end - slowestReader <= _capacity )
+            return;
+
+        futexWait( _control->readSignal, readSignal );
+    }
+}
+
+const char* SharedMemoryRing::read( MPIHeader& header )
+{
+    if( _holdsMessage )
+        _release();
+
+    while( true )
+    {
+        const uint32_t writeSignal =
+                _control->writeSignal.load( std::memory_order_acquire );
+        if( _control->writePosition.load( std::memory_order_acquire ) ==
+                _position )
+        {
+            futexWait( _control->writeSignal, writeSignal );
+            continue;
+        }
+
+        const size_t ringOffset = _position % _capacity;
+        if( _capacity - ringOffset < sizeof( RecordHeader ))
+        {
+            _position += _capacity - ringOffset;
+            continue;
+        }
+
+        const RecordHeader* record =
+                reinterpret_cast< RecordHeader* >( _buffer + ringOffset );
+        if( record->messageSize == PADDING )
+        {
+            _position += record->recordSize;
+            continue;
+        }
+
+        const size_t size = record->recordSize - sizeof( RecordHeader );
+        const char* data = reinterpret_cast< const char* >( record + 1 );
+        _position += record->recordSize;
+
+        if( record->offset == 0 && record->messageSize <= size )
+        {
+            header = record->header;
+            _holdsMessage = true;
+            return data;
+        }
+
+        // Fragments are copied, so that the writer can reuse their space
+        _reassemblyBuffer.resize( record->messageSize );
+        const size_t fragmentSize = std::min< size_t >(
+                    size, record->messageSize - record->offset );
+        std::memcpy( _reassemblyBuffer.data() + record->offset, data,
+                     fragmentSize );
+        const bool complete =
+                record->offset + fragmentSize == record->messageSize;
+        header = record->header;
+        _release();
+
+        if( complete )
+            return _reassemblyBuffer.data();
+    }
+}
+
+void SharedMemoryRing::_release()
+{
+    _control->readPositions[_readerIndex].store( _position,
+                                                 std::memory_order_release );
+    signal( _control->readSignal );
+    _holdsMessage = false;
+}
@@ -0,0 +1,137 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+#ifndef SHAREDMEMORYRING_H
+#define SHAREDMEMORYRING_H
+
+#include "MPIHeader.h"
+
+#include <boost/noncopyable.hpp>
+
+#include <string>
+#include <vector>
+
+struct RingControl;
+
+/**
+ * A single-producer, multi-consumer ring buffer in POSIX shared memory, which
+ * delivers every message to all the readers of the host.
+ *
+ * Readers access messages in place, without copying them. Each message stays
+ * valid until the next call to read(), and the writer blocks while a reader
+ * still uses the space it needs. Messages larger than half of the ring are
+ * split by the writer and reassembled in a private buffer by the readers.
+ *
+ * Processes wait for each other with futexes (Linux only).
+ */
+class SharedMemoryRing : public boost::noncopyable
+{
+public:
+    /** Maximum number of readers of a ring. */
+    static const unsigned int MAX_READERS;
+
+    /**
+     * Create a new ring, to be written to by this process.
+     * @param name The name of the shared memory object, starting with '/'
+     * @param capacity The size of the ring buffer in bytes
+     * @param readerCount The number of readers, which must all read every
+     *        message
+     * @throw std::runtime_error if the shared memory can not be created
+     */
+    SharedMemoryRing( const std::string& name, size_t capacity,
+                      unsigned int readerCount );
+
+    /**
+     * Open an existing ring, to be read by this process.
+     * @param name The name of the shared memory object
+     * @param readerIndex The index of this reader, in [0, readerCount[
+     * @throw std::runtime_error if the shared memory can not be opened
+     */
+    SharedMemoryRing( const std::string& name, unsigned int readerIndex );
+
+    /** Unmap the shared memory. */
+    ~SharedMemoryRing();
+
+    /**
+     * Remove the name of the shared memory object, once all the readers have
+     * opened it. The memory is released when the last process unmaps it.
+     */
+    void unlink();
+
+    /** @return the name of the shared memory object. */
+    const std::string& getName() const;
+
+    /**
+     * Write a message, blocking until there is enough free space.
+     * @param header The header of the message
+     * @param data The payload, of size header.size
+     */
+    void write( const MPIHeader& header, const char* data );
+
+    /**
+     * Read the next message, blocking until it is available.
+     * The previous message is released.
+     * @param header The header of the message
+     * @return the payload, valid until the next call to read()
+     */
+    const char* read( MPIHeader& header );
+
+private:
+    std::string _name;
+    bool _isWriter;
+    unsigned int _readerIndex;
+
+    void* _mapping;
+    size_t _mappingSize;
+    RingControl* _control;
+    char* _buffer;
+    size_t _capacity;
+
+    uint64_t _position;
+    bool _holdsMessage;
+    std::vector< char > _reassemblyBuffer;
+
+    void _map( int fd, size_t size );
+    void _writeRecord( const MPIHeader& header, const char* data,
+                       size_t size, uint64_t offset );
+    void _waitForSpace( uint64_t end );
+    void _release();
+};
+
+#endif // SHAREDMEMORYRING_H
@@ -75,6 +75,12 @@ public:
         return frontObject_;
     }
 
+    /** @return true if the back object is waiting to be swapped. */
+    bool isPending() const
+    {
+        return frontObject_ != backObject_;
+    }
+
     /** Update the back object. */
     void update(const T& newObject)
     {
@@ -43,6 +43,8 @@
 
 #include <QtGui/QImageReader>
 
+#include <boost/bind.hpp>
+
 Texture::Texture( const QString& uri )
     : uri_( uri )
 {
@@ -58,6 +60,14 @@ Texture::Texture( const QString& uri )
 
 bool Texture::generateTexture()
 {
+    // Another window may have uploaded the same image in the meantime
+    boost::shared_ptr<GLTexture2D> texture = _findShared<GLTexture2D>( uri_ );
+    if( texture )
+    {
+        setTexture( texture );
+        return true;
+    }
+
     const QImage image( uri_ );
     if( image.isNull( ))
     {
@@ -65,14 +75,27 @@ bool Texture::generateTexture()
                   uri_.toLocal8Bit().constData( ));
         return false;
     }
-    quad_.enableAlphaBlending( image.hasAlphaChannel( ));
 
-    return texture_.init( image, GL_BGRA, true );
+    texture.reset( new GLTexture2D );
+    if( !texture->init( image, GL_BGRA, true ))
+        return false;
+
+    _share( uri_, texture );
+    setTexture( texture );
+    return true;
+}
+
+void Texture::setTexture( boost::shared_ptr<GLTexture2D> texture )
+{
+    texture_ = texture;
+    quad_.enableAlphaBlending( texture_->hasAlphaChannel( ));
+    quad_.setTexture( texture_->getTextureId( ));
+    previewQuad_.setTexture( texture_->getTextureId( ));
 }
 
 void Texture::render()
 {
-    if( !texture_.isValid( ))
+    if( !texture_ )
         return;
 
     quad_.render();
@@ -80,19 +103,38 @@ void Texture::render()
 
 void Texture::renderPreview()
 {
-    if( !texture_.isValid( ))
+    if( !texture_ )
         return;
 
     previewQuad_.render();
 }
 
-void Texture::preRenderUpdate( ContentWindowPtr window, const QRect& )
+void Texture::preRenderUpdate( ContentWindowPtr window,
+                               const QRegion& wallArea )
 {
-    if( !texture_.isValid( ))
-        generateTexture();
+    if( !texture_ && _isVisibleIn( wallArea ))
+    {
+        boost::shared_ptr<GLTexture2D> texture =
+                _findShared<GLTexture2D>( uri_ );
+        if( texture )
+            setTexture( texture );
+        else
+        {
+            const size_t size = imageSize_.width() * imageSize_.height() * 4;
+            _scheduleUpload( *window, wallArea, size,
+                             boost::bind( &Texture::generateTexture, this ));
+        }
+    }
 
     quad_.setTexCoords( window->getZoomRect( ));
-    quad_.setTexture( texture_.getTextureId( ));
+}
 
-    previewQuad_.setTexture( texture_.getTextureId( ));
+size_t Texture::getMemoryUsage() const
+{
+    return texture_ ? texture_->getMemorySize() / texture_.use_count() : 0;
+}
+
+void Texture::releaseMemory()
+{
+    texture_.reset();
 }
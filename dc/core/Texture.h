@@ -53,16 +53,19 @@ private:
     QString uri_;
     QSize imageSize_;
 
-    GLTexture2D texture_;
+    boost::shared_ptr<GLTexture2D> texture_;
     GLQuad quad_;
     GLQuad previewQuad_;
 
     void render() override;
     void renderPreview() override;
     void preRenderUpdate( ContentWindowPtr window,
-                          const QRect& wallArea ) override;
+                          const QRegion& wallArea ) override;
+    size_t getMemoryUsage() const override;
+    void releaseMemory() override;
 
     bool generateTexture();
+    void setTexture( boost::shared_ptr<GLTexture2D> texture );
 };
 
 #endif
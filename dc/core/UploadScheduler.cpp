@@ -0,0 +1,143 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+#include "UploadScheduler.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace
+{
+typedef std::chrono::steady_clock Clock;
+
+double getElapsedMs( const Clock::time_point& start )
+{
+    const std::chrono::duration< double, std::milli > elapsed =
+            Clock::now() - start;
+    return elapsed.count();
+}
+}
+
+const size_t UploadScheduler::DEFAULT_BUDGET_BYTES = 64 * 1024 * 1024;
+const double UploadScheduler::DEFAULT_BUDGET_MS = 8.0;
+
+UploadScheduler::UploadScheduler()
+    : _budgetBytes( DEFAULT_BUDGET_BYTES )
+    , _budgetMs( DEFAULT_BUDGET_MS )
+    , _backlogSize( 0 )
+    , _backlogBytes( 0 )
+    , _worstFrameTime( 0.0 )
+{
+}
+
+void UploadScheduler::setBudget( const size_t bytes, const double milliseconds )
+{
+    _budgetBytes = bytes;
+    _budgetMs = milliseconds;
+}
+
+size_t UploadScheduler::getBudgetBytes() const
+{
+    return _budgetBytes;
+}
+
+double UploadScheduler::getBudgetMs() const
+{
+    return _budgetMs;
+}
+
+void UploadScheduler::schedule( const double priority, const size_t sizeBytes,
+                                const UploadFunction& upload )
+{
+    const Upload entry = { priority, sizeBytes, upload };
+    _uploads.push_back( entry );
+}
+
+size_t UploadScheduler::processUploads()
+{
+    std::stable_sort( _uploads.begin(), _uploads.end(),
+                      []( const Upload& a, const Upload& b )
+                      { return a.priority > b.priority; } );
+
+    const Clock::time_point start = Clock::now();
+
+    size_t count = 0;
+    size_t bytes = 0;
+    _backlogSize = 0;
+    _backlogBytes = 0;
+
+    for( const Upload& upload : _uploads )
+    {
+        const bool overBudget = bytes + upload.sizeBytes > _budgetBytes ||
+                                getElapsedMs( start ) >= _budgetMs;
+        if( count > 0 && overBudget )
+        {
+            ++_backlogSize;
+            _backlogBytes += upload.sizeBytes;
+            continue;
+        }
+        upload.function();
+        bytes += upload.sizeBytes;
+        ++count;
+    }
+    _uploads.clear();
+
+    _worstFrameTime = std::max( _worstFrameTime, getElapsedMs( start ));
+    return count;
+}
+
+size_t UploadScheduler::getBacklogSize() const
+{
+    return _backlogSize;
+}
+
+size_t UploadScheduler::getBacklogBytes() const
+{
+    return _backlogBytes;
+}
+
+double UploadScheduler::getWorstFrameTime() const
+{
+    return _worstFrameTime;
+}
+
+void UploadScheduler::resetWorstFrameTime()
+{
+    _worstFrameTime = 0.0;
+}
@@ -0,0 +1,138 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+#ifndef UPLOADSCHEDULER_H
+#define UPLOADSCHEDULER_H
+
+#include <boost/function/function0.hpp>
+#include <boost/noncopyable.hpp>
+
+#include <vector>
+
+/**
+ * Limit the amount of texture uploads done in each frame by the wall
+ * processes.
+ *
+ * Contents schedule their uploads during the pre-render update with a
+ * priority. At the end of the update, the uploads with the highest priority
+ * are executed until the size or time budget of the frame is exhausted. The
+ * contents keep a placeholder until their upload is done, and must schedule
+ * the uploads which were not executed again in the next frame.
+ *
+ * At least one upload is done per frame, even if it exceeds the budget, so
+ * that large textures are uploaded eventually.
+ */
+class UploadScheduler : public boost::noncopyable
+{
+public:
+    /** A function doing the upload, called from the rendering thread. */
+    typedef boost::function< void() > UploadFunction;
+
+    /** Default maximum size of the uploads in one frame, in bytes. */
+    static const size_t DEFAULT_BUDGET_BYTES;
+
+    /** Default maximum time spent uploading in one frame, in milliseconds. */
+    static const double DEFAULT_BUDGET_MS;
+
+    /** Constructor. */
+    UploadScheduler();
+
+    /**
+     * Set the budget of a frame.
+     * @param bytes The maximum size of the uploads in bytes
+     * @param milliseconds The maximum time spent uploading
+     */
+    void setBudget( size_t bytes, double milliseconds );
+
+    /** @return the maximum size of the uploads of a frame in bytes. */
+    size_t getBudgetBytes() const;
+
+    /** @return the maximum time spent uploading in a frame. */
+    double getBudgetMs() const;
+
+    /**
+     * Schedule an upload for the current frame.
+     * @param priority The priority of the upload, higher values first
+     * @param sizeBytes The estimated size of the upload in bytes
+     * @param upload The function doing the upload
+     */
+    void schedule( double priority, size_t sizeBytes,
+                   const UploadFunction& upload );
+
+    /**
+     * Execute the scheduled uploads within the budget of the frame and discard
+     * the others.
+     * @return the number of uploads which were executed
+     */
+    size_t processUploads();
+
+    /** @return the number of uploads which did not fit in the last frame. */
+    size_t getBacklogSize() const;
+
+    /** @return the size of the uploads which did not fit in the last frame. */
+    size_t getBacklogBytes() const;
+
+    /**
+     * @return the longest time spent uploading in a frame since the last call
+     *         to resetWorstFrameTime(), in milliseconds.
+     */
+    double getWorstFrameTime() const;
+
+    /** Reset the worst frame time. */
+    void resetWorstFrameTime();
+
+private:
+    struct Upload
+    {
+        double priority;
+        size_t sizeBytes;
+        UploadFunction function;
+    };
+
+    size_t _budgetBytes;
+    double _budgetMs;
+
+    std::vector< Upload > _uploads;
+
+    size_t _backlogSize;
+    size_t _backlogBytes;
+    double _worstFrameTime;
+};
+
+#endif // UPLOADSCHEDULER_H
@@ -41,6 +41,7 @@
 
 #include "config.h"
 #include "Content.h"
+#include "ContentWindow.h"
 
 #include "DynamicTexture.h"
 #include "Movie.h"
@@ -51,13 +52,33 @@
 
 #include <boost/make_shared.hpp>
 
+namespace
+{
+// Windows with which the user interacts are uploaded before any other window,
+// whatever their visible area.
+const double INTERACTION_PRIORITY = 1e12;
+
+double getArea( const QRegion& region )
+{
+    double area = 0.0;
+    for( const QRect& rect : region.rects( ))
+        area += double( rect.width( )) * rect.height();
+    return area;
+}
+}
+
 WallContent::WallContent()
     : _qmlItem( 0 )
+    , _uploadScheduler( 0 )
+    , _memoryAccountant( 0 )
+    , _contentCache( 0 )
 {
 }
 
 WallContent::~WallContent()
 {
+    if( _memoryAccountant )
+        _memoryAccountant->remove( *this );
 }
 
 WallContentPtr WallContent::create( const Content& content )
@@ -83,7 +104,67 @@ WallContentPtr WallContent::create( const Content& content )
     }
 }
 
+bool WallContent::isSynchronized( const CONTENT_TYPE type )
+{
+    return type == CONTENT_TYPE_MOVIE || type == CONTENT_TYPE_PIXEL_STREAM;
+}
+
 void WallContent::setQmlItem( ContentItem* qmlItem )
 {
     _qmlItem = qmlItem;
 }
+
+bool WallContent::_isVisibleIn( const QRegion& visibleWallArea ) const
+{
+    const QRect itemRect = _qmlItem->getSceneRect().toAlignedRect();
+    return visibleWallArea.intersects( itemRect );
+}
+
+void WallContent::setUploadScheduler( UploadScheduler* scheduler )
+{
+    _uploadScheduler = scheduler;
+}
+
+void WallContent::setMemoryAccountant( MemoryAccountant& accountant,
+                                       const ContentWindow& window )
+{
+    if( _memoryAccountant )
+        _memoryAccountant->remove( *this );
+
+    _memoryAccountant = &accountant;
+    const CONTENT_TYPE type = window.getContent()->getType();
+    _memoryAccountant->add( *this, window.getID().toString(),
+                            getContentTypeString( type ));
+}
+
+void WallContent::setContentCache( ContentCache* cache )
+{
+    _contentCache = cache;
+}
+
+void WallContent::updateVisibility( const QRegion& visibleWallArea )
+{
+    if( _memoryAccountant )
+        _memoryAccountant->setVisible( *this, _isVisibleIn( visibleWallArea ));
+}
+
+void WallContent::_scheduleUpload( const ContentWindow& window,
+                                   const QRegion& visibleWallArea,
+                                   const size_t sizeBytes,
+                                   const UploadScheduler::UploadFunction& upload )
+{
+    if( !_uploadScheduler )
+    {
+        upload();
+        return;
+    }
+
+    const QRect itemRect = _qmlItem->getSceneRect().toAlignedRect();
+    double priority = getArea( visibleWallArea.intersected( itemRect ));
+    if( window.isFocused() || window.isSelected() || window.isMoving() ||
+        window.isResizing( ))
+    {
+        priority += INTERACTION_PRIORITY;
+    }
+    _uploadScheduler->schedule( priority, sizeBytes, upload );
+}
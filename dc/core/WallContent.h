@@ -42,14 +42,20 @@
 
 #include "types.h"
 
+#include "ContentCache.h"
 #include "ContentItem.h"
+#include "ContentType.h"
+#include "MemoryAccountant.h"
+#include "UploadScheduler.h"
+
+#include <QRegion>
 
 /**
  * A content to be rendered by Wall processes.
  *
  * An implementation must exist for every valid ContentType.
  */
-class WallContent
+class WallContent : public MemoryAccountant::Client
 {
 public:
     /** Destructor. */
@@ -61,9 +67,14 @@ public:
     /** Render the preview ( whole object at low resolution.). */
     virtual void renderPreview() = 0;
 
-    /** Update internal state before rendering. */
+    /**
+     * Update internal state before rendering.
+     * @param window The window of the content
+     * @param visibleWallArea The area of the wall covered by the screens of
+     *        this process
+     */
     virtual void preRenderUpdate( ContentWindowPtr window,
-                                  const QRect& visibleWallArea ) = 0;
+                                  const QRegion& visibleWallArea ) = 0;
 
     /** Optional synchronization step before rendering. */
     virtual void preRenderSync( WallToWallChannel& wallToWallChannel )
@@ -71,6 +82,12 @@ public:
         Q_UNUSED( wallToWallChannel )
     }
 
+    /**
+     * Check if the content has changed and must be rendered again, for
+     * instance because a new frame was decoded. Called after preRenderSync().
+     */
+    virtual bool isModified() { return false; }
+
     /** Optional synchronization step after rendering. */
     virtual void postRenderSync( WallToWallChannel& wallToWallChannel )
     {
@@ -80,14 +97,104 @@ public:
     /** Set a reference to the Qml item using this content. */
     void setQmlItem( ContentItem* content );
 
+    /**
+     * Set the scheduler for the texture uploads of this content.
+     * Without a scheduler, uploads are done immediately.
+     */
+    void setUploadScheduler( UploadScheduler* scheduler );
+
+    /**
+     * Register the memory used by this content with an accountant, which may
+     * evict it when it is not visible.
+     * @param accountant The accountant, which must outlive this object
+     * @param window The window of the content
+     */
+    void setMemoryAccountant( MemoryAccountant& accountant,
+                              const ContentWindow& window );
+
+    /**
+     * Set the cache used to share images and textures with the other windows
+     * showing the same data. Without a cache, nothing is shared.
+     */
+    void setContentCache( ContentCache* cache );
+
+    /**
+     * Report to the memory accountant if the content is visible in this frame.
+     * @param visibleWallArea The area of the wall covered by the screens of
+     *        this process
+     */
+    void updateVisibility( const QRegion& visibleWallArea );
+
+    /**
+     * @return the memory used by the textures and images of the content.
+     * The memory of objects shared through the ContentCache is divided among
+     * the windows using them.
+     */
+    size_t getMemoryUsage() const override { return 0; }
+
+    /** Free the textures and images, until the content is visible again. */
+    void releaseMemory() override {}
+
+    /**
+     * Load or unload the data of a synchronized content, depending on its
+     * distance to the screens of this process.
+     * @see isSynchronized()
+     */
+    virtual void setLoaded( bool loaded ) { if( !loaded ) releaseMemory(); }
+
     /** Create an object corresponding to the given content. */
     static WallContentPtr create( const Content& content );
 
+    /**
+     * Check if the contents of a type take part in collective operations on
+     * the WallToWallChannel. They must then exist on all the Wall processes,
+     * while other contents are only created where they are displayed.
+     */
+    static bool isSynchronized( CONTENT_TYPE type );
+
 protected:
     /** Constructor. */
     WallContent();
 
     ContentItem* _qmlItem;
+
+    /** @return true if the Qml item is visible on any of the given screens. */
+    bool _isVisibleIn( const QRegion& visibleWallArea ) const;
+
+    /**
+     * Schedule a texture upload for the current frame.
+     * The upload may be postponed, in which case it must be scheduled again
+     * in the next preRenderUpdate().
+     * @param window The window of the content
+     * @param visibleWallArea The area of the wall covered by the screens of
+     *        this process, used to prioritize visible contents
+     * @param sizeBytes The estimated size of the upload
+     * @param upload The function doing the upload
+     */
+    void _scheduleUpload( const ContentWindow& window,
+                          const QRegion& visibleWallArea, size_t sizeBytes,
+                          const UploadScheduler::UploadFunction& upload );
+
+    /** @return an object shared by another window, or a null pointer. */
+    template< typename T >
+    boost::shared_ptr<T> _findShared( const QString& key ) const
+    {
+        return _contentCache ? _contentCache->find<T>( key )
+                             : boost::shared_ptr<T>();
+    }
+
+    /** Share an object with the other windows. */
+    template< typename T >
+    void _share( const QString& key, boost::shared_ptr<T> object )
+    {
+        if( _contentCache )
+            _contentCache->insert( key, object );
+    }
+
+private:
+    UploadScheduler* _uploadScheduler;
+    MemoryAccountant* _memoryAccountant;
+    ContentCache* _contentCache;
 };
 
 #endif // WALLCONTENT_H
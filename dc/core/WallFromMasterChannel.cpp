@@ -39,44 +39,80 @@
 
 #include "WallFromMasterChannel.h"
 
-#include "MPIChannel.h"
+#include "BroadcastTransport.h"
 #include "DisplayGroup.h"
 #include "ContentWindow.h"
 #include "Options.h"
 #include "Markers.h"
+#include "Profiler.h"
+#include "log.h"
 
 #include <deflect/Frame.h>
 
-#define RANK0 0
+#include <stdexcept>
 
-WallFromMasterChannel::WallFromMasterChannel( MPIChannelPtr mpiChannel )
-    : _mpiChannel( mpiChannel )
+WallFromMasterChannel::WallFromMasterChannel( BroadcastReceiverPtr receiver )
+    : _receiver( receiver )
     , _processMessages( true )
 {
+    _displayGroupDecoder.enableContentRegistry();
 }
 
-bool WallFromMasterChannel::isMessageAvailable()
+void WallFromMasterChannel::processMessages()
 {
-    return _mpiChannel->isMessageAvailable( RANK0 );
+    Profiler::setThreadName( "mpi receive" );
+
+    while( _processMessages )
+    {
+        MPIHeader header;
+        const char* data = 0;
+        {
+            PROFILE_SCOPE( "mpi", "receive" );
+            data = _receiver->receive( header );
+        }
+        PROFILE_SCOPE( "mpi", "dispatch" );
+        _dispatch( header, data );
+    }
 }
 
-void WallFromMasterChannel::receiveMessage()
+void WallFromMasterChannel::_dispatch( const MPIHeader& header,
+                                       const char* data )
 {
-    MPIHeader mh = _mpiChannel->receiveHeader( RANK0 );
+    size_t size = header.size;
+    if( header.compression != MPI_COMPRESSION_NONE )
+    {
+        try
+        {
+            _compressor.decompress( header, data, _uncompressedBuffer );
+        }
+        catch( const std::runtime_error& e )
+        {
+            put_flog( LOG_ERROR, "Dropping message of type %d: '%s'",
+                      header.type, e.what( ));
+            return;
+        }
+        data = _uncompressedBuffer.data();
+        size = _uncompressedBuffer.size();
+    }
 
-    switch( mh.type )
+    switch( header.type )
     {
     case MPI_MESSAGE_TYPE_DISPLAYGROUP:
-        emit received( receiveBroadcast<DisplayGroupPtr>( mh.size ));
+        emit received( _deserialize<DisplayGroupPtr>( _displayGroupDecoder,
+                                                       data, size ));
         break;
     case MPI_MESSAGE_TYPE_OPTIONS:
-        emit received( receiveBroadcast<OptionsPtr>( mh.size ));
+        emit received( _deserialize<OptionsPtr>( _decoder, data, size ));
         break;
     case MPI_MESSAGE_TYPE_MARKERS:
-        emit received( receiveBroadcast<MarkersPtr>( mh.size ));
+        emit received( _deserialize<MarkersPtr>( _decoder, data, size ));
         break;
     case MPI_MESSAGE_TYPE_PIXELSTREAM:
-        emit received( receiveBroadcast<deflect::FramePtr>( mh.size ));
+        emit received( _deserialize<deflect::FramePtr>( _decoder, data,
+                                                         size ));
+        break;
+    case MPI_MESSAGE_TYPE_REQUEST_TRACE:
+        emit receivedTraceRequest();
         break;
     case MPI_MESSAGE_TYPE_QUIT:
         _processMessages = false;
@@ -87,20 +123,11 @@ void WallFromMasterChannel::receiveMessage()
     }
 }
 
-void WallFromMasterChannel::processMessages()
-{
-    while( _processMessages )
-        receiveMessage();
-}
-
 template <typename T>
-T WallFromMasterChannel::receiveBroadcast( const size_t messageSize )
+T WallFromMasterChannel::_deserialize( BinaryDecoder& decoder,
+                                       const char* data, const size_t size )
 {
     T object;
-
-    _buffer.setSize( messageSize );
-    _mpiChannel->receiveBroadcast( _buffer.data(), messageSize, RANK0 );
-    _buffer.deserialize( object );
-
+    decoder.decode( data, size, object );
     return object;
 }
@@ -41,81 +41,93 @@
 #define WALLFROMMASTERCHANNEL_H
 
 #include "types.h"
+#include "BinaryCodec.h"
+#include "MessageCompressor.h"
 #include "SerializeBuffer.h"
 
 #include <QObject>
 
 /**
  * Receiving channel from the master application to the wall processes.
+ *
+ * Messages are received by a BroadcastReceiver, which can be MPI or shared
+ * memory. Compressed messages are decompressed before deserialization.
  */
 class WallFromMasterChannel : public QObject
 {
     Q_OBJECT
 
 public:
-    /** Constructor */
-    WallFromMasterChannel( MPIChannelPtr mpiChannel );
-
-    /** Check if a message is available from the Master process. */
-    bool isMessageAvailable();
-
     /**
-     * Receive a message.
-     * A received() signal will be emitted according to the message type.
-     * This method is blocking.
+     * Constructor
+     * @param receiver The transport of the messages from the master
      */
-    void receiveMessage();
+    WallFromMasterChannel( BroadcastReceiverPtr receiver );
 
 public slots:
     /**
      * Process messages until the QUIT message is received.
+     * A received() signal will be emitted according to the message type.
+     * This method is blocking.
      */
     void processMessages();
 
 signals:
     /**
      * Emitted when a displayGroup was recieved
-     * @see receiveMessage()
+     * @see processMessages()
      * @param displayGroup The DisplayGroup that was received
      */
     void received( DisplayGroupPtr displayGroup );
 
     /**
      * Emitted when new Options were recieved
-     * @see receiveMessage()
+     * @see processMessages()
      * @param options The options that were received
      */
     void received( OptionsPtr options );
 
     /**
      * Emitted when new Markers were recieved
-     * @see receiveMessage()
+     * @see processMessages()
      * @param markers The markers that were received
      */
     void received( MarkersPtr markers );
 
     /**
      * Emitted when a new PixelStream frame was recieved
-     * @see receiveMessage()
+     * @see processMessages()
      * @param frame The frame that was received
      */
     void received( deflect::FramePtr frame );
 
     /**
      * Emitted when the quit message was recieved
-     * @see receiveMessage()
+     * @see processMessages()
      */
     void receivedQuit();
 
+    /**
+     * Emitted when the master requested the Profiler events
+     * @see processMessages()
+     */
+    void receivedTraceRequest();
+
 private:
     Q_DISABLE_COPY( WallFromMasterChannel )
 
-    MPIChannelPtr _mpiChannel;
-    SerializeBuffer _buffer;
+    BroadcastReceiverPtr _receiver;
     bool _processMessages;
 
+    BinaryDecoder _decoder;
+    BinaryDecoder _displayGroupDecoder;
+    MessageCompressor _compressor;
+    SerializeBuffer _uncompressedBuffer;
+
+    void _dispatch( const MPIHeader& header, const char* data );
+
     template <typename T>
-    T receiveBroadcast( const size_t messageSize );
+    T _deserialize( BinaryDecoder& decoder, const char* data, size_t size );
 };
 
 #endif // WALLFROMMASTERCHANNEL_H
@@ -40,12 +40,14 @@
 #include "WallToMasterChannel.h"
 
 #include "MPIChannel.h"
+#include "Profiler.h"
 #include "SerializeBuffer.h"
 #include "serializationHelpers.h"
 
 
 WallToMasterChannel::WallToMasterChannel( MPIChannelPtr mpiChannel )
     : _mpiChannel( mpiChannel )
+    , _quit( false )
 {
 }
 
@@ -55,7 +57,27 @@ void WallToMasterChannel::sendRequestFrame( const QString uri )
     _mpiChannel->send( MPI_MESSAGE_TYPE_REQUEST_FRAME, data, 0 );
 }
 
+void WallToMasterChannel::sendTrace()
+{
+    const int rank = _mpiChannel->getRank();
+    const std::string& events =
+        Profiler::getTraceEvents( rank, "wall " + std::to_string( rank ));
+    _mpiChannel->send( MPI_MESSAGE_TYPE_TRACE, events, 0 );
+}
+
+void WallToMasterChannel::sendMetrics( ProcessMetrics metrics )
+{
+    // The master stops receiving after the quit message
+    if( _quit )
+        return;
+
+    metrics.rank = _mpiChannel->getRank();
+    const std::string& data = SerializeBuffer::serialize( metrics );
+    _mpiChannel->send( MPI_MESSAGE_TYPE_METRICS, data, 0 );
+}
+
 void WallToMasterChannel::sendQuit()
 {
     _mpiChannel->send( MPI_MESSAGE_TYPE_QUIT, "", 0 );
+    _quit = true;
 }
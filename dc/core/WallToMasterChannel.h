@@ -41,6 +41,7 @@
 #define WALLTOMASTERCHANNEL_H
 
 #include "types.h"
+#include "Metrics.h"
 
 #include <QObject>
 
@@ -62,6 +63,17 @@ public slots:
      */
     void sendRequestFrame( QString uri );
 
+    /**
+     * Send the Profiler events of this process to the master application.
+     */
+    void sendTrace();
+
+    /**
+     * Send the performance metrics of this process to the master application.
+     * @param metrics The metrics, the rank is set by this function
+     */
+    void sendMetrics( ProcessMetrics metrics );
+
     /**
      * Send quit message to the master application to stop the receiver.
      */
@@ -71,6 +83,7 @@ private:
     Q_DISABLE_COPY( WallToMasterChannel )
 
     MPIChannelPtr _mpiChannel;
+    bool _quit;
 };
 
 #endif // WALLTOMASTERCHANNEL_H
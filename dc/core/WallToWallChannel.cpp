@@ -66,6 +66,11 @@ bool WallToWallChannel::allReady( const bool isReady ) const
     return _mpiChannel->globalSum( isReady ? 1 : 0 ) == _mpiChannel->getSize();
 }
 
+bool WallToWallChannel::anyModified( const bool isModified ) const
+{
+    return _mpiChannel->globalSum( isModified ? 1 : 0 ) > 0;
+}
+
 boost::posix_time::ptime WallToWallChannel::getTime() const
 {
     return _timestamp;
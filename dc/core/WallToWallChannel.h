@@ -70,6 +70,9 @@ public:
     /** Check if all processes are ready to perform a common action. */
     bool allReady( bool isReady ) const;
 
+    /** Check if any process has modified its content in the current frame. */
+    bool anyModified( bool isModified ) const;
+
     /** Get the current timestamp, synchronized accross processes. */
     boost::posix_time::ptime getTime() const;
 
@@ -40,6 +40,7 @@
 #include "MasterConfiguration.h"
 
 #include "log.h"
+#include "MessageCompressor.h"
 
 #include <QDomElement>
 #include <QtXmlPatterns>
@@ -52,6 +53,7 @@
 MasterConfiguration::MasterConfiguration(const QString &filename)
     : Configuration(filename)
     , backgroundColor_(Qt::black)
+    , mpiCompressionThreshold_(MessageCompressor::DEFAULT_THRESHOLD)
 {
     loadMasterSettings();
 }
@@ -65,6 +67,7 @@ void MasterConfiguration::loadMasterSettings()
     loadDockStartDirectory(query);
     loadWebBrowserStartURL(query);
     loadBackgroundProperties(query);
+    loadMPISettings(query);
 }
 
 void MasterConfiguration::loadDockStartDirectory(QXmlQuery& query)
@@ -118,6 +121,20 @@ void MasterConfiguration::loadBackgroundProperties(QXmlQuery& query)
     }
 }
 
+void MasterConfiguration::loadMPISettings(QXmlQuery& query)
+{
+    QString queryResult;
+
+    query.setQuery("string(/configuration/mpi/@compressionThreshold)");
+    if (query.evaluateTo(&queryResult))
+    {
+        bool ok = false;
+        const int threshold = queryResult.toInt(&ok);
+        if (ok && threshold >= 0)
+            mpiCompressionThreshold_ = threshold;
+    }
+}
+
 const QString& MasterConfiguration::getDockStartDir() const
 {
     return dockStartDir_;
@@ -128,6 +145,11 @@ int MasterConfiguration::getWebServicePort() const
     return dcWebServicePort_;
 }
 
+size_t MasterConfiguration::getMPICompressionThreshold() const
+{
+    return mpiCompressionThreshold_;
+}
+
 const QString& MasterConfiguration::getWebBrowserDefaultURL() const
 {
     return webBrowserDefaultURL_;
@@ -71,6 +71,13 @@ public:
      */
     int getWebServicePort() const;
 
+    /**
+     * Get the minimum size of the messages to compress before sending them to
+     * the wall processes.
+     * @return size in bytes, 0 if compression is disabled.
+     */
+    size_t getMPICompressionThreshold() const;
+
     /**
      * Get the URL used as start page when opening a Web Browser.
      * @return The URL defined in the configuration file, or a default value if
@@ -120,6 +127,7 @@ private:
     void loadDockStartDirectory(QXmlQuery& query);
     void loadWebBrowserStartURL(QXmlQuery& query);
     void loadBackgroundProperties(QXmlQuery& query);
+    void loadMPISettings(QXmlQuery& query);
 
     QString dockStartDir_;
     int dcWebServicePort_;
@@ -127,6 +135,8 @@ private:
 
     QString backgroundUri_;
     QColor backgroundColor_;
+
+    size_t mpiCompressionThreshold_;
 };
 
 #endif // MASTERCONFIGURATION_H
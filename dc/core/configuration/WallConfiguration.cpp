@@ -39,6 +39,11 @@
 
 #include "WallConfiguration.h"
 
+#include "ContentLoadingPolicy.h"
+#include "GLFrameSync.h"
+#include "MemoryAccountant.h"
+#include "UploadScheduler.h"
+
 #include <QtXmlPatterns>
 #include <stdexcept>
 
@@ -46,6 +51,12 @@ WallConfiguration::WallConfiguration(const QString &filename, const int processI
     : Configuration(filename)
     , processIndex_( processIndex )
     , screenCountForCurrentProcess_(0)
+    , uploadBudgetBytes_(UploadScheduler::DEFAULT_BUDGET_BYTES)
+    , uploadBudgetMs_(UploadScheduler::DEFAULT_BUDGET_MS)
+    , memoryBudgetBytes_(MemoryAccountant::DEFAULT_BUDGET_BYTES)
+    , prefetchMargin_(ContentLoadingPolicy::DEFAULT_PREFETCH_MARGIN)
+    , unloadDelayMs_(ContentLoadingPolicy::DEFAULT_UNLOAD_DELAY_MS)
+    , framesInFlight_(GLFrameSync::DEFAULT_FRAMES_IN_FLIGHT)
 {
     loadWallSettings(processIndex);
 }
@@ -106,6 +117,33 @@ void WallConfiguration::loadWallSettings(const int processIndex)
 
         screenGlobalIndex_.push_back(screenIndex);
     }
+
+    loadUploadSettings(query);
+    loadMemorySettings(query);
+    loadLoadingSettings(query);
+    loadRenderingSettings(query);
+}
+
+void WallConfiguration::loadUploadSettings(QXmlQuery& query)
+{
+    QString queryResult;
+    bool ok = false;
+
+    query.setQuery("string(/configuration/uploads/@budgetMB)");
+    if (query.evaluateTo(&queryResult))
+    {
+        const double megabytes = queryResult.toDouble(&ok);
+        if (ok && megabytes > 0.0)
+            uploadBudgetBytes_ = size_t(megabytes * 1024 * 1024);
+    }
+
+    query.setQuery("string(/configuration/uploads/@budgetMs)");
+    if (query.evaluateTo(&queryResult))
+    {
+        const double milliseconds = queryResult.toDouble(&ok);
+        if (ok && milliseconds > 0.0)
+            uploadBudgetMs_ = milliseconds;
+    }
 }
 
 const QString& WallConfiguration::getHost() const
@@ -137,3 +175,83 @@ int WallConfiguration::getProcessIndex() const
 {
     return processIndex_;
 }
+
+void WallConfiguration::loadMemorySettings(QXmlQuery& query)
+{
+    QString queryResult;
+
+    query.setQuery("string(/configuration/memory/@budgetMB)");
+    if (query.evaluateTo(&queryResult))
+    {
+        bool ok = false;
+        const double megabytes = queryResult.toDouble(&ok);
+        if (ok && megabytes > 0.0)
+            memoryBudgetBytes_ = size_t(megabytes * 1024 * 1024);
+    }
+}
+
+void WallConfiguration::loadLoadingSettings(QXmlQuery& query)
+{
+    QString queryResult;
+    bool ok = false;
+
+    query.setQuery("string(/configuration/loading/@prefetchMargin)");
+    if (query.evaluateTo(&queryResult))
+    {
+        const int pixels = queryResult.toInt(&ok);
+        if (ok && pixels >= 0)
+            prefetchMargin_ = pixels;
+    }
+
+    query.setQuery("string(/configuration/loading/@unloadDelay)");
+    if (query.evaluateTo(&queryResult))
+    {
+        const double seconds = queryResult.toDouble(&ok);
+        if (ok && seconds >= 0.0)
+            unloadDelayMs_ = int(seconds * 1000);
+    }
+}
+
+void WallConfiguration::loadRenderingSettings(QXmlQuery& query)
+{
+    QString queryResult;
+
+    query.setQuery("string(/configuration/rendering/@framesInFlight)");
+    if (query.evaluateTo(&queryResult))
+    {
+        bool ok = false;
+        const int frames = queryResult.toInt(&ok);
+        if (ok && frames > 0)
+            framesInFlight_ = frames;
+    }
+}
+
+size_t WallConfiguration::getUploadBudgetBytes() const
+{
+    return uploadBudgetBytes_;
+}
+
+double WallConfiguration::getUploadBudgetMs() const
+{
+    return uploadBudgetMs_;
+}
+
+size_t WallConfiguration::getMemoryBudgetBytes() const
+{
+    return memoryBudgetBytes_;
+}
+
+int WallConfiguration::getPrefetchMargin() const
+{
+    return prefetchMargin_;
+}
+
+int WallConfiguration::getUnloadDelayMs() const
+{
+    return unloadDelayMs_;
+}
+
+unsigned int WallConfiguration::getFramesInFlight() const
+{
+    return framesInFlight_;
+}
@@ -44,6 +44,8 @@
 
 #include <QPoint>
 
+class QXmlQuery;
+
 /**
  * @brief The WallConfiguration class manages all the parameters needed
  * to setup a Wall process.
@@ -85,6 +87,27 @@ public:
     /** Get the index of the process. */
     int getProcessIndex() const;
 
+    /** Get the maximum size of the texture uploads in a frame, in bytes. */
+    size_t getUploadBudgetBytes() const;
+
+    /** Get the maximum time spent uploading textures in a frame, in ms. */
+    double getUploadBudgetMs() const;
+
+    /** Get the maximum memory used by the contents of the process, in bytes. */
+    size_t getMemoryBudgetBytes() const;
+
+    /** Get the margin around the screens in which contents are loaded. */
+    int getPrefetchMargin() const;
+
+    /** Get the delay before unloading contents away from the screens, in ms. */
+    int getUnloadDelayMs() const;
+
+    /**
+     * Get the maximum number of frames which the GPU may still render.
+     * Values above 1 relax the swap lock, see GLFrameSync.
+     */
+    unsigned int getFramesInFlight() const;
+
 private:
     QString host_;
     QString display_;
@@ -93,8 +116,18 @@ private:
     int screenCountForCurrentProcess_;
     std::vector<QPoint> screenPosition_;
     std::vector<QPoint> screenGlobalIndex_;
+    size_t uploadBudgetBytes_;
+    double uploadBudgetMs_;
+    size_t memoryBudgetBytes_;
+    int prefetchMargin_;
+    int unloadDelayMs_;
+    unsigned int framesInFlight_;
 
     void loadWallSettings(const int processIndex);
+    void loadUploadSettings(QXmlQuery& query);
+    void loadMemorySettings(QXmlQuery& query);
+    void loadLoadingSettings(QXmlQuery& query);
+    void loadRenderingSettings(QXmlQuery& query);
 };
 
 #endif // WALLCONFIGURATION_H
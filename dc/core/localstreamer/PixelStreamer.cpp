@@ -46,3 +46,8 @@ PixelStreamer::PixelStreamer()
 PixelStreamer::~PixelStreamer()
 {
 }
+
+deflect::PixelFormat PixelStreamer::getPixelFormat()
+{
+    return deflect::BGRA;
+}
@@ -42,6 +42,7 @@
 
 #include "types.h"
 #include <deflect/Event.h>
+#include <deflect/ImageWrapper.h>
 
 #include <QObject>
 #include <QSize>
@@ -64,6 +65,15 @@ public:
     /** Get the size of the images generated by this streamer. */
     virtual QSize size() const = 0;
 
+    /**
+     * Get the pixel format of the images sent by all PixelStreamers.
+     *
+     * The imageUpdated() QImages must be in a QImage::Format_(A)RGB32 format,
+     * which in memory corresponds to (GL_)BGRA. They can then be streamed and
+     * uploaded to the GPU without any channel conversion.
+     */
+    static deflect::PixelFormat getPixelFormat();
+
 public slots:
     /** Process an Event. */
     virtual void processEvent( deflect::Event event ) = 0;
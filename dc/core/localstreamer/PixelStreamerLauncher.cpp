@@ -40,6 +40,7 @@
 #include "PixelStreamerLauncher.h"
 
 #include "DockPixelStreamer.h"
+#include "PixelStreamer.h"
 #include "CommandLineOptions.h"
 
 #include "log.h"
@@ -76,7 +77,8 @@ void PixelStreamerLauncher::openWebBrowser( const QPointF pos, const QSize size,
     const QString& uri = QString( "WebBrowser_%1" ).arg( webbrowserCounter++ );
 
     const QSize viewportSize = !size.isEmpty() ? size : WEBBROWSER_DEFAULT_SIZE;
-    _windowManager.openWindow( uri, pos, viewportSize );
+    _windowManager.openWindow( uri, pos, viewportSize,
+                               PixelStreamer::getPixelFormat( ));
 
     CommandLineOptions options;
     options.setPixelStreamerType( PS_WEBKIT );
@@ -104,7 +106,8 @@ void PixelStreamerLauncher::openDock( const QPointF pos )
     const QString& dockUri = DockPixelStreamer::getUniqueURI();
     dockSize = DockPixelStreamer::constrainSize( dockSize );
 
-    _windowManager.openWindow( dockUri, pos, dockSize );
+    _windowManager.openWindow( dockUri, pos, dockSize,
+                               PixelStreamer::getPixelFormat( ));
     _windowManager.showWindow( dockUri );
 
     if( !_processes.count( dockUri ))
@@ -39,32 +39,383 @@
 #include "log.h"
 
 #include <stdarg.h>
+#include <stdint.h>
+#include <time.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <iostream>
-#include <sstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #define MAX_LOG_LENGTH 1024
+#define MESSAGES_PER_THREAD 256
+#define DRAIN_INTERVAL_MS 20
 
 std::string logger_id = "";
 
+namespace
+{
+std::atomic<int> logThreshold( LOG_THRESHOLD );
+
+// Set when the Logger is destroyed at exit, messages are then written
+// synchronously.
+std::atomic<bool> loggerDestroyed( false );
+
+struct LogMessage
+{
+    uint64_t sequence;
+    int64_t timestamp; // microseconds since epoch
+    int level;
+    char text[MAX_LOG_LENGTH];
+};
+
+/**
+ * Messages of one thread, written by that thread and read by the Logger.
+ */
+class LogRing
+{
+public:
+    explicit LogRing( const unsigned int threadId )
+        : threadId_( threadId )
+        , messages_( MESSAGES_PER_THREAD )
+        , writeIndex_( 0 )
+        , readIndex_( 0 )
+        , released_( false )
+    {}
+
+    /** @return the slot to write, or nullptr if the ring is full. */
+    LogMessage* beginWrite()
+    {
+        const uint64_t write = writeIndex_.load( std::memory_order_relaxed );
+        const uint64_t read = readIndex_.load( std::memory_order_acquire );
+        if( write - read >= MESSAGES_PER_THREAD )
+            return nullptr;
+        return &messages_[write % MESSAGES_PER_THREAD];
+    }
+
+    /**
+     * Publish the slot returned by beginWrite().
+     * @return the number of messages waiting to be read.
+     */
+    size_t endWrite()
+    {
+        const uint64_t write =
+                writeIndex_.fetch_add( 1, std::memory_order_release ) + 1;
+        return write - readIndex_.load( std::memory_order_relaxed );
+    }
+
+    /** @return the number of messages waiting to be read. */
+    size_t getReadableCount() const
+    {
+        return writeIndex_.load( std::memory_order_acquire ) -
+               readIndex_.load( std::memory_order_relaxed );
+    }
+
+    /** @return the i-th message waiting to be read. */
+    const LogMessage& peek( const size_t i ) const
+    {
+        const uint64_t read = readIndex_.load( std::memory_order_relaxed );
+        return messages_[(read + i) % MESSAGES_PER_THREAD];
+    }
+
+    /** Release the slots of the count messages read. */
+    void pop( const size_t count )
+    {
+        readIndex_.fetch_add( count, std::memory_order_release );
+    }
+
+    const unsigned int threadId_;
+
+private:
+    std::vector<LogMessage> messages_;
+    std::atomic<uint64_t> writeIndex_;
+    std::atomic<uint64_t> readIndex_;
+
+public:
+    /** Set when the owning thread has exited. */
+    std::atomic<bool> released_;
+};
+typedef std::shared_ptr<LogRing> LogRingPtr;
+
+struct ThreadRing
+{
+    ~ThreadRing()
+    {
+        if( ring )
+            ring->released_ = true;
+    }
+    LogRingPtr ring;
+};
+
+int64_t now()
+{
+    using namespace std::chrono;
+    return duration_cast<microseconds>(
+                system_clock::now().time_since_epoch( )).count();
+}
+
+void formatMessage( std::string& out, const LogMessage& message,
+                    const unsigned int threadId )
+{
+    const time_t seconds = message.timestamp / 1000000;
+    const int micros = message.timestamp % 1000000;
+
+    struct tm localTime;
+    localtime_r( &seconds, &localTime );
+
+    char prefix[64];
+    const size_t length = strftime( prefix, sizeof( prefix ),
+                                    "%Y-%m-%d %H:%M:%S", &localTime );
+    snprintf( prefix + length, sizeof( prefix ) - length, ".%06d [%u] ",
+              micros, threadId );
+
+    out += prefix;
+    if( !logger_id.empty( ))
+        out += "{" + logger_id + "} ";
+    out += message.text;
+    out += '\n';
+}
+
+/**
+ * Write the messages of all the threads from a background thread.
+ */
+class Logger
+{
+public:
+    Logger()
+        : sequence_( 0 )
+        , written_( 0 )
+        , dropped_( 0 )
+        , reportedDropped_( 0 )
+        , nextThreadId_( 0 )
+        , stop_( false )
+        , flushRequested_( false )
+        , drainRequested_( false )
+        , thread_( &Logger::run, this )
+    {}
+
+    ~Logger()
+    {
+        {
+            std::lock_guard<std::mutex> lock( mutex_ );
+            stop_ = true;
+        }
+        wakeup_.notify_one();
+        thread_.join();
+        loggerDestroyed = true;
+    }
+
+    void log( const int level, const char* format, va_list ap )
+    {
+        LogRing& ring = getThreadRing();
+        LogMessage* message = ring.beginWrite();
+        if( !message )
+        {
+            ++dropped_;
+            return;
+        }
+        vsnprintf( message->text, MAX_LOG_LENGTH, format, ap );
+        message->timestamp = now();
+        message->level = level;
+        message->sequence = sequence_++;
+
+        // Wake up the writer early rather than dropping the next messages
+        if( ring.endWrite() == MESSAGES_PER_THREAD / 2 )
+        {
+            drainRequested_ = true;
+            wakeup_.notify_one();
+        }
+    }
+
+    void flush()
+    {
+        const uint64_t target = sequence_;
+        std::unique_lock<std::mutex> lock( mutex_ );
+        flushRequested_ = true;
+        wakeup_.notify_one();
+        flushed_.wait( lock, [&] { return written_ >= target || stop_; } );
+    }
+
+    size_t getDroppedCount() const
+    {
+        return dropped_;
+    }
+
+private:
+    std::atomic<uint64_t> sequence_;
+    uint64_t written_;
+    std::atomic<size_t> dropped_;
+    size_t reportedDropped_;
+    std::atomic<unsigned int> nextThreadId_;
+
+    std::mutex ringsMutex_;
+    std::vector<LogRingPtr> rings_;
+
+    std::mutex mutex_;
+    std::condition_variable wakeup_;
+    std::condition_variable flushed_;
+    bool stop_;
+    bool flushRequested_;
+    std::atomic<bool> drainRequested_;
+
+    std::thread thread_;
+
+    LogRing& getThreadRing()
+    {
+        static thread_local ThreadRing threadRing;
+        if( !threadRing.ring )
+        {
+            threadRing.ring.reset( new LogRing( ++nextThreadId_ ));
+            std::lock_guard<std::mutex> lock( ringsMutex_ );
+            rings_.push_back( threadRing.ring );
+        }
+        return *threadRing.ring;
+    }
+
+    void run()
+    {
+        bool stop = false;
+        while( !stop )
+        {
+            {
+                std::unique_lock<std::mutex> lock( mutex_ );
+                wakeup_.wait_for( lock,
+                                  std::chrono::milliseconds( DRAIN_INTERVAL_MS ),
+                                  [this] { return stop_ || flushRequested_ ||
+                                                  drainRequested_; } );
+                stop = stop_;
+                flushRequested_ = false;
+                drainRequested_ = false;
+            }
+            const uint64_t count = drain();
+            {
+                std::lock_guard<std::mutex> lock( mutex_ );
+                written_ += count;
+            }
+            flushed_.notify_all();
+        }
+    }
+
+    uint64_t drain()
+    {
+        std::vector<LogRingPtr> rings;
+        {
+            std::lock_guard<std::mutex> lock( ringsMutex_ );
+            // Rings of exited threads are removed once all read
+            rings_.erase( std::remove_if( rings_.begin(), rings_.end(),
+                                          []( const LogRingPtr& ring )
+                          { return ring->released_ &&
+                                   ring->getReadableCount() == 0; } ),
+                          rings_.end( ));
+            rings = rings_;
+        }
+
+        // Merge the messages of all threads in the order they were logged
+        typedef std::pair<const LogMessage*, const LogRing*> Entry;
+        std::vector<Entry> entries;
+        std::vector<size_t> counts( rings.size( ));
+        for( size_t i = 0; i < rings.size(); ++i )
+        {
+            counts[i] = rings[i]->getReadableCount();
+            for( size_t j = 0; j < counts[i]; ++j )
+                entries.push_back( Entry( &rings[i]->peek( j ),
+                                          rings[i].get( )));
+        }
+        std::sort( entries.begin(), entries.end(),
+                   []( const Entry& a, const Entry& b )
+                   { return a.first->sequence < b.first->sequence; } );
+
+        std::string errors;
+        std::string output;
+        for( const Entry& entry : entries )
+        {
+            std::string& out = entry.first->level < LOG_ERROR ? errors : output;
+            formatMessage( out, *entry.first, entry.second->threadId_ );
+        }
+
+        for( size_t i = 0; i < rings.size(); ++i )
+            rings[i]->pop( counts[i] );
+
+        const size_t dropped = dropped_;
+        if( dropped != reportedDropped_ )
+        {
+            LogMessage message;
+            message.timestamp = now();
+            snprintf( message.text, MAX_LOG_LENGTH, "%zu log messages dropped",
+                      dropped - reportedDropped_ );
+            formatMessage( errors, message, 0 );
+            reportedDropped_ = dropped;
+        }
+
+        if( !errors.empty( ))
+            std::cerr << errors << std::flush;
+        if( !output.empty( ))
+            std::cout << output << std::flush;
+
+        return entries.size();
+    }
+};
+
+Logger& getLogger()
+{
+    static Logger logger;
+    return logger;
+}
+
+void writeSynchronously( const int level, const char* format, va_list ap )
+{
+    LogMessage message;
+    vsnprintf( message.text, MAX_LOG_LENGTH, format, ap );
+    message.timestamp = now();
+
+    std::string out;
+    formatMessage( out, message, 0 );
+    if( level < LOG_ERROR )
+        std::cerr << out << std::flush;
+    else
+        std::cout << out << std::flush;
+}
+}
+
 void put_log( const int level, const char* format, ... )
 {
-    if( level < LOG_THRESHOLD )
+    if( level < logThreshold.load( std::memory_order_relaxed ))
         return;
 
-    char log_string[MAX_LOG_LENGTH];
-
     va_list ap;
     va_start( ap, format );
-    vsnprintf( log_string, MAX_LOG_LENGTH, format, ap );
+    if( loggerDestroyed )
+        writeSynchronously( level, format, ap );
+    else
+        getLogger().log( level, format, ap );
     va_end( ap );
 
-    std::stringstream message;
-    if( !logger_id.empty( ))
-        message << "{" << logger_id << "} ";
-    message << log_string;
+    if( level == LOG_FATAL )
+        flush_log();
+}
 
-    if( level < LOG_ERROR )
-        std::cerr << message.str() << std::endl;
-    else
-        std::cout << message.str() << std::endl;
+void set_log_threshold( const int level )
+{
+    logThreshold = level;
+}
+
+int get_log_threshold()
+{
+    return logThreshold;
+}
+
+size_t get_dropped_log_count()
+{
+    return loggerDestroyed ? 0 : getLogger().getDroppedCount();
+}
+
+void flush_log()
+{
+    if( !loggerDestroyed )
+        getLogger().flush();
 }
@@ -39,6 +39,7 @@
 #ifndef LOG_H
 #define LOG_H
 
+#include <cstddef>
 #include <string>
 
 #define LOG_VERBOSE 0
@@ -57,6 +58,24 @@
 extern std::string logger_id;
 extern void put_log( int level, const char* format, ... );
 
+/**
+ * Messages are written asynchronously by a background thread. Each thread
+ * logs to its own lock-free ring buffer; when it is full, messages are dropped
+ * and counted instead of blocking the caller.
+ */
+
+/** Set the minimum level of the messages to log, LOG_THRESHOLD by default. */
+extern void set_log_threshold( int level );
+
+/** @return the minimum level of the messages to log. */
+extern int get_log_threshold();
+
+/** @return the number of messages dropped because a ring buffer was full. */
+extern size_t get_dropped_log_count();
+
+/** Block until all the messages logged so far have been written. */
+extern void flush_log();
+
 #ifdef _WIN32
 #  define put_flog( l, fmt, ... ) put_log( l, "%s: " fmt, __FUNCTION__, ##__VA_ARGS__ )
 #else
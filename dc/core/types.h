@@ -48,6 +48,9 @@
 #include <set>
 #include <vector>
 
+class BroadcastReceiver;
+class BroadcastSender;
+class ClusterMetrics;
 class Configuration;
 class Content;
 class ContentWindow;
@@ -62,6 +65,7 @@ class FFMPEGVideoStream;
 class FFMPEGVideoFrameConverter;
 class GLWindow;
 class MarkerRenderer;
+class MemoryAccountant;
 class Markers;
 class MasterConfiguration;
 class MPIChannel;
@@ -74,11 +78,15 @@ class Renderable;
 class RenderContext;
 class SVG;
 class TestPattern;
+class UploadScheduler;
 class WallContent;
 class WallWindow;
 class WallConfiguration;
 class WallToWallChannel;
 
+typedef boost::shared_ptr< BroadcastReceiver > BroadcastReceiverPtr;
+typedef boost::shared_ptr< BroadcastSender > BroadcastSenderPtr;
+typedef boost::shared_ptr< ClusterMetrics > ClusterMetricsPtr;
 typedef boost::shared_ptr< Content > ContentPtr;
 typedef boost::shared_ptr< ContentWindow > ContentWindowPtr;
 typedef std::unique_ptr<ContentWindowController> ContentWindowControllerPtr;
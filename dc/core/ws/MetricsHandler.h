@@ -0,0 +1,83 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+#ifndef METRICSHANDLER_H
+#define METRICSHANDLER_H
+
+#include "dc/webservice/Handler.h"
+
+#include "types.h"
+
+/**
+ * Handle "/metrics" requests for the WebService.
+ *
+ * Serve the performance metrics of the cluster, either as JSON or in the
+ * Prometheus text exposition format.
+ */
+class MetricsHandler : public dcWebservice::Handler
+{
+public:
+    /** The format of the responses. */
+    enum Format
+    {
+        FORMAT_JSON,
+        FORMAT_PROMETHEUS
+    };
+
+    /**
+     * Constructor.
+     * @param metrics The metrics to serve, updated by the MPI receive thread
+     * @param format The format of the responses
+     */
+    MetricsHandler( ClusterMetricsPtr metrics, Format format );
+
+    /**
+     * Handle a request.
+     * @param request A valid dcWebservice::Request object.
+     * @return A valid Response object.
+     */
+    dcWebservice::ConstResponsePtr
+    handle( const dcWebservice::Request& request ) const override;
+
+private:
+    ClusterMetricsPtr _metrics;
+    const Format _format;
+};
+
+#endif // METRICSHANDLER_H
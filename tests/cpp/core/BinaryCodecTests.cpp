@@ -0,0 +1,411 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+#define BOOST_TEST_MODULE BinaryCodecTests
+#include <boost/test/unit_test.hpp>
+namespace ut = boost::unit_test;
+
+#include "BinaryCodec.h"
+#include "SerializeBuffer.h"
+
+#include "ContentWindow.h"
+#include "DisplayGroup.h"
+#include "Markers.h"
+#include "MovieContent.h"
+#include "Options.h"
+#include "PixelStreamContent.h"
+#include "TextureContent.h"
+
+#include <deflect/Frame.h>
+
+#include <boost/make_shared.hpp>
+
+namespace
+{
+const QSize wallSize( 1000, 1000 );
+const QSize CONTENT_SIZE( 100, 100 );
+
+template< typename T >
+T boostRoundTrip( const T& object, size_t& encodedSize )
+{
+    const std::string serialized = SerializeBuffer::serialize( object );
+    encodedSize = serialized.size();
+
+    SerializeBuffer buffer;
+    buffer.setSize( serialized.size( ));
+    memcpy( buffer.data(), serialized.data(), serialized.size( ));
+
+    T deserialized;
+    buffer.deserialize( deserialized );
+    return deserialized;
+}
+
+template< typename T >
+T codecRoundTrip( const T& object, size_t& encodedSize )
+{
+    BinaryEncoder encoder;
+    std::string buffer;
+    encoder.encode( object, buffer );
+    encodedSize = buffer.size();
+
+    BinaryDecoder decoder;
+    T decoded;
+    decoder.decode( buffer.data(), buffer.size(), decoded );
+    return decoded;
+}
+
+ContentWindowPtr makeWindow( ContentPtr content, const QRectF& coordinates )
+{
+    content->setDimensions( CONTENT_SIZE );
+    ContentWindowPtr window = boost::make_shared<ContentWindow>( content );
+    window->setCoordinates( coordinates );
+    return window;
+}
+
+DisplayGroupPtr makeDisplayGroup()
+{
+    DisplayGroupPtr group( new DisplayGroup( wallSize ));
+    group->setShowWindowTitles( false );
+
+    ContentPtr stream( new PixelStreamContent( "stream" ));
+    static_cast< PixelStreamContent& >( *stream ).setPixelFormat( deflect::BGRA );
+    group->addContentWindow( makeWindow( stream, QRectF( 10, 20, 300, 200 )));
+
+    ContentPtr movie( new MovieContent( "movie.mp4" ));
+    ContentWindowPtr movieWindow = makeWindow( movie, QRectF( 400, 400, 200, 200 ));
+    movieWindow->setZoomRect( QRectF( 0.25, 0.25, 0.5, 0.5 ));
+    group->addContentWindow( movieWindow );
+
+    ContentPtr texture( new TextureContent( "wall.png" ));
+    group->addContentWindow( makeWindow( texture, QRectF( 0, 0, 50, 50 )));
+
+    group->focus( movieWindow->getID( ));
+    return group;
+}
+
+void checkEqual( const ContentWindow& window, const ContentWindow& reference )
+{
+    BOOST_CHECK( window.getID() == reference.getID( ));
+    BOOST_CHECK_EQUAL( window.getCoordinates(), reference.getCoordinates( ));
+    BOOST_CHECK_EQUAL( window.getZoomRect(), reference.getZoomRect( ));
+    BOOST_CHECK_EQUAL( window.getFocusedCoordinates(),
+                       reference.getFocusedCoordinates( ));
+    BOOST_CHECK_EQUAL( window.isFocused(), reference.isFocused( ));
+    BOOST_CHECK_EQUAL( window.getState(), reference.getState( ));
+    BOOST_CHECK_EQUAL( window.getBorder(), reference.getBorder( ));
+    BOOST_CHECK_EQUAL( window.getControlsVisible(),
+                       reference.getControlsVisible( ));
+
+    const Content& content = *window.getContent();
+    const Content& referenceContent = *reference.getContent();
+    BOOST_CHECK_EQUAL( content.getType(), referenceContent.getType( ));
+    BOOST_CHECK_EQUAL( content.getURI().toStdString(),
+                       referenceContent.getURI().toStdString( ));
+    BOOST_CHECK( content.getDimensions() == referenceContent.getDimensions( ));
+
+    // The controller depends on the window and its DisplayGroup
+    BOOST_REQUIRE( window.getController( ));
+    BOOST_REQUIRE( reference.getController( ));
+    BOOST_CHECK_EQUAL( window.getController()->getMinSize(),
+                       reference.getController()->getMinSize( ));
+    BOOST_CHECK_EQUAL( window.getController()->getMaxSize(),
+                       reference.getController()->getMaxSize( ));
+}
+
+void checkEqual( const DisplayGroup& group, const DisplayGroup& reference )
+{
+    BOOST_CHECK_EQUAL( group.getShowWindowTitles(),
+                       reference.getShowWindowTitles( ));
+    BOOST_CHECK_EQUAL( group.getCoordinates(), reference.getCoordinates( ));
+
+    const ContentWindowPtrs& windows = group.getContentWindows();
+    const ContentWindowPtrs& referenceWindows = reference.getContentWindows();
+    BOOST_REQUIRE_EQUAL( windows.size(), referenceWindows.size( ));
+    for( size_t i = 0; i < windows.size(); ++i )
+        checkEqual( *windows[i], *referenceWindows[i] );
+
+    BOOST_REQUIRE_EQUAL( group.getFocusedWindows().size(),
+                         reference.getFocusedWindows().size( ));
+}
+}
+
+BOOST_AUTO_TEST_CASE( testDisplayGroupRoundTripMatchesBoost )
+{
+    const DisplayGroupPtr group = makeDisplayGroup();
+
+    size_t boostSize = 0;
+    size_t codecSize = 0;
+    const DisplayGroupPtr boostGroup = boostRoundTrip( group, boostSize );
+    const DisplayGroupPtr codecGroup = codecRoundTrip( group, codecSize );
+
+    checkEqual( *boostGroup, *group );
+    checkEqual( *codecGroup, *boostGroup );
+    BOOST_CHECK_LT( codecSize, boostSize );
+}
+
+BOOST_AUTO_TEST_CASE( testSharedObjectsAreDecodedOnce )
+{
+    size_t size = 0;
+    const DisplayGroupPtr group = codecRoundTrip( makeDisplayGroup(), size );
+
+    // Focused windows are the same objects as in the list of windows
+    BOOST_REQUIRE_EQUAL( group->getFocusedWindows().size(), 1 );
+    const ContentWindowPtr focusedWindow = *group->getFocusedWindows().begin();
+    BOOST_CHECK( focusedWindow == group->getContentWindows()[1] );
+
+    // Controllers point back to their window and to the DisplayGroup
+    for( ContentWindowPtr window : group->getContentWindows( ))
+    {
+        const ContentWindowController* controller = window->getController();
+        BOOST_REQUIRE( controller );
+        BOOST_CHECK_EQUAL( controller->getMinSize(),
+                           ContentWindowController( *window, *group ).getMinSize( ));
+    }
+}
+
+BOOST_AUTO_TEST_CASE( testContentSubclassesRoundTrip )
+{
+    size_t size = 0;
+    const DisplayGroupPtr group = codecRoundTrip( makeDisplayGroup(), size );
+
+    const ContentWindowPtrs& windows = group->getContentWindows();
+    BOOST_REQUIRE_EQUAL( windows.size(), 3 );
+
+    const PixelStreamContent* stream =
+        dynamic_cast< const PixelStreamContent* >( windows[0]->getContentPtr( ));
+    BOOST_REQUIRE( stream );
+    BOOST_CHECK_EQUAL( stream->getPixelFormat(), deflect::BGRA );
+
+    const MovieContent* movie =
+        dynamic_cast< const MovieContent* >( windows[1]->getContentPtr( ));
+    BOOST_REQUIRE( movie );
+    BOOST_CHECK_EQUAL( movie->getControlState(), STATE_LOOP );
+
+    BOOST_CHECK( dynamic_cast< const TextureContent* >(
+                     windows[2]->getContentPtr( )));
+}
+
+BOOST_AUTO_TEST_CASE( testOptionsRoundTripMatchesBoost )
+{
+    OptionsPtr options( new Options );
+    options->setShowWindowBorders( false );
+    options->setShowTestPattern( true );
+    options->setBackgroundColor( QColor( 10, 20, 30, 40 ));
+    options->setBackgroundContent( ContentPtr( new MovieContent( "bg.mp4" )));
+
+    size_t boostSize = 0;
+    size_t codecSize = 0;
+    const OptionsPtr boostOptions = boostRoundTrip( options, boostSize );
+    const OptionsPtr codecOptions = codecRoundTrip( options, codecSize );
+
+    BOOST_CHECK_EQUAL( codecOptions->getShowWindowBorders(),
+                       boostOptions->getShowWindowBorders( ));
+    BOOST_CHECK_EQUAL( codecOptions->getShowTestPattern(),
+                       boostOptions->getShowTestPattern( ));
+    BOOST_CHECK( codecOptions->getBackgroundColor() ==
+                 boostOptions->getBackgroundColor( ));
+    BOOST_REQUIRE( codecOptions->getBackgroundContent( ));
+    BOOST_CHECK_EQUAL(
+        codecOptions->getBackgroundContent()->getURI().toStdString(),
+        boostOptions->getBackgroundContent()->getURI().toStdString( ));
+    BOOST_CHECK_LT( codecSize, boostSize );
+}
+
+BOOST_AUTO_TEST_CASE( testMarkersRoundTripMatchesBoost )
+{
+    MarkersPtr markers( new Markers );
+    markers->addMarker( 0, QPointF( 0.5, 0.25 ));
+    markers->addMarker( 3, QPointF( 0.1, 0.9 ));
+
+    size_t boostSize = 0;
+    size_t codecSize = 0;
+    const MarkersPtr boostMarkers = boostRoundTrip( markers, boostSize );
+    const MarkersPtr codecMarkers = codecRoundTrip( markers, codecSize );
+
+    const MarkersMap& codecMap = codecMarkers->getMarkers();
+    const MarkersMap& boostMap = boostMarkers->getMarkers();
+    BOOST_REQUIRE_EQUAL( codecMap.size(), boostMap.size( ));
+    for( const auto& marker : boostMap )
+    {
+        BOOST_REQUIRE( codecMap.count( marker.first ));
+        BOOST_CHECK_EQUAL( codecMap.at( marker.first ).getPosition(),
+                           marker.second.getPosition( ));
+    }
+    BOOST_CHECK_LT( codecSize, boostSize );
+}
+
+BOOST_AUTO_TEST_CASE( testFrameRoundTripMatchesBoost )
+{
+    deflect::FramePtr frame( new deflect::Frame );
+    frame->uri = "stream";
+    for( int i = 0; i < 4; ++i )
+    {
+        deflect::Segment segment;
+        segment.parameters.x = i * 64;
+        segment.parameters.width = 64;
+        segment.parameters.height = 32;
+        segment.parameters.compressed = i % 2;
+        segment.imageData = QByteArray( 128 + i, char( i ));
+        frame->segments.push_back( segment );
+    }
+
+    size_t boostSize = 0;
+    size_t codecSize = 0;
+    const deflect::FramePtr boostFrame = boostRoundTrip( frame, boostSize );
+    const deflect::FramePtr codecFrame = codecRoundTrip( frame, codecSize );
+
+    BOOST_CHECK_EQUAL( codecFrame->uri.toStdString(),
+                       boostFrame->uri.toStdString( ));
+    BOOST_REQUIRE_EQUAL( codecFrame->segments.size(),
+                         boostFrame->segments.size( ));
+    for( size_t i = 0; i < codecFrame->segments.size(); ++i )
+    {
+        const deflect::Segment& segment = codecFrame->segments[i];
+        const deflect::Segment& reference = boostFrame->segments[i];
+        BOOST_CHECK_EQUAL( segment.parameters.x, reference.parameters.x );
+        BOOST_CHECK_EQUAL( segment.parameters.y, reference.parameters.y );
+        BOOST_CHECK_EQUAL( segment.parameters.width,
+                           reference.parameters.width );
+        BOOST_CHECK_EQUAL( segment.parameters.height,
+                           reference.parameters.height );
+        BOOST_CHECK_EQUAL( segment.parameters.compressed,
+                           reference.parameters.compressed );
+        BOOST_CHECK( segment.imageData == reference.imageData );
+    }
+    BOOST_CHECK_LE( codecSize, boostSize );
+}
+
+BOOST_AUTO_TEST_CASE( testEncoderReusesBuffer )
+{
+    BinaryEncoder encoder;
+    std::string buffer;
+    encoder.encode( makeDisplayGroup(), buffer );
+    const size_t size = buffer.size();
+    const char* data = buffer.data();
+
+    encoder.encode( makeDisplayGroup(), buffer );
+    BOOST_CHECK_EQUAL( buffer.size(), size );
+    BOOST_CHECK( buffer.data() == data );
+}
+
+BOOST_AUTO_TEST_CASE( testDecodeInvalidData )
+{
+    BinaryEncoder encoder;
+    std::string buffer;
+    encoder.encode( makeDisplayGroup(), buffer );
+
+    BinaryDecoder decoder;
+    DisplayGroupPtr group;
+    BOOST_CHECK_THROW( decoder.decode( buffer.data(), buffer.size() / 2,
+                                       group ), std::runtime_error );
+
+    buffer[0] = char( BinaryCodec::VERSION + 1 );
+    BOOST_CHECK_THROW( decoder.decode( buffer.data(), buffer.size(), group ),
+                       std::runtime_error );
+}
+
+BOOST_AUTO_TEST_CASE( testContentRegistrySendsOnlyModifiedContents )
+{
+    BinaryEncoder encoder;
+    BinaryDecoder decoder;
+    encoder.enableContentRegistry();
+    decoder.enableContentRegistry();
+
+    const DisplayGroupPtr group = makeDisplayGroup();
+    std::string buffer;
+
+    encoder.encode( group, buffer );
+    const size_t fullSize = buffer.size();
+    DisplayGroupPtr first;
+    decoder.decode( buffer.data(), buffer.size(), first );
+    checkEqual( *first, *group );
+
+    // Unmodified contents are not sent again, and are shared on the walls
+    encoder.encode( group, buffer );
+    BOOST_CHECK_LT( buffer.size(), fullSize );
+    DisplayGroupPtr second;
+    decoder.decode( buffer.data(), buffer.size(), second );
+    checkEqual( *second, *group );
+    for( size_t i = 0; i < 3; ++i )
+    {
+        BOOST_CHECK( second->getContentWindows()[i]->getContent() ==
+                     first->getContentWindows()[i]->getContent( ));
+    }
+
+    // A modified content is sent again
+    group->getContentWindows()[1]->getContent()->setDimensions( QSize( 20, 40 ));
+    encoder.encode( group, buffer );
+    DisplayGroupPtr third;
+    decoder.decode( buffer.data(), buffer.size(), third );
+    checkEqual( *third, *group );
+    BOOST_CHECK( third->getContentWindows()[1]->getContent() !=
+                 second->getContentWindows()[1]->getContent( ));
+    BOOST_CHECK( third->getContentWindows()[0]->getContent() ==
+                 second->getContentWindows()[0]->getContent( ));
+}
+
+BOOST_AUTO_TEST_CASE( testContentRegistryWithNewAndRemovedWindows )
+{
+    BinaryEncoder encoder;
+    BinaryDecoder decoder;
+    encoder.enableContentRegistry();
+    decoder.enableContentRegistry();
+
+    const DisplayGroupPtr group = makeDisplayGroup();
+    std::string buffer;
+    DisplayGroupPtr decoded;
+
+    encoder.encode( group, buffer );
+    decoder.decode( buffer.data(), buffer.size(), decoded );
+
+    const ContentWindowPtr removedWindow = group->getContentWindows()[0];
+    group->removeContentWindow( removedWindow );
+    ContentPtr stream( new PixelStreamContent( "newstream" ));
+    group->addContentWindow( makeWindow( stream, QRectF( 5, 5, 10, 10 )));
+
+    encoder.encode( group, buffer );
+    decoder.decode( buffer.data(), buffer.size(), decoded );
+    checkEqual( *decoded, *group );
+
+    // The removed content is sent again if it is re-added later
+    group->addContentWindow( removedWindow );
+    encoder.encode( group, buffer );
+    decoder.decode( buffer.data(), buffer.size(), decoded );
+    checkEqual( *decoded, *group );
+}
@@ -0,0 +1,274 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+#define BOOST_TEST_MODULE ClusterMetricsTests
+#include <boost/test/unit_test.hpp>
+namespace ut = boost::unit_test;
+
+#include "ClusterMetrics.h"
+#include "SerializeBuffer.h"
+#include "ws/MetricsHandler.h"
+
+#include "dc/webservice/Request.h"
+#include "dc/webservice/Response.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+namespace
+{
+ProcessMetrics makeMetrics( const int rank )
+{
+    ProcessMetrics metrics;
+    metrics.rank = rank;
+    metrics.frameTimes.add( 0.5 );
+    metrics.frameTimes.add( 16.0 );
+    metrics.frameTimes.add( 2000.0 );
+    metrics.decodeTimes.add( 4.0 );
+    metrics.gpuWaitTimes.add( 2.0 );
+    metrics.wakeTimes.add( 20.0 );
+    metrics.controlQueueTimes.add( 1.0 );
+    metrics.streamQueueTimes.add( 8.0 );
+    metrics.streamsFps["my \"stream\""] = 30.0;
+    metrics.textureMemory = 4096;
+    metrics.queueDepth = 2;
+    metrics.skippedFrames = 5;
+    metrics.supersededFrames = 6;
+    metrics.cpuTime = 1.5;
+    metrics.uploadBacklog = 3;
+    metrics.maxUploadFrameTime = 250.0;
+    metrics.windowsMemory["window"] = 2048;
+    metrics.contentTypesMemory["Texture"] = 2048;
+    metrics.memoryBudget = 8192;
+    metrics.evictions = 4;
+    return metrics;
+}
+
+bool contains( const std::string& text, const std::string& line )
+{
+    return text.find( line + "\n" ) != std::string::npos;
+}
+}
+
+BOOST_AUTO_TEST_CASE( testHistogramBuckets )
+{
+    const std::vector< double >& bounds = DurationHistogram::getBounds();
+
+    DurationHistogram histogram;
+    BOOST_REQUIRE_EQUAL( histogram.counts.size(), bounds.size() + 1 );
+
+    histogram.add( 0.5 );
+    histogram.add( bounds[0] );
+    histogram.add( bounds.back() + 1.0 );
+
+    BOOST_CHECK_EQUAL( histogram.count, 3 );
+    BOOST_CHECK_CLOSE( histogram.sum, 0.5 + bounds[0] + bounds.back() + 1.0,
+                       1e-9 );
+    BOOST_CHECK_EQUAL( histogram.counts.front(), 2 );
+    BOOST_CHECK_EQUAL( histogram.counts.back(), 1 );
+}
+
+BOOST_AUTO_TEST_CASE( testProcessMetricsSerialization )
+{
+    const ProcessMetrics metrics = makeMetrics( 3 );
+
+    SerializeBuffer buffer;
+    const std::string& data = SerializeBuffer::serialize( metrics );
+    buffer.setSize( data.size( ));
+    std::copy( data.begin(), data.end(), buffer.data( ));
+
+    ProcessMetrics received;
+    buffer.deserialize( received );
+
+    BOOST_CHECK_EQUAL( received.rank, 3 );
+    BOOST_CHECK_EQUAL( received.frameTimes.count, 3 );
+    BOOST_CHECK( received.frameTimes.counts == metrics.frameTimes.counts );
+    BOOST_CHECK_EQUAL( received.decodeTimes.sum, 4.0 );
+    BOOST_CHECK_EQUAL( received.gpuWaitTimes.sum, 2.0 );
+    BOOST_CHECK_EQUAL( received.wakeTimes.sum, 20.0 );
+    BOOST_CHECK_EQUAL( received.controlQueueTimes.sum, 1.0 );
+    BOOST_CHECK_EQUAL( received.streamQueueTimes.sum, 8.0 );
+    BOOST_CHECK( received.streamsFps == metrics.streamsFps );
+    BOOST_CHECK_EQUAL( received.textureMemory, 4096 );
+    BOOST_CHECK_EQUAL( received.queueDepth, 2 );
+    BOOST_CHECK_EQUAL( received.skippedFrames, 5 );
+    BOOST_CHECK_EQUAL( received.supersededFrames, 6 );
+    BOOST_CHECK_EQUAL( received.cpuTime, 1.5 );
+    BOOST_CHECK_EQUAL( received.uploadBacklog, 3 );
+    BOOST_CHECK_EQUAL( received.maxUploadFrameTime, 250.0 );
+    BOOST_CHECK( received.windowsMemory == metrics.windowsMemory );
+    BOOST_CHECK( received.contentTypesMemory == metrics.contentTypesMemory );
+    BOOST_CHECK_EQUAL( received.memoryBudget, 8192 );
+    BOOST_CHECK_EQUAL( received.evictions, 4 );
+}
+
+BOOST_AUTO_TEST_CASE( testJsonExport )
+{
+    ClusterMetrics clusterMetrics;
+    clusterMetrics.update( makeMetrics( 2 ));
+    clusterMetrics.update( makeMetrics( 1 ));
+
+    const std::string json = clusterMetrics.toJson();
+    const QJsonDocument doc =
+            QJsonDocument::fromJson( QByteArray::fromStdString( json ));
+    BOOST_REQUIRE( doc.isObject( ));
+
+    const QJsonArray processes = doc.object()["processes"].toArray();
+    BOOST_REQUIRE_EQUAL( processes.size(), 2 );
+
+    const QJsonObject process = processes[0].toObject();
+    BOOST_CHECK_EQUAL( process["rank"].toInt(), 1 );
+    BOOST_CHECK_EQUAL( process["textureMemory"].toDouble(), 4096 );
+    BOOST_CHECK_EQUAL( process["queueDepth"].toDouble(), 2 );
+    BOOST_CHECK_EQUAL( process["supersededFrames"].toDouble(), 6 );
+    BOOST_CHECK_EQUAL( process["streamQueueTimes"].toObject()["sum"]
+                       .toDouble(), 8.0 );
+    BOOST_CHECK_EQUAL( process["streamsFps"].toObject()["my \"stream\""]
+                       .toDouble(), 30.0 );
+    BOOST_CHECK_EQUAL( process["windowsMemory"].toObject()["window"]
+                       .toDouble(), 2048 );
+    BOOST_CHECK_EQUAL( process["contentTypesMemory"].toObject()["Texture"]
+                       .toDouble(), 2048 );
+
+    const QJsonObject frameTimes = process["frameTimes"].toObject();
+    BOOST_CHECK_EQUAL( frameTimes["count"].toDouble(), 3 );
+    const QJsonArray buckets = frameTimes["buckets"].toArray();
+    BOOST_REQUIRE_EQUAL( (size_t)buckets.size(),
+                         DurationHistogram::getBounds().size() + 1 );
+    BOOST_CHECK_EQUAL( buckets.first().toObject()["count"].toDouble(), 1 );
+    BOOST_CHECK_EQUAL( buckets.last().toObject()["le"].toString().toStdString(),
+                       "+Inf" );
+    BOOST_CHECK_EQUAL( buckets.last().toObject()["count"].toDouble(), 3 );
+}
+
+BOOST_AUTO_TEST_CASE( testPrometheusExport )
+{
+    ClusterMetrics clusterMetrics;
+    clusterMetrics.update( makeMetrics( 1 ));
+
+    const std::string text = clusterMetrics.toPrometheus();
+
+    BOOST_CHECK( contains( text, "# TYPE displaycluster_frame_duration_seconds "
+                                 "histogram" ));
+    BOOST_CHECK( contains( text, "displaycluster_frame_duration_seconds_bucket"
+                                 "{rank=\"1\",le=\"0.001\"} 1" ));
+    BOOST_CHECK( contains( text, "displaycluster_frame_duration_seconds_bucket"
+                                 "{rank=\"1\",le=\"0.0167\"} 2" ));
+    BOOST_CHECK( contains( text, "displaycluster_frame_duration_seconds_bucket"
+                                 "{rank=\"1\",le=\"+Inf\"} 3" ));
+    BOOST_CHECK( contains( text, "displaycluster_frame_duration_seconds_count"
+                                 "{rank=\"1\"} 3" ));
+    BOOST_CHECK( contains( text, "displaycluster_decode_duration_seconds_sum"
+                                 "{rank=\"1\"} 0.004" ));
+    BOOST_CHECK( contains( text, "displaycluster_gpu_wait_duration_seconds_sum"
+                                 "{rank=\"1\"} 0.002" ));
+    BOOST_CHECK( contains( text, "displaycluster_wake_duration_seconds_sum"
+                                 "{rank=\"1\"} 0.02" ));
+    BOOST_CHECK( contains( text, "displaycluster_control_queue_duration_seconds"
+                                 "_sum{rank=\"1\"} 0.001" ));
+    BOOST_CHECK( contains( text, "displaycluster_stream_queue_duration_seconds"
+                                 "_sum{rank=\"1\"} 0.008" ));
+    BOOST_CHECK( contains( text, "displaycluster_stream_fps{rank=\"1\","
+                                 "stream=\"my \\\"stream\\\"\"} 30" ));
+    BOOST_CHECK( contains( text, "displaycluster_texture_memory_bytes"
+                                 "{rank=\"1\"} 4096" ));
+    BOOST_CHECK( contains( text, "displaycluster_queue_depth{rank=\"1\"} 2" ));
+    BOOST_CHECK( contains( text, "displaycluster_skipped_frames_total"
+                                 "{rank=\"1\"} 5" ));
+    BOOST_CHECK( contains( text, "displaycluster_superseded_frames_total"
+                                 "{rank=\"1\"} 6" ));
+    BOOST_CHECK( contains( text, "displaycluster_cpu_seconds_total"
+                                 "{rank=\"1\"} 1.5" ));
+    BOOST_CHECK( contains( text, "displaycluster_upload_backlog"
+                                 "{rank=\"1\"} 3" ));
+    BOOST_CHECK( contains( text, "displaycluster_upload_frame_max_seconds"
+                                 "{rank=\"1\"} 0.25" ));
+    BOOST_CHECK( contains( text, "displaycluster_window_memory_bytes"
+                                 "{rank=\"1\",window=\"window\"} 2048" ));
+    BOOST_CHECK( contains( text, "displaycluster_content_type_memory_bytes"
+                                 "{rank=\"1\",type=\"Texture\"} 2048" ));
+    BOOST_CHECK( contains( text, "displaycluster_evictions_total"
+                                 "{rank=\"1\"} 4" ));
+}
+
+BOOST_AUTO_TEST_CASE( testFrameRateFromConsecutiveReports )
+{
+    ClusterMetrics clusterMetrics;
+    ProcessMetrics metrics = makeMetrics( 1 );
+    clusterMetrics.update( metrics );
+    BOOST_CHECK( contains( clusterMetrics.toPrometheus(),
+                           "displaycluster_frame_rate{rank=\"1\"} 0" ));
+
+    for( size_t i = 0; i < 10; ++i )
+        metrics.frameTimes.add( 16.0 );
+    clusterMetrics.update( metrics );
+
+    const QJsonDocument doc = QJsonDocument::fromJson(
+                QByteArray::fromStdString( clusterMetrics.toJson( )));
+    const QJsonObject process =
+            doc.object()["processes"].toArray()[0].toObject();
+    BOOST_CHECK_GT( process["frameRate"].toDouble(), 0.0 );
+}
+
+BOOST_AUTO_TEST_CASE( testMetricsHandlerFormats )
+{
+    ClusterMetricsPtr clusterMetrics( new ClusterMetrics );
+    clusterMetrics->update( makeMetrics( 1 ));
+
+    const dcWebservice::Request request;
+
+    const MetricsHandler jsonHandler( clusterMetrics,
+                                      MetricsHandler::FORMAT_JSON );
+    dcWebservice::ConstResponsePtr response = jsonHandler.handle( request );
+    BOOST_CHECK_EQUAL( response->statusCode, 200 );
+    BOOST_CHECK_EQUAL( response->httpHeaders.at( "Content-Type" ),
+                       "application/json" );
+    BOOST_CHECK( QJsonDocument::fromJson( QByteArray::fromStdString(
+                                              response->body )).isObject( ));
+
+    const MetricsHandler prometheusHandler( clusterMetrics,
+                                            MetricsHandler::FORMAT_PROMETHEUS );
+    response = prometheusHandler.handle( request );
+    BOOST_CHECK_EQUAL( response->statusCode, 200 );
+    BOOST_CHECK_EQUAL( response->httpHeaders.at( "Content-Type" ),
+                       "text/plain; version=0.0.4" );
+    BOOST_CHECK( response->body.find( "# TYPE displaycluster_queue_depth" ) !=
+                 std::string::npos );
+}
@@ -45,6 +45,11 @@ namespace ut = boost::unit_test;
 
 #include "configuration/MasterConfiguration.h"
 #include "configuration/WallConfiguration.h"
+#include "ContentLoadingPolicy.h"
+#include "GLFrameSync.h"
+#include "MemoryAccountant.h"
+#include "MessageCompressor.h"
+#include "UploadScheduler.h"
 
 #include <QDir>
 
@@ -60,6 +65,13 @@ namespace ut = boost::unit_test;
 #define CONFIG_EXPECTED_WEBSERVICE_PORT 10000
 #define CONFIG_EXPECTED_URL "http://bbp.epfl.ch"
 #define CONFIG_EXPECTED_DEFAULT_URL "http://www.google.com"
+#define CONFIG_EXPECTED_MPI_COMPRESSION_THRESHOLD 4096u
+#define CONFIG_EXPECTED_UPLOAD_BUDGET_BYTES (32u * 1024 * 1024)
+#define CONFIG_EXPECTED_UPLOAD_BUDGET_MS 4.0
+#define CONFIG_EXPECTED_MEMORY_BUDGET_BYTES (1024u * 1024 * 1024)
+#define CONFIG_EXPECTED_PREFETCH_MARGIN 256
+#define CONFIG_EXPECTED_UNLOAD_DELAY_MS 5000
+#define CONFIG_EXPECTED_FRAMES_IN_FLIGHT 2u
 
 BOOST_GLOBAL_FIXTURE( MinimalGlobalQtApp );
 
@@ -96,6 +108,25 @@ BOOST_AUTO_TEST_CASE( test_wall_configuration )
     BOOST_CHECK_EQUAL( config.getHost().toStdString(), CONFIG_EXPECTED_HOST_NAME );
 
     BOOST_CHECK_EQUAL( config.getScreenCount(), 1 );
+
+    BOOST_CHECK_EQUAL( config.getUploadBudgetBytes(), CONFIG_EXPECTED_UPLOAD_BUDGET_BYTES );
+    BOOST_CHECK_EQUAL( config.getUploadBudgetMs(), CONFIG_EXPECTED_UPLOAD_BUDGET_MS );
+    BOOST_CHECK_EQUAL( config.getMemoryBudgetBytes(), CONFIG_EXPECTED_MEMORY_BUDGET_BYTES );
+    BOOST_CHECK_EQUAL( config.getPrefetchMargin(), CONFIG_EXPECTED_PREFETCH_MARGIN );
+    BOOST_CHECK_EQUAL( config.getUnloadDelayMs(), CONFIG_EXPECTED_UNLOAD_DELAY_MS );
+    BOOST_CHECK_EQUAL( config.getFramesInFlight(), CONFIG_EXPECTED_FRAMES_IN_FLIGHT );
+}
+
+BOOST_AUTO_TEST_CASE( test_wall_configuration_default_values )
+{
+    WallConfiguration config( CONFIG_TEST_FILENAME_II, 1 );
+
+    BOOST_CHECK_EQUAL( config.getUploadBudgetBytes(), UploadScheduler::DEFAULT_BUDGET_BYTES );
+    BOOST_CHECK_EQUAL( config.getUploadBudgetMs(), UploadScheduler::DEFAULT_BUDGET_MS );
+    BOOST_CHECK_EQUAL( config.getMemoryBudgetBytes(), MemoryAccountant::DEFAULT_BUDGET_BYTES );
+    BOOST_CHECK_EQUAL( config.getPrefetchMargin(), ContentLoadingPolicy::DEFAULT_PREFETCH_MARGIN );
+    BOOST_CHECK_EQUAL( config.getUnloadDelayMs(), ContentLoadingPolicy::DEFAULT_UNLOAD_DELAY_MS );
+    BOOST_CHECK_EQUAL( config.getFramesInFlight(), GLFrameSync::DEFAULT_FRAMES_IN_FLIGHT );
 }
 
 BOOST_AUTO_TEST_CASE( test_master_configuration )
@@ -108,6 +139,7 @@ BOOST_AUTO_TEST_CASE( test_master_configuration )
 
     BOOST_CHECK( config.getBackgroundColor() == QColor( CONFIG_EXPECTED_BACKGROUND_COLOR ));
     BOOST_CHECK_EQUAL( config.getBackgroundUri().toStdString(), CONFIG_EXPECTED_BACKGROUND );
+    BOOST_CHECK_EQUAL( config.getMPICompressionThreshold(), CONFIG_EXPECTED_MPI_COMPRESSION_THRESHOLD );
 }
 
 BOOST_AUTO_TEST_CASE( test_master_configuration_default_values )
@@ -116,6 +148,7 @@ BOOST_AUTO_TEST_CASE( test_master_configuration_default_values )
 
     BOOST_CHECK_EQUAL( config.getDockStartDir().toStdString(), QDir::homePath().toStdString() );
     BOOST_CHECK_EQUAL( config.getWebBrowserDefaultURL().toStdString(), CONFIG_EXPECTED_DEFAULT_URL );
+    BOOST_CHECK_EQUAL( config.getMPICompressionThreshold(), MessageCompressor::DEFAULT_THRESHOLD );
 }
 
 BOOST_AUTO_TEST_CASE( test_save_configuration )
@@ -0,0 +1,117 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+
+#define BOOST_TEST_MODULE ContentCacheTests
+#include <boost/test/unit_test.hpp>
+namespace ut = boost::unit_test;
+
+#include "ContentCache.h"
+
+namespace
+{
+const QString KEY( "image.png#0" );
+const QString OTHER_KEY( "image.png#1" );
+}
+
+BOOST_AUTO_TEST_CASE( testObjectsAreSharedWhileInUse )
+{
+    ContentCache cache;
+    BOOST_CHECK( !cache.find<int>( KEY ));
+
+    boost::shared_ptr<int> object( new int( 42 ));
+    cache.insert( KEY, object );
+    BOOST_CHECK_EQUAL( cache.getSize(), 1u );
+
+    boost::shared_ptr<int> shared = cache.find<int>( KEY );
+    BOOST_REQUIRE( shared );
+    BOOST_CHECK_EQUAL( shared.get(), object.get( ));
+    BOOST_CHECK( !cache.find<int>( OTHER_KEY ));
+
+    object.reset();
+    BOOST_CHECK( cache.find<int>( KEY ));
+
+    shared.reset();
+    BOOST_CHECK( !cache.find<int>( KEY ));
+    BOOST_CHECK_EQUAL( cache.getSize(), 0u );
+}
+
+BOOST_AUTO_TEST_CASE( testObjectsOfDifferentTypesDoNotCollide )
+{
+    ContentCache cache;
+
+    boost::shared_ptr<int> number( new int( 42 ));
+    boost::shared_ptr<double> value( new double( 0.5 ));
+    cache.insert( KEY, number );
+    cache.insert( KEY, value );
+
+    BOOST_CHECK_EQUAL( cache.getSize(), 2u );
+    BOOST_CHECK_EQUAL( cache.find<int>( KEY ).get(), number.get( ));
+    BOOST_CHECK_EQUAL( cache.find<double>( KEY ).get(), value.get( ));
+}
+
+BOOST_AUTO_TEST_CASE( testInsertReplacesPreviousObject )
+{
+    ContentCache cache;
+
+    boost::shared_ptr<int> first( new int( 1 ));
+    boost::shared_ptr<int> second( new int( 2 ));
+    cache.insert( KEY, first );
+    cache.insert( KEY, second );
+
+    BOOST_CHECK_EQUAL( cache.getSize(), 1u );
+    BOOST_CHECK_EQUAL( *cache.find<int>( KEY ), 2 );
+}
+
+BOOST_AUTO_TEST_CASE( testTextureKeysDependOnSizeAndRegion )
+{
+    const QString uri( "document.pdf#0" );
+    const QSize size( 800, 600 );
+    const QRectF region( 0.25, 0.25, 0.5, 0.5 );
+    const QRectF closeRegion( 0.25, 0.25, 0.5000001, 0.5 );
+
+    BOOST_CHECK( ContentCache::makeKey( uri, size, region ) ==
+                 ContentCache::makeKey( uri, size, region ));
+    BOOST_CHECK( ContentCache::makeKey( uri, size, region ) !=
+                 ContentCache::makeKey( uri, size, closeRegion ));
+    BOOST_CHECK( ContentCache::makeKey( uri, size, region ) !=
+                 ContentCache::makeKey( uri, QSize( 800, 601 ), region ));
+    BOOST_CHECK( ContentCache::makeKey( uri, size, region ) !=
+                 ContentCache::makeKey( "document.pdf#1", size, region ));
+}
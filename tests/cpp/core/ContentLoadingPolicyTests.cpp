@@ -0,0 +1,101 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+
+#define BOOST_TEST_MODULE ContentLoadingPolicyTests
+#include <boost/test/unit_test.hpp>
+namespace ut = boost::unit_test;
+
+#include "ContentLoadingPolicy.h"
+
+namespace
+{
+const int PREFETCH_MARGIN = 100;
+const int UNLOAD_DELAY_MS = 1000;
+const QRegion WALL_AREA( QRect( 0, 0, 1920, 1080 ));
+const QRectF VISIBLE_RECT( 100, 100, 400, 300 );
+const QRectF NEARBY_RECT( 1950, 100, 400, 300 );
+const QRectF DISTANT_RECT( 3000, 100, 400, 300 );
+
+boost::posix_time::ptime getTime( const int milliseconds )
+{
+    const boost::posix_time::ptime start( boost::gregorian::date( 2015, 1, 1 ));
+    return start + boost::posix_time::milliseconds( milliseconds );
+}
+}
+
+BOOST_AUTO_TEST_CASE( testContentIsLoadedNearTheScreens )
+{
+    ContentLoadingPolicy policy( PREFETCH_MARGIN, UNLOAD_DELAY_MS );
+    BOOST_CHECK( !policy.isLoaded( ));
+
+    BOOST_CHECK( !policy.update( DISTANT_RECT, WALL_AREA, getTime( 0 )));
+    BOOST_CHECK( policy.update( NEARBY_RECT, WALL_AREA, getTime( 10 )));
+    BOOST_CHECK( policy.isLoaded( ));
+
+    ContentLoadingPolicy visiblePolicy( PREFETCH_MARGIN, UNLOAD_DELAY_MS );
+    BOOST_CHECK( visiblePolicy.update( VISIBLE_RECT, WALL_AREA, getTime( 0 )));
+
+    ContentLoadingPolicy noMarginPolicy( 0, UNLOAD_DELAY_MS );
+    BOOST_CHECK( !noMarginPolicy.update( NEARBY_RECT, WALL_AREA, getTime( 0 )));
+}
+
+BOOST_AUTO_TEST_CASE( testContentIsUnloadedAfterDelay )
+{
+    ContentLoadingPolicy policy( PREFETCH_MARGIN, UNLOAD_DELAY_MS );
+
+    BOOST_REQUIRE( policy.update( VISIBLE_RECT, WALL_AREA, getTime( 0 )));
+    BOOST_CHECK( policy.update( DISTANT_RECT, WALL_AREA, getTime( 500 )));
+    BOOST_CHECK( policy.update( DISTANT_RECT, WALL_AREA,
+                                getTime( UNLOAD_DELAY_MS - 1 )));
+    BOOST_CHECK( !policy.update( DISTANT_RECT, WALL_AREA,
+                                 getTime( UNLOAD_DELAY_MS )));
+    BOOST_CHECK( !policy.isLoaded( ));
+}
+
+BOOST_AUTO_TEST_CASE( testComingBackResetsTheUnloadDelay )
+{
+    ContentLoadingPolicy policy( PREFETCH_MARGIN, UNLOAD_DELAY_MS );
+
+    BOOST_REQUIRE( policy.update( VISIBLE_RECT, WALL_AREA, getTime( 0 )));
+    BOOST_CHECK( policy.update( DISTANT_RECT, WALL_AREA, getTime( 800 )));
+    BOOST_CHECK( policy.update( NEARBY_RECT, WALL_AREA, getTime( 900 )));
+    BOOST_CHECK( policy.update( DISTANT_RECT, WALL_AREA, getTime( 1500 )));
+    BOOST_CHECK( !policy.update( DISTANT_RECT, WALL_AREA, getTime( 1900 )));
+}
@@ -183,3 +183,45 @@ BOOST_AUTO_TEST_CASE( testToggleSelectedState )
     window.toggleSelectedState();
     BOOST_CHECK_EQUAL( window.getState(), ContentWindow::HIDDEN );
 }
+
+BOOST_AUTO_TEST_CASE( testUpdateOnlyNotifiesChangedProperties )
+{
+    ContentPtr content( new DummyContent );
+    content->setDimensions( QSize( WIDTH, HEIGHT ));
+    ContentWindow window( content );
+    ContentWindow newWindow( content );
+
+    int notifications = 0;
+    int zoomNotifications = 0;
+    QObject::connect( &window, &ContentWindow::xChanged,
+                      [&notifications]() { ++notifications; } );
+    QObject::connect( &window, &ContentWindow::contentChanged,
+                      [&notifications]() { ++notifications; } );
+    QObject::connect( &window, &ContentWindow::stateChanged,
+                      [&notifications]() { ++notifications; } );
+    QObject::connect( &window, &ContentWindow::zoomRectChanged,
+                      [&zoomNotifications]() { ++zoomNotifications; } );
+
+    window.update( newWindow );
+    BOOST_CHECK_EQUAL( notifications, 0 );
+    BOOST_CHECK_EQUAL( zoomNotifications, 0 );
+
+    newWindow.setZoomRect( QRectF( 0.2, 0.2, 0.7, 0.7 ));
+    window.update( newWindow );
+    BOOST_CHECK_EQUAL( notifications, 0 );
+    BOOST_CHECK_EQUAL( zoomNotifications, 1 );
+    BOOST_CHECK( window.getZoomRect() == QRectF( 0.2, 0.2, 0.7, 0.7 ));
+
+    ContentPtr secondContent( new DummyContent );
+    secondContent->setDimensions( QSize( WIDTH, HEIGHT ));
+    newWindow.setContent( secondContent );
+    newWindow.setX( 100.0 );
+    newWindow.setFocused( true );
+    window.update( newWindow );
+    BOOST_CHECK_EQUAL( notifications, 3 );
+    BOOST_CHECK_EQUAL( zoomNotifications, 1 );
+    BOOST_CHECK_EQUAL( window.getContent(), secondContent );
+    BOOST_CHECK_EQUAL( window.getCoordinates().x(), 100.0 );
+    BOOST_CHECK( window.isFocused( ));
+    BOOST_CHECK_EQUAL( window.getState(), ContentWindow::SELECTED );
+}
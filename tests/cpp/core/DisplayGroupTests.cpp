@@ -0,0 +1,109 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+
+#define BOOST_TEST_MODULE DisplayGroupTests
+#include <boost/test/unit_test.hpp>
+namespace ut = boost::unit_test;
+
+#include "ContentWindow.h"
+#include "DisplayGroup.h"
+
+#include "MinimalGlobalQtApp.h"
+BOOST_GLOBAL_FIXTURE( MinimalGlobalQtApp )
+
+#include "DummyContent.h"
+
+namespace
+{
+const QSizeF wallSize( 1000, 1000 );
+const int WIDTH = 512;
+const int HEIGHT = 512;
+}
+
+BOOST_AUTO_TEST_CASE( testUpdateOnlyNotifiesChangedProperties )
+{
+    DisplayGroupPtr wallGroup( new DisplayGroup( wallSize ));
+    DisplayGroupPtr newGroup( new DisplayGroup( wallSize ));
+
+    int notifications = 0;
+    int titleNotifications = 0;
+    int focusNotifications = 0;
+    QObject::connect( wallGroup.get(), &DisplayGroup::xChanged,
+                      [&notifications]() { ++notifications; } );
+    QObject::connect( wallGroup.get(), &DisplayGroup::widthChanged,
+                      [&notifications]() { ++notifications; } );
+    QObject::connect( wallGroup.get(), &DisplayGroup::showWindowTitlesChanged,
+                      [&titleNotifications]() { ++titleNotifications; } );
+    QObject::connect( wallGroup.get(), &DisplayGroup::hasFocusedWindowsChanged,
+                      [&focusNotifications]() { ++focusNotifications; } );
+
+    wallGroup->update( *newGroup );
+    BOOST_CHECK_EQUAL( notifications, 0 );
+    BOOST_CHECK_EQUAL( titleNotifications, 0 );
+    BOOST_CHECK_EQUAL( focusNotifications, 0 );
+
+    ContentPtr content( new DummyContent );
+    content->setDimensions( QSize( WIDTH, HEIGHT ));
+    ContentWindowPtr window( new ContentWindow( content ));
+    newGroup->addContentWindow( window );
+    wallGroup->update( *newGroup );
+    BOOST_CHECK_EQUAL( notifications, 0 );
+    BOOST_CHECK_EQUAL( focusNotifications, 0 );
+
+    newGroup->setShowWindowTitles( false );
+    newGroup->focus( window->getID( ));
+    wallGroup->update( *newGroup );
+    BOOST_CHECK_EQUAL( notifications, 0 );
+    BOOST_CHECK_EQUAL( titleNotifications, 1 );
+    BOOST_CHECK_EQUAL( focusNotifications, 1 );
+    BOOST_CHECK( !wallGroup->getShowWindowTitles( ));
+    BOOST_CHECK( wallGroup->hasFocusedWindows( ));
+    // The windows of newGroup are not copied, not even the focused ones
+    BOOST_CHECK( wallGroup->getFocusedWindows().empty( ));
+
+    newGroup->setX( 10.0 );
+    newGroup->unfocus( window->getID( ));
+    wallGroup->update( *newGroup );
+    BOOST_CHECK_EQUAL( notifications, 1 );
+    BOOST_CHECK_EQUAL( titleNotifications, 1 );
+    BOOST_CHECK_EQUAL( focusNotifications, 2 );
+    BOOST_CHECK_EQUAL( wallGroup->getCoordinates().x(), 10.0 );
+    BOOST_CHECK( !wallGroup->hasFocusedWindows( ));
+}
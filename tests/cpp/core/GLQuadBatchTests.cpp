@@ -0,0 +1,156 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+
+#define BOOST_TEST_MODULE GLQuadBatchTests
+#include <boost/test/unit_test.hpp>
+namespace ut = boost::unit_test;
+
+#include "GLQuadBatch.h"
+#include "OffscreenRenderer.h"
+
+#include "GlobalQtApp.h"
+BOOST_GLOBAL_FIXTURE( GlobalQtApp );
+
+#include <QGraphicsItem>
+#include <QGraphicsScene>
+#include <QImage>
+#include <QPainter>
+#include <QTemporaryDir>
+
+namespace
+{
+const QRect screenRect( 0, 0, 300, 100 );
+const QString FIRST_FRAME_FILENAME( "/frame_000001_screen_0_0.png" );
+
+GLuint createTexture( const QColor& color )
+{
+    const GLubyte pixel[4] = { GLubyte( color.red( )), GLubyte( color.green( )),
+                               GLubyte( color.blue( )),
+                               GLubyte( color.alpha( )) };
+    GLuint textureId = 0;
+    glGenTextures( 1, &textureId );
+    glBindTexture( GL_TEXTURE_2D, textureId );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+    glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA,
+                  GL_UNSIGNED_BYTE, pixel );
+    glBindTexture( GL_TEXTURE_2D, 0 );
+    return textureId;
+}
+
+// Render a batch in item coordinates, like the ContentItem of a window
+class BatchItem : public QGraphicsItem
+{
+public:
+    BatchItem() : drawCalls( 0 ) {}
+
+    QRectF boundingRect() const override { return screenRect; }
+
+    void paint( QPainter* painter, const QStyleOptionGraphicsItem*,
+                QWidget* ) override
+    {
+        painter->beginNativePainting();
+        drawCalls = batch.render();
+        painter->endNativePainting();
+    }
+
+    GLQuadBatch batch;
+    size_t drawCalls;
+};
+
+QColor colorAt( const QImage& image, const int x, const int y )
+{
+    return QColor( image.pixel( x, y ));
+}
+}
+
+BOOST_AUTO_TEST_CASE( testBatchedQuadsAreSortedByBlendingAndTexture )
+{
+    if( !hasGLXDisplay( ))
+        return;
+
+    QGraphicsScene scene( screenRect );
+    BatchItem* item = new BatchItem;
+    scene.addItem( item );
+
+    // The context of the renderer is current from now on
+    OffscreenRenderer renderer( scene );
+    renderer.addScreen( screenRect, QPoint( 0, 0 ), TestPatternPtr( ));
+
+    QTemporaryDir dumpFolder;
+    BOOST_REQUIRE( dumpFolder.isValid( ));
+    renderer.setFrameDumpFolder( dumpFolder.path( ));
+
+    const GLuint red = createTexture( Qt::red );
+    const GLuint blue = createTexture( Qt::blue );
+    const GLuint halfGreen = createTexture( QColor( 0, 255, 0, 128 ));
+
+    const QRectF unit( 0, 0, 1, 1 );
+    // Added first but drawn last, over the blue quad
+    item->batch.add( QRectF( 100, 0, 100, 100 ), unit, halfGreen, true );
+    item->batch.add( QRectF( 0, 0, 100, 100 ), unit, red );
+    item->batch.add( QRectF( 100, 0, 100, 100 ), unit, blue );
+    item->batch.add( QRectF( 200, 0, 100, 100 ), unit, red );
+    BOOST_REQUIRE_EQUAL( item->batch.getQuadCount(), 4u );
+
+    renderer.render();
+    renderer.finishFrame();
+
+    // One call for each texture, the two red quads share theirs
+    BOOST_CHECK_EQUAL( item->drawCalls, 3u );
+    BOOST_CHECK_EQUAL( item->batch.getQuadCount(), 0u );
+
+    const QImage frame( dumpFolder.path() + FIRST_FRAME_FILENAME );
+    BOOST_REQUIRE( !frame.isNull( ));
+
+    // Each quad kept its own position and texture after sorting
+    BOOST_CHECK( colorAt( frame, 50, 50 ) == QColor( Qt::red ));
+    BOOST_CHECK( colorAt( frame, 250, 50 ) == QColor( Qt::red ));
+
+    // The blended quad was drawn after the opaque blue one
+    const QColor blended = colorAt( frame, 150, 50 );
+    BOOST_CHECK_EQUAL( blended.red(), 0 );
+    BOOST_CHECK( blended.green() > 100 );
+    BOOST_CHECK( blended.blue() > 100 );
+
+    glDeleteTextures( 1, &red );
+    glDeleteTextures( 1, &blue );
+    glDeleteTextures( 1, &halfGreen );
+}
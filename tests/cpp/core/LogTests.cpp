@@ -0,0 +1,178 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+#define BOOST_TEST_MODULE LogTests
+#include <boost/test/unit_test.hpp>
+namespace ut = boost::unit_test;
+
+#include "log.h"
+
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+/** Capture std::cerr and std::cout while in scope. */
+class CaptureOutput
+{
+public:
+    CaptureOutput()
+        : _cerr( std::cerr.rdbuf( _errors.rdbuf( )))
+        , _cout( std::cout.rdbuf( _output.rdbuf( )))
+    {
+        flush_log();
+    }
+
+    ~CaptureOutput()
+    {
+        std::cerr.rdbuf( _cerr );
+        std::cout.rdbuf( _cout );
+    }
+
+    std::string getErrors()
+    {
+        flush_log();
+        return _errors.str();
+    }
+
+    std::string getOutput()
+    {
+        flush_log();
+        return _output.str();
+    }
+
+private:
+    std::ostringstream _errors;
+    std::ostringstream _output;
+    std::streambuf* _cerr;
+    std::streambuf* _cout;
+};
+
+size_t countLines( const std::string& text, const std::string& pattern )
+{
+    size_t count = 0;
+    std::istringstream lines( text );
+    std::string line;
+    while( std::getline( lines, line ))
+    {
+        if( line.find( pattern ) != std::string::npos )
+            ++count;
+    }
+    return count;
+}
+}
+
+BOOST_AUTO_TEST_CASE( testMessagesAreWrittenWithPrefix )
+{
+    CaptureOutput capture;
+    logger_id = "rank1";
+
+    put_log( LOG_WARN, "warning %d", 1 );
+    put_log( LOG_ERROR, "error %s", "two" );
+
+    const std::string errors = capture.getErrors();
+    const std::string output = capture.getOutput();
+    logger_id = "";
+
+    BOOST_CHECK( errors.find( "{rank1} warning 1\n" ) != std::string::npos );
+    BOOST_CHECK( output.find( "{rank1} error two\n" ) != std::string::npos );
+    BOOST_CHECK( errors.find( "error two" ) == std::string::npos );
+    BOOST_CHECK_EQUAL( errors.find( '[' ), 27 ); // after the timestamp
+}
+
+BOOST_AUTO_TEST_CASE( testThresholdFiltersMessages )
+{
+    CaptureOutput capture;
+    const int threshold = get_log_threshold();
+
+    set_log_threshold( LOG_WARN );
+    put_log( LOG_INFO, "filtered" );
+    put_log( LOG_WARN, "logged" );
+    set_log_threshold( threshold );
+
+    const std::string errors = capture.getErrors();
+    BOOST_CHECK_EQUAL( countLines( errors, "filtered" ), 0 );
+    BOOST_CHECK_EQUAL( countLines( errors, "logged" ), 1 );
+}
+
+BOOST_AUTO_TEST_CASE( testMessagesOfOneThreadKeepTheirOrder )
+{
+    CaptureOutput capture;
+
+    for( int i = 0; i < 50; ++i )
+        put_log( LOG_WARN, "ordered %d", i );
+
+    std::istringstream lines( capture.getErrors( ));
+    std::string line;
+    int expected = 0;
+    while( std::getline( lines, line ))
+    {
+        if( line.find( "ordered " ) == std::string::npos )
+            continue;
+        const std::string suffix = " ordered " + std::to_string( expected );
+        BOOST_CHECK_EQUAL( line.substr( line.size() - suffix.size( )),
+                           suffix );
+        ++expected;
+    }
+    BOOST_CHECK_EQUAL( expected, 50 );
+}
+
+BOOST_AUTO_TEST_CASE( testMessagesAreDroppedNotLostWhenRingsOverflow )
+{
+    CaptureOutput capture;
+
+    const size_t droppedBefore = get_dropped_log_count();
+    const size_t threadsCount = 4;
+    const size_t messagesCount = 5000;
+
+    std::vector< std::thread > threads;
+    for( size_t i = 0; i < threadsCount; ++i )
+        threads.push_back( std::thread( [messagesCount] {
+            for( size_t j = 0; j < messagesCount; ++j )
+                put_log( LOG_WARN, "burst %zu", j );
+        } ));
+    for( std::thread& thread : threads )
+        thread.join();
+
+    const size_t written = countLines( capture.getErrors(), " burst " );
+    const size_t dropped = get_dropped_log_count() - droppedBefore;
+    BOOST_CHECK_EQUAL( written + dropped, threadsCount * messagesCount );
+}
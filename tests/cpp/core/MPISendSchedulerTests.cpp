@@ -0,0 +1,183 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+#define BOOST_TEST_MODULE MPISendSchedulerTests
+#include <boost/test/unit_test.hpp>
+namespace ut = boost::unit_test;
+
+#include "MPISendScheduler.h"
+
+#include <deflect/Frame.h>
+
+namespace
+{
+const QString STREAM1( "stream1" );
+const QString STREAM2( "stream2" );
+const int FRAME_SIZE = 1000;
+
+deflect::FramePtr makeFrame( const QString& uri, const int size = FRAME_SIZE )
+{
+    deflect::FramePtr frame( new deflect::Frame );
+    frame->uri = uri;
+    deflect::Segment segment;
+    segment.imageData = QByteArray( size, 0 );
+    frame->segments.push_back( segment );
+    return frame;
+}
+}
+
+BOOST_AUTO_TEST_CASE( testEmptyScheduler )
+{
+    MPISendScheduler scheduler;
+    MPISendScheduler::Message message;
+
+    BOOST_CHECK_EQUAL( scheduler.getQueueSize(), 0 );
+    BOOST_CHECK( !scheduler.pop( message ));
+}
+
+BOOST_AUTO_TEST_CASE( testControlMessagesAreSentFirstInOrder )
+{
+    MPISendScheduler scheduler;
+    scheduler.pushFrame( makeFrame( STREAM1 ));
+    scheduler.pushControl( MPI_MESSAGE_TYPE_DISPLAYGROUP, "group" );
+    scheduler.pushControl( MPI_MESSAGE_TYPE_OPTIONS, "options" );
+    BOOST_CHECK_EQUAL( scheduler.getQueueSize(), 3 );
+
+    MPISendScheduler::Message message;
+    BOOST_REQUIRE( scheduler.pop( message ));
+    BOOST_CHECK_EQUAL( message.type, MPI_MESSAGE_TYPE_DISPLAYGROUP );
+    BOOST_CHECK_EQUAL( message.data, "group" );
+    BOOST_CHECK( !message.frame );
+
+    BOOST_REQUIRE( scheduler.pop( message ));
+    BOOST_CHECK_EQUAL( message.type, MPI_MESSAGE_TYPE_OPTIONS );
+    BOOST_CHECK_EQUAL( message.data, "options" );
+
+    BOOST_REQUIRE( scheduler.pop( message ));
+    BOOST_CHECK_EQUAL( message.type, MPI_MESSAGE_TYPE_PIXELSTREAM );
+    BOOST_REQUIRE( message.frame );
+    BOOST_CHECK_EQUAL( message.frame->uri.toStdString(),
+                       STREAM1.toStdString( ));
+
+    BOOST_CHECK( !scheduler.pop( message ));
+}
+
+BOOST_AUTO_TEST_CASE( testNewFrameSupersedesPendingFrame )
+{
+    MPISendScheduler scheduler;
+    scheduler.pushFrame( makeFrame( STREAM1 ));
+    deflect::FramePtr latestFrame = makeFrame( STREAM1 );
+    scheduler.pushFrame( latestFrame );
+    BOOST_CHECK_EQUAL( scheduler.getQueueSize(), 1 );
+
+    MPISendScheduler::Message message;
+    BOOST_REQUIRE( scheduler.pop( message ));
+    BOOST_CHECK( message.frame == latestFrame );
+    BOOST_CHECK( !scheduler.pop( message ));
+
+    const MPISendScheduler::Statistics stats =
+        scheduler.getStatistics( MPISendScheduler::MESSAGE_CLASS_PIXELSTREAM );
+    BOOST_CHECK_EQUAL( stats.count, 1 );
+    BOOST_CHECK_EQUAL( stats.superseded, 1 );
+}
+
+BOOST_AUTO_TEST_CASE( testStreamsShareBandwidthAccordingToWeights )
+{
+    MPISendScheduler scheduler;
+    std::map< QString, double > weights;
+    weights[STREAM1] = 0.75;
+    weights[STREAM2] = 0.25;
+    scheduler.setStreamWeights( weights );
+
+    int stream1Count = 0;
+    int stream2Count = 0;
+    MPISendScheduler::Message message;
+    for( int i = 0; i < 100; ++i )
+    {
+        // Both streams always have a frame ready to be sent
+        scheduler.pushFrame( makeFrame( STREAM1 ));
+        scheduler.pushFrame( makeFrame( STREAM2 ));
+        BOOST_REQUIRE( scheduler.pop( message ));
+        if( message.frame->uri == STREAM1 )
+            ++stream1Count;
+        else
+            ++stream2Count;
+    }
+    BOOST_CHECK_EQUAL( stream1Count + stream2Count, 100 );
+    BOOST_CHECK_CLOSE( double( stream1Count ), 75.0, 5.0 );
+    BOOST_CHECK_CLOSE( double( stream2Count ), 25.0, 15.0 );
+}
+
+BOOST_AUTO_TEST_CASE( testLargeFramesDoNotStarveSmallStreams )
+{
+    MPISendScheduler scheduler;
+
+    int smallStreamCount = 0;
+    MPISendScheduler::Message message;
+    for( int i = 0; i < 20; ++i )
+    {
+        scheduler.pushFrame( makeFrame( STREAM1, 10 * FRAME_SIZE ));
+        scheduler.pushFrame( makeFrame( STREAM2, FRAME_SIZE ));
+        BOOST_REQUIRE( scheduler.pop( message ));
+        if( message.frame->uri == STREAM2 )
+            ++smallStreamCount;
+    }
+    // Equal weights share bytes, not messages
+    BOOST_CHECK_GT( smallStreamCount, 15 );
+    BOOST_CHECK_LT( smallStreamCount, 20 );
+}
+
+BOOST_AUTO_TEST_CASE( testResetStatistics )
+{
+    MPISendScheduler scheduler;
+    scheduler.pushControl( MPI_MESSAGE_TYPE_MARKERS, "markers" );
+
+    MPISendScheduler::Message message;
+    BOOST_REQUIRE( scheduler.pop( message ));
+
+    MPISendScheduler::Statistics stats =
+        scheduler.getStatistics( MPISendScheduler::MESSAGE_CLASS_CONTROL );
+    BOOST_CHECK_EQUAL( stats.count, 1 );
+    BOOST_CHECK_GE( stats.maxLatencyMs, stats.meanLatencyMs );
+
+    scheduler.resetStatistics();
+    stats = scheduler.getStatistics( MPISendScheduler::MESSAGE_CLASS_CONTROL );
+    BOOST_CHECK_EQUAL( stats.count, 0 );
+    BOOST_CHECK_EQUAL( stats.maxLatencyMs, 0.0 );
+}
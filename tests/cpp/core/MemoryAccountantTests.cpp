@@ -0,0 +1,142 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+#define BOOST_TEST_MODULE MemoryAccountantTests
+#include <boost/test/unit_test.hpp>
+namespace ut = boost::unit_test;
+
+#include "MemoryAccountant.h"
+
+namespace
+{
+const size_t MEMORY_SIZE = 1000;
+const QString WINDOW1( "window1" );
+const QString WINDOW2( "window2" );
+const QString TEXTURE_TYPE( "Texture" );
+const QString MOVIE_TYPE( "Movie" );
+
+class MockClient : public MemoryAccountant::Client
+{
+public:
+    MockClient() : usage( MEMORY_SIZE ), releaseCount( 0 ) {}
+
+    size_t getMemoryUsage() const override { return usage; }
+
+    void releaseMemory() override
+    {
+        usage = 0;
+        ++releaseCount;
+    }
+
+    size_t usage;
+    size_t releaseCount;
+};
+}
+
+BOOST_AUTO_TEST_CASE( testUsageIsReportedPerWindowAndType )
+{
+    MemoryAccountant accountant;
+    MockClient client1, client2, client3;
+    accountant.add( client1, WINDOW1, TEXTURE_TYPE );
+    accountant.add( client2, WINDOW1, MOVIE_TYPE );
+    accountant.add( client3, WINDOW2, TEXTURE_TYPE );
+
+    BOOST_CHECK_EQUAL( accountant.update(), 0 );
+    BOOST_CHECK_EQUAL( accountant.getUsage(), 3 * MEMORY_SIZE );
+
+    std::map< QString, size_t > windows = accountant.getUsagePerWindow();
+    BOOST_CHECK_EQUAL( windows[WINDOW1], 2 * MEMORY_SIZE );
+    BOOST_CHECK_EQUAL( windows[WINDOW2], MEMORY_SIZE );
+
+    std::map< QString, size_t > types = accountant.getUsagePerType();
+    BOOST_CHECK_EQUAL( types[TEXTURE_TYPE], 2 * MEMORY_SIZE );
+    BOOST_CHECK_EQUAL( types[MOVIE_TYPE], MEMORY_SIZE );
+
+    accountant.remove( client2 );
+    accountant.update();
+    BOOST_CHECK_EQUAL( accountant.getUsage(), 2 * MEMORY_SIZE );
+    BOOST_CHECK_EQUAL( accountant.getUsagePerType().count( MOVIE_TYPE ), 0 );
+}
+
+BOOST_AUTO_TEST_CASE( testVisibleContentsAreNotEvicted )
+{
+    MemoryAccountant accountant;
+    accountant.setBudget( MEMORY_SIZE );
+    MockClient client1, client2;
+    accountant.add( client1, WINDOW1, TEXTURE_TYPE );
+    accountant.add( client2, WINDOW2, TEXTURE_TYPE );
+
+    accountant.setVisible( client1, true );
+    accountant.setVisible( client2, true );
+
+    BOOST_CHECK_EQUAL( accountant.update(), 0 );
+    BOOST_CHECK_EQUAL( accountant.getUsage(), 2 * MEMORY_SIZE );
+    BOOST_CHECK_EQUAL( client1.releaseCount + client2.releaseCount, 0 );
+}
+
+BOOST_AUTO_TEST_CASE( testLeastRecentlyVisibleContentIsEvictedFirst )
+{
+    MemoryAccountant accountant;
+    accountant.setBudget( 3 * MEMORY_SIZE );
+    MockClient client1, client2, client3;
+    accountant.add( client1, WINDOW1, TEXTURE_TYPE );
+    accountant.add( client2, WINDOW1, TEXTURE_TYPE );
+    accountant.add( client3, WINDOW2, TEXTURE_TYPE );
+
+    // client2 was visible more recently than client1
+    accountant.setVisible( client1, true );
+    accountant.setVisible( client2, true );
+    accountant.setVisible( client3, true );
+    accountant.update();
+    accountant.setVisible( client1, false );
+    accountant.update();
+    accountant.setVisible( client2, false );
+    accountant.setBudget( 2 * MEMORY_SIZE );
+
+    BOOST_CHECK_EQUAL( accountant.update(), 1 );
+    BOOST_CHECK_EQUAL( client1.releaseCount, 1 );
+    BOOST_CHECK_EQUAL( client2.releaseCount, 0 );
+    BOOST_CHECK_EQUAL( client3.releaseCount, 0 );
+    BOOST_CHECK_EQUAL( accountant.getUsage(), 2 * MEMORY_SIZE );
+    BOOST_CHECK_EQUAL( accountant.getEvictionCount(), 1 );
+
+    // Within budget, nothing else is evicted
+    BOOST_CHECK_EQUAL( accountant.update(), 0 );
+    BOOST_CHECK_EQUAL( client2.releaseCount, 0 );
+}
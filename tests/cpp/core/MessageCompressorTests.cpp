@@ -0,0 +1,168 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#define BOOST_TEST_MODULE MessageCompressorTests
+#include <boost/test/unit_test.hpp>
+namespace ut = boost::unit_test;
+
+#include "MessageCompressor.h"
+#include "SerializeBuffer.h"
+
+#include <cstdlib>
+#include <stdexcept>
+
+namespace
+{
+const size_t THRESHOLD = 1024;
+
+std::string makeCompressibleData( const size_t size )
+{
+    std::string data;
+    while( data.size() < size )
+        data += "/nfs4/bbp.epfl.ch/visualization/DisplayWall/media/image.png";
+    data.resize( size );
+    return data;
+}
+
+std::string makeRandomData( const size_t size )
+{
+    std::string data( size, 0 );
+    std::srand( 0 );
+    for( size_t i = 0; i < size; ++i )
+        data[i] = std::rand() % 256;
+    return data;
+}
+
+MPIHeader makeHeader( const std::string& data, const MPICompression algorithm,
+                      const size_t uncompressedSize )
+{
+    MPIHeader header;
+    header.type = MPI_MESSAGE_TYPE_DISPLAYGROUP;
+    header.size = data.size();
+    header.compression = algorithm;
+    header.uncompressedSize = uncompressedSize;
+    return header;
+}
+}
+
+BOOST_AUTO_TEST_CASE( testSmallMessagesAreNotCompressed )
+{
+    MessageCompressor compressor;
+    compressor.setThreshold( THRESHOLD );
+
+    const std::string original = makeCompressibleData( THRESHOLD - 1 );
+    std::string data = original;
+    BOOST_CHECK_EQUAL( compressor.compress( data ), MPI_COMPRESSION_NONE );
+    BOOST_CHECK( data == original );
+}
+
+BOOST_AUTO_TEST_CASE( testCompressionRoundTrip )
+{
+    MessageCompressor compressor;
+    compressor.setThreshold( THRESHOLD );
+
+    const std::string original = makeCompressibleData( 100 * THRESHOLD );
+    std::string data = original;
+    const MPICompression algorithm = compressor.compress( data );
+    BOOST_CHECK_EQUAL( algorithm, MessageCompressor::getDefaultAlgorithm( ));
+    BOOST_CHECK_LT( data.size(), original.size( ));
+
+    MessageCompressor decompressor;
+    SerializeBuffer buffer;
+    decompressor.decompress( makeHeader( data, algorithm, original.size( )),
+                             data.data(), buffer );
+    BOOST_REQUIRE_EQUAL( buffer.size(), original.size( ));
+    BOOST_CHECK( std::string( buffer.data(), buffer.size( )) == original );
+}
+
+BOOST_AUTO_TEST_CASE( testIncompressibleMessagesAreNotCompressed )
+{
+    MessageCompressor compressor;
+    compressor.setThreshold( THRESHOLD );
+
+    const std::string original = makeRandomData( 10 * THRESHOLD );
+    std::string data = original;
+    BOOST_CHECK_EQUAL( compressor.compress( data ), MPI_COMPRESSION_NONE );
+    BOOST_CHECK( data == original );
+}
+
+BOOST_AUTO_TEST_CASE( testZeroThresholdDisablesCompression )
+{
+    MessageCompressor compressor;
+    compressor.setThreshold( 0 );
+
+    std::string data = makeCompressibleData( 100 * THRESHOLD );
+    BOOST_CHECK_EQUAL( compressor.compress( data ), MPI_COMPRESSION_NONE );
+}
+
+BOOST_AUTO_TEST_CASE( testInvalidDataThrows )
+{
+    MessageCompressor compressor;
+    SerializeBuffer buffer;
+
+    const std::string data = makeRandomData( THRESHOLD );
+    const MPIHeader header =
+        makeHeader( data, MessageCompressor::getDefaultAlgorithm(),
+                    10 * THRESHOLD );
+    BOOST_CHECK_THROW( compressor.decompress( header, data.data(), buffer ),
+                       std::runtime_error );
+}
+
+BOOST_AUTO_TEST_CASE( testStatistics )
+{
+    MessageCompressor compressor;
+    compressor.setThreshold( THRESHOLD );
+
+    std::string small = makeCompressibleData( THRESHOLD / 2 );
+    std::string large = makeCompressibleData( 100 * THRESHOLD );
+    const size_t totalSize = small.size() + large.size();
+    compressor.compress( small );
+    compressor.compress( large );
+
+    MessageCompressor::Statistics stats = compressor.getStatistics();
+    BOOST_CHECK_EQUAL( stats.count, 2 );
+    BOOST_CHECK_EQUAL( stats.compressed, 1 );
+    BOOST_CHECK_EQUAL( stats.uncompressedBytes, totalSize );
+    BOOST_CHECK_EQUAL( stats.compressedBytes, small.size() + large.size( ));
+    BOOST_CHECK_GT( stats.getRatio(), 1.0 );
+
+    compressor.resetStatistics();
+    stats = compressor.getStatistics();
+    BOOST_CHECK_EQUAL( stats.count, 0 );
+    BOOST_CHECK_EQUAL( stats.getRatio(), 1.0 );
+}
@@ -0,0 +1,88 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+
+#define BOOST_TEST_MODULE OffscreenRenderingTests
+#include <boost/test/unit_test.hpp>
+namespace ut = boost::unit_test;
+
+#include "RenderContext.h"
+#include "configuration/WallConfiguration.h"
+
+#include "GlobalQtApp.h"
+BOOST_GLOBAL_FIXTURE( GlobalQtApp );
+
+#include <QImage>
+#include <QTemporaryDir>
+
+namespace
+{
+// The first wall process of configuration.xml has one screen, at (0,0)
+const int WALL_PROCESS_INDEX = 1;
+const QString FIRST_FRAME_FILENAME( "/frame_000001_screen_0_0.png" );
+}
+
+// Smoke test of the --offscreen --dump-frames mode of the wall processes
+BOOST_AUTO_TEST_CASE( testOffscreenFrameIsDumped )
+{
+    if( !hasGLXDisplay( ))
+        return;
+
+    const WallConfiguration config( CONFIG_TEST_FILENAME, WALL_PROCESS_INDEX );
+    RenderContext context( config, true );
+
+    QTemporaryDir dumpFolder;
+    BOOST_REQUIRE( dumpFolder.isValid( ));
+    context.setFrameDumpFolder( dumpFolder.path( ));
+    context.setBackgroundColor( Qt::red );
+
+    // Same steps as WallApplication::renderFrame()
+    context.updateGLWindows();
+    context.waitForGPU();
+    context.swapBuffers();
+
+    const QImage frame( dumpFolder.path() + FIRST_FRAME_FILENAME );
+    BOOST_REQUIRE( !frame.isNull( ));
+    BOOST_CHECK( frame.size() == config.getScreenRect( QPoint( 0, 0 )).size( ));
+
+    const QRgb center = frame.pixel( frame.width() / 2, frame.height() / 2 );
+    BOOST_CHECK_EQUAL( qRed( center ), 255 );
+    BOOST_CHECK_EQUAL( qGreen( center ), 0 );
+    BOOST_CHECK_EQUAL( qBlue( center ), 0 );
+}
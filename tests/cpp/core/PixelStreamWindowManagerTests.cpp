@@ -47,6 +47,7 @@ namespace ut = boost::unit_test;
 #include "ContentWindow.h"
 #include "DisplayGroup.h"
 #include "Options.h"
+#include "PixelStreamContent.h"
 #include "PixelStreamWindowManager.h"
 #include "PixelStreamInteractionDelegate.h"
 
@@ -86,6 +87,21 @@ public:
     bool success_;
 };
 
+class ViewSizeEventReceiver : public deflect::EventReceiver
+{
+public:
+    ViewSizeEventReceiver() : eventsCount_( 0 ) {}
+    virtual void processEvent( deflect::Event event )
+    {
+        if( event.type != deflect::Event::EVT_VIEW_SIZE_CHANGED )
+            return;
+        viewSize_ = QSize( event.dx, event.dy );
+        ++eventsCount_;
+    }
+    QSize viewSize_;
+    int eventsCount_;
+};
+
 BOOST_AUTO_TEST_CASE( testNoStreamerWindowCreation )
 {
     DisplayGroupPtr displayGroup( new DisplayGroup( wallSize ));
@@ -251,3 +267,65 @@ BOOST_AUTO_TEST_CASE( testSizeHints )
     BOOST_CHECK_EQUAL( content->getMaxDimensions(), maxSize );
     BOOST_CHECK_EQUAL( content->getPreferredDimensions(), preferredSize );
 }
+
+BOOST_AUTO_TEST_CASE( testPixelFormat )
+{
+    DisplayGroupPtr displayGroup( new DisplayGroup( wallSize ));
+    PixelStreamWindowManager windowManager( *displayGroup );
+
+    windowManager.openPixelStreamWindow( CONTENT_URI );
+    ContentWindowPtr window = windowManager.getContentWindow( CONTENT_URI );
+    BOOST_REQUIRE( window );
+    const PixelStreamContent* content =
+            dynamic_cast<const PixelStreamContent*>( window->getContent().get( ));
+    BOOST_REQUIRE( content );
+    BOOST_CHECK_EQUAL( content->getPixelFormat(), deflect::RGBA );
+    windowManager.closePixelStreamWindow( CONTENT_URI );
+
+    windowManager.openWindow( CONTENT_URI, testWindowPos, testWindowSize,
+                              deflect::BGRA );
+    window = windowManager.getContentWindow( CONTENT_URI );
+    BOOST_REQUIRE( window );
+    content = dynamic_cast<const PixelStreamContent*>( window->getContent().get( ));
+    BOOST_REQUIRE( content );
+    BOOST_CHECK_EQUAL( content->getPixelFormat(), deflect::BGRA );
+}
+
+BOOST_AUTO_TEST_CASE( testViewSizeNegotiation )
+{
+    DisplayGroupPtr displayGroup( new DisplayGroup( wallSize ));
+    PixelStreamWindowManager windowManager( *displayGroup );
+    windowManager.openWindow( CONTENT_URI, testWindowPos, testWindowSize );
+    ContentWindowPtr window = windowManager.getContentWindow( CONTENT_URI );
+    BOOST_REQUIRE( window );
+
+    ViewSizeEventReceiver receiver;
+    windowManager.registerEventReceiver( CONTENT_URI, false, &receiver );
+
+    // The receiver is informed of the current window size upon registration
+    BOOST_CHECK_EQUAL( receiver.eventsCount_, 1 );
+    BOOST_CHECK_EQUAL( receiver.viewSize_, testWindowSize );
+    BOOST_CHECK_EQUAL( windowManager.getViewSize( CONTENT_URI ),
+                       testWindowSize );
+
+    // Growing the window immediately requests a larger stream
+    window->setCoordinates( QRectF( QPointF(), testWindowSize * 2 ));
+    BOOST_CHECK_EQUAL( receiver.eventsCount_, 2 );
+    BOOST_CHECK_EQUAL( receiver.viewSize_, testWindowSize * 2 );
+
+    // Shrinking it a little keeps the current stream size (hysteresis)
+    window->setCoordinates( QRectF( QPointF(), testWindowSize * 1.8 ));
+    BOOST_CHECK_EQUAL( receiver.eventsCount_, 2 );
+    BOOST_CHECK_EQUAL( receiver.viewSize_, testWindowSize * 2 );
+
+    // Shrinking it significantly requests a smaller stream
+    window->setCoordinates( QRectF( QPointF(), testWindowSize ));
+    BOOST_CHECK_EQUAL( receiver.eventsCount_, 3 );
+    BOOST_CHECK_EQUAL( receiver.viewSize_, testWindowSize );
+
+    // A change of aspect ratio is always forwarded
+    const QSize wideSize( testWindowSize.width(), testWindowSize.height() / 2 );
+    window->setCoordinates( QRectF( QPointF(), wideSize ));
+    BOOST_CHECK_EQUAL( receiver.eventsCount_, 4 );
+    BOOST_CHECK_EQUAL( receiver.viewSize_, wideSize );
+}
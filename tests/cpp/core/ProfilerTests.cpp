@@ -0,0 +1,208 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+#define BOOST_TEST_MODULE ProfilerTests
+#include <boost/test/unit_test.hpp>
+namespace ut = boost::unit_test;
+
+#include "Profiler.h"
+
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <atomic>
+#include <set>
+#include <thread>
+
+namespace
+{
+size_t countEvents( const std::string& trace, const std::string& name )
+{
+    const std::string pattern = "\"name\":\"" + name + "\"";
+    size_t count = 0;
+    for( size_t pos = trace.find( pattern ); pos != std::string::npos;
+         pos = trace.find( pattern, pos + 1 ))
+    {
+        ++count;
+    }
+    return count;
+}
+
+struct EnabledProfiler
+{
+    EnabledProfiler() { Profiler::setEnabled( true ); }
+    ~EnabledProfiler() { Profiler::setEnabled( false ); }
+};
+}
+
+BOOST_FIXTURE_TEST_CASE( testScopeRecordsEvent, EnabledProfiler )
+{
+    {
+        PROFILE_SCOPE( "test", "recordedScope" );
+    }
+    const std::string trace = Profiler::getTraceEvents( 3, "wall 3" );
+    BOOST_CHECK_EQUAL( countEvents( trace, "recordedScope" ), 1 );
+    BOOST_CHECK( trace.find( "\"cat\":\"test\"" ) != std::string::npos );
+    BOOST_CHECK( trace.find( "\"pid\":3" ) != std::string::npos );
+    BOOST_CHECK( trace.find( "\"name\":\"wall 3\"" ) != std::string::npos );
+}
+
+BOOST_AUTO_TEST_CASE( testProfilerIsDisabledByDefault )
+{
+    BOOST_CHECK( !Profiler::isEnabled( ));
+    {
+        PROFILE_SCOPE( "test", "disabledScope" );
+    }
+
+    const std::string trace = Profiler::getTraceEvents( 0, "master" );
+    BOOST_CHECK_EQUAL( countEvents( trace, "disabledScope" ), 0 );
+}
+
+BOOST_FIXTURE_TEST_CASE( testRingKeepsMostRecentEvents, EnabledProfiler )
+{
+    std::thread thread( []
+    {
+        const int64_t now = Profiler::now();
+        for( size_t i = 0; i < 10; ++i )
+            Profiler::record( "test", "oldEvent", now, 1 );
+        for( size_t i = 0; i < Profiler::EVENTS_PER_THREAD; ++i )
+            Profiler::record( "test", "recentEvent", now, 1 );
+    });
+    thread.join();
+
+    const std::string trace = Profiler::getTraceEvents( 0, "master" );
+    BOOST_CHECK_EQUAL( countEvents( trace, "oldEvent" ), 0 );
+    BOOST_CHECK_EQUAL( countEvents( trace, "recentEvent" ),
+                       Profiler::EVENTS_PER_THREAD );
+}
+
+BOOST_FIXTURE_TEST_CASE( testReadWhileRecordingNeverTearsEvents,
+                         EnabledProfiler )
+{
+    // Each event has its duration equal to its start, a torn read would mix
+    // the fields of two events.
+    std::atomic< bool > done( false );
+    std::thread thread( [&done]
+    {
+        for( int64_t i = 0; i < 20 * int64_t(Profiler::EVENTS_PER_THREAD); ++i )
+            Profiler::record( "test", "racingEvent", i, i );
+        done = true;
+    });
+
+    size_t checkedEvents = 0;
+    bool finished = false;
+    do
+    {
+        finished = done;
+        const std::string trace = Profiler::getTraceEvents( 0, "master" );
+        const QJsonDocument document = QJsonDocument::fromJson(
+                        QByteArray::fromStdString( "[" + trace + "]" ));
+        BOOST_REQUIRE( document.isArray( ));
+        for( const QJsonValue& value : document.array( ))
+        {
+            const QJsonObject event = value.toObject();
+            if( event["name"].toString() != "racingEvent" )
+                continue;
+            BOOST_REQUIRE_EQUAL( event["ts"].toDouble(),
+                                 event["dur"].toDouble( ));
+            ++checkedEvents;
+        }
+    } while( !finished );
+    thread.join();
+    BOOST_CHECK_GT( checkedEvents, 0 );
+}
+
+BOOST_FIXTURE_TEST_CASE( testThreadsHaveSeparateTimelines, EnabledProfiler )
+{
+    Profiler::setThreadName( "main" );
+    {
+        PROFILE_SCOPE( "test", "mainThreadScope" );
+        std::thread thread( []
+        {
+            Profiler::setThreadName( "worker" );
+            PROFILE_SCOPE( "test", "workerThreadScope" );
+        });
+        thread.join();
+    }
+
+    const std::string trace = Profiler::getTraceEvents( 0, "master" );
+    BOOST_CHECK_EQUAL( countEvents( trace, "mainThreadScope" ), 1 );
+    BOOST_CHECK_EQUAL( countEvents( trace, "workerThreadScope" ), 1 );
+    BOOST_CHECK_EQUAL( countEvents( trace, "main" ), 1 );
+    BOOST_CHECK_EQUAL( countEvents( trace, "worker" ), 1 );
+}
+
+BOOST_FIXTURE_TEST_CASE( testWriteChromeTraceMergesProcesses, EnabledProfiler )
+{
+    {
+        PROFILE_SCOPE( "test", "mergedScope" );
+    }
+    std::vector< std::string > traceEvents;
+    traceEvents.push_back( Profiler::getTraceEvents( 0, "master" ));
+    traceEvents.push_back( Profiler::getTraceEvents( 1, "wall 1" ));
+
+    const QString filename = QDir::tempPath() + "/dcProfilerTests.json";
+    BOOST_REQUIRE( Profiler::writeChromeTrace( filename, traceEvents ));
+
+    QFile file( filename );
+    BOOST_REQUIRE( file.open( QIODevice::ReadOnly ));
+    const QJsonDocument document = QJsonDocument::fromJson( file.readAll( ));
+    file.remove();
+    BOOST_REQUIRE( document.isObject( ));
+
+    const QJsonArray events = document.object()["traceEvents"].toArray();
+    std::set< int > pids;
+    size_t mergedScopes = 0;
+    for( const QJsonValue& value : events )
+    {
+        const QJsonObject event = value.toObject();
+        pids.insert( event["pid"].toInt( ));
+        if( event["name"].toString() == "mergedScope" )
+        {
+            BOOST_CHECK_EQUAL( event["ph"].toString().toStdString(), "X" );
+            BOOST_CHECK_GE( event["dur"].toDouble(), 0.0 );
+            ++mergedScopes;
+        }
+    }
+    BOOST_CHECK_EQUAL( pids.size(), 2 );
+    BOOST_CHECK_EQUAL( mergedScopes, 2 );
+}
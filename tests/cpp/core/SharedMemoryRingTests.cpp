@@ -0,0 +1,170 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+#define BOOST_TEST_MODULE SharedMemoryRingTests
+#include <boost/test/unit_test.hpp>
+namespace ut = boost::unit_test;
+
+#include "SharedMemoryRing.h"
+
+#include <unistd.h>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+const size_t CAPACITY = 4096;
+
+std::string getUniqueName( const std::string& test )
+{
+    return "/dcSharedMemoryRingTests-" + test + "-" +
+           std::to_string( (long long)getpid( ));
+}
+
+MPIHeader makeHeader( const std::string& data )
+{
+    MPIHeader header;
+    header.type = MPI_MESSAGE_TYPE_DISPLAYGROUP;
+    header.size = data.size();
+    return header;
+}
+
+std::string makeMessage( const int index )
+{
+    // Sizes vary to exercise wrapping at the end of the ring
+    return std::string( 100 + ( index * 37 ) % 1500, char( 'a' + index % 26 ));
+}
+}
+
+BOOST_AUTO_TEST_CASE( testReaderReceivesMessagesInOrder )
+{
+    const std::string name = getUniqueName( "order" );
+    SharedMemoryRing writer( name, CAPACITY, 1 );
+    SharedMemoryRing reader( name, 0 );
+    writer.unlink();
+
+    writer.write( makeHeader( "first" ), "first" );
+    writer.write( makeHeader( "" ), "" );
+    writer.write( makeHeader( "third" ), "third" );
+
+    MPIHeader header;
+    const char* data = reader.read( header );
+    BOOST_CHECK_EQUAL( std::string( data, header.size ), "first" );
+    BOOST_CHECK_EQUAL( header.type, MPI_MESSAGE_TYPE_DISPLAYGROUP );
+
+    reader.read( header );
+    BOOST_CHECK_EQUAL( header.size, 0 );
+
+    data = reader.read( header );
+    BOOST_CHECK_EQUAL( std::string( data, header.size ), "third" );
+}
+
+BOOST_AUTO_TEST_CASE( testAllReadersReceiveAllMessages )
+{
+    const std::string name = getUniqueName( "readers" );
+    const unsigned int readerCount = 3;
+    const int messageCount = 500;
+
+    SharedMemoryRing writer( name, CAPACITY, readerCount );
+    std::vector< std::unique_ptr< SharedMemoryRing >> readers;
+    for( unsigned int i = 0; i < readerCount; ++i )
+        readers.emplace_back( new SharedMemoryRing( name, i ));
+    writer.unlink();
+
+    std::vector< int > errors( readerCount, 0 );
+    std::vector< std::thread > threads;
+    for( unsigned int i = 0; i < readerCount; ++i )
+    {
+        threads.emplace_back( [&, i]()
+        {
+            for( int j = 0; j < messageCount; ++j )
+            {
+                MPIHeader header;
+                const char* data = readers[i]->read( header );
+                if( std::string( data, header.size ) != makeMessage( j ))
+                    ++errors[i];
+            }
+        });
+    }
+
+    for( int j = 0; j < messageCount; ++j )
+    {
+        const std::string message = makeMessage( j );
+        writer.write( makeHeader( message ), message.data( ));
+    }
+    for( std::thread& thread : threads )
+        thread.join();
+
+    for( unsigned int i = 0; i < readerCount; ++i )
+        BOOST_CHECK_EQUAL( errors[i], 0 );
+}
+
+BOOST_AUTO_TEST_CASE( testMessagesLargerThanTheRingAreReassembled )
+{
+    const std::string name = getUniqueName( "large" );
+    SharedMemoryRing writer( name, CAPACITY, 1 );
+    SharedMemoryRing reader( name, 0 );
+    writer.unlink();
+
+    std::string message( 5 * CAPACITY, 0 );
+    for( size_t i = 0; i < message.size(); ++i )
+        message[i] = char( i % 251 );
+
+    std::string received;
+    std::thread thread( [&]()
+    {
+        MPIHeader header;
+        const char* data = reader.read( header );
+        received.assign( data, header.size );
+    });
+    writer.write( makeHeader( message ), message.data( ));
+    thread.join();
+
+    BOOST_CHECK( received == message );
+}
+
+BOOST_AUTO_TEST_CASE( testOpeningMissingRingThrows )
+{
+    BOOST_CHECK_THROW( SharedMemoryRing( getUniqueName( "missing" ), 0 ),
+                       std::runtime_error );
+}
@@ -159,3 +159,25 @@ BOOST_AUTO_TEST_CASE( testUpdateAndSyncAlwaysWithCallback )
     BOOST_REQUIRE( syncObject.sync( boost::bind( &alwaysSync, _1 )));
     BOOST_CHECK_EQUAL( *result.getResult(), *ptr );
 }
+
+BOOST_AUTO_TEST_CASE( testPendingUntilSynchronized )
+{
+    typedef boost::shared_ptr< int > IntPtr;
+
+    SwapSyncObject< IntPtr > syncObject( IntPtr( new int( 5 )));
+    BOOST_CHECK( !syncObject.isPending( ));
+
+    syncObject.update( IntPtr( new int( 42 )));
+    BOOST_CHECK( syncObject.isPending( ));
+
+    BOOST_CHECK( syncObject.sync( boost::bind( &oddNumberSync, _1 )));
+    BOOST_CHECK( !syncObject.isPending( ));
+
+    syncObject.update( IntPtr( new int( 12 )));
+    BOOST_CHECK( !syncObject.sync( boost::bind( &oddNumberSync, _1 )));
+    BOOST_CHECK( syncObject.isPending( ));
+
+    BOOST_CHECK( syncObject.sync( boost::bind( &alwaysSync, _1 )));
+    BOOST_CHECK( !syncObject.isPending( ));
+    BOOST_CHECK_EQUAL( *syncObject.get(), 12 );
+}
@@ -0,0 +1,152 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+#define BOOST_TEST_MODULE UploadSchedulerTests
+#include <boost/test/unit_test.hpp>
+namespace ut = boost::unit_test;
+
+#include "UploadScheduler.h"
+
+#include <boost/bind.hpp>
+
+#include <thread>
+
+namespace
+{
+const size_t UPLOAD_SIZE = 1000;
+
+void upload( std::vector< int >& uploads, const int id )
+{
+    uploads.push_back( id );
+}
+
+void slowUpload( std::vector< int >& uploads, const int id )
+{
+    std::this_thread::sleep_for( std::chrono::milliseconds( 5 ));
+    uploads.push_back( id );
+}
+}
+
+BOOST_AUTO_TEST_CASE( testEmptyScheduler )
+{
+    UploadScheduler scheduler;
+
+    BOOST_CHECK_EQUAL( scheduler.processUploads(), 0 );
+    BOOST_CHECK_EQUAL( scheduler.getBacklogSize(), 0 );
+    BOOST_CHECK_EQUAL( scheduler.getBacklogBytes(), 0 );
+}
+
+BOOST_AUTO_TEST_CASE( testUploadsAreExecutedByPriority )
+{
+    UploadScheduler scheduler;
+    std::vector< int > uploads;
+
+    scheduler.schedule( 1.0, UPLOAD_SIZE, boost::bind( &upload,
+                                                       boost::ref( uploads ), 1 ));
+    scheduler.schedule( 3.0, UPLOAD_SIZE, boost::bind( &upload,
+                                                       boost::ref( uploads ), 3 ));
+    scheduler.schedule( 2.0, UPLOAD_SIZE, boost::bind( &upload,
+                                                       boost::ref( uploads ), 2 ));
+
+    BOOST_CHECK_EQUAL( scheduler.processUploads(), 3 );
+    BOOST_REQUIRE_EQUAL( uploads.size(), 3 );
+    BOOST_CHECK_EQUAL( uploads[0], 3 );
+    BOOST_CHECK_EQUAL( uploads[1], 2 );
+    BOOST_CHECK_EQUAL( uploads[2], 1 );
+    BOOST_CHECK_EQUAL( scheduler.getBacklogSize(), 0 );
+
+    // Scheduled uploads are only valid for one frame
+    BOOST_CHECK_EQUAL( scheduler.processUploads(), 0 );
+    BOOST_CHECK_EQUAL( uploads.size(), 3 );
+}
+
+BOOST_AUTO_TEST_CASE( testSizeBudgetIsRespected )
+{
+    UploadScheduler scheduler;
+    scheduler.setBudget( 2 * UPLOAD_SIZE, 1000.0 );
+    std::vector< int > uploads;
+
+    for( int i = 0; i < 5; ++i )
+        scheduler.schedule( i, UPLOAD_SIZE, boost::bind( &upload,
+                                                         boost::ref( uploads ),
+                                                         i ));
+
+    BOOST_CHECK_EQUAL( scheduler.processUploads(), 2 );
+    BOOST_REQUIRE_EQUAL( uploads.size(), 2 );
+    BOOST_CHECK_EQUAL( uploads[0], 4 );
+    BOOST_CHECK_EQUAL( uploads[1], 3 );
+    BOOST_CHECK_EQUAL( scheduler.getBacklogSize(), 3 );
+    BOOST_CHECK_EQUAL( scheduler.getBacklogBytes(), 3 * UPLOAD_SIZE );
+}
+
+BOOST_AUTO_TEST_CASE( testUploadLargerThanBudgetIsExecuted )
+{
+    UploadScheduler scheduler;
+    scheduler.setBudget( UPLOAD_SIZE, 1000.0 );
+    std::vector< int > uploads;
+
+    scheduler.schedule( 1.0, 10 * UPLOAD_SIZE,
+                        boost::bind( &upload, boost::ref( uploads ), 1 ));
+    scheduler.schedule( 0.0, UPLOAD_SIZE,
+                        boost::bind( &upload, boost::ref( uploads ), 0 ));
+
+    BOOST_CHECK_EQUAL( scheduler.processUploads(), 1 );
+    BOOST_REQUIRE_EQUAL( uploads.size(), 1 );
+    BOOST_CHECK_EQUAL( uploads[0], 1 );
+    BOOST_CHECK_EQUAL( scheduler.getBacklogSize(), 1 );
+}
+
+BOOST_AUTO_TEST_CASE( testTimeBudgetIsRespected )
+{
+    UploadScheduler scheduler;
+    scheduler.setBudget( 100 * UPLOAD_SIZE, 1.0 );
+    std::vector< int > uploads;
+
+    for( int i = 0; i < 3; ++i )
+        scheduler.schedule( i, UPLOAD_SIZE, boost::bind( &slowUpload,
+                                                         boost::ref( uploads ),
+                                                         i ));
+
+    BOOST_CHECK_EQUAL( scheduler.processUploads(), 1 );
+    BOOST_CHECK_EQUAL( scheduler.getBacklogSize(), 2 );
+    BOOST_CHECK_GE( scheduler.getWorstFrameTime(), 5.0 );
+
+    scheduler.resetWorstFrameTime();
+    BOOST_CHECK_EQUAL( scheduler.getWorstFrameTime(), 0.0 );
+}
@@ -0,0 +1,163 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/program_options.hpp>
+
+#include "BinaryCodec.h"
+#include "SerializeBuffer.h"
+#include "ContentWindow.h"
+#include "DisplayGroup.h"
+#include "PixelStreamContent.h"
+
+// Example way to run this program:
+// ./dcBenchmarkCodec --windows 100 --iterations 1000
+//
+//Windows: 100
+//Message size [bytes] boost: ... codec: ...
+//Encode [ns/window] boost: ... codec: ...
+//Decode [ns/window] boost: ... codec: ...
+
+namespace
+{
+typedef boost::posix_time::ptime Time;
+
+Time now()
+{
+    return boost::posix_time::microsec_clock::universal_time();
+}
+
+DisplayGroupPtr makeDisplayGroup(const unsigned int windowsCount)
+{
+    DisplayGroupPtr group(new DisplayGroup(QSizeF(7680, 3240)));
+    for (unsigned int i = 0; i < windowsCount; ++i)
+    {
+        ContentPtr content(new PixelStreamContent(QString("stream%1").arg(i)));
+        content->setDimensions(QSize(1920, 1080));
+        ContentWindowPtr window = boost::make_shared<ContentWindow>(content);
+        window->setCoordinates(QRectF(i % 10 * 700, i / 10 * 300, 640, 360));
+        group->addContentWindow(window);
+    }
+    return group;
+}
+
+double nsPerWindow(const Time& start, const unsigned int iterations,
+                   const unsigned int windowsCount)
+{
+    return (double)(now() - start).total_nanoseconds() / iterations / windowsCount;
+}
+}
+
+/**
+ * Compare the boost binary archives and the BinaryCodec used for sending
+ * DisplayGroups from the master to the walls.
+ */
+int main(int argc, char **argv)
+{
+    namespace po = boost::program_options;
+    po::options_description desc("Allowed options");
+    desc.add_options()
+        ("help", "produce help message")
+        ("windows", po::value<unsigned int>()->default_value(100),
+                 "number of windows in the DisplayGroup")
+        ("iterations", po::value<unsigned int>()->default_value(1000),
+                 "number of times each operation is repeated")
+    ;
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+    if (vm.count("help"))
+    {
+        std::cout << desc;
+        return 0;
+    }
+    const unsigned int windowsCount = std::max(vm["windows"].as<unsigned int>(), 1u);
+    const unsigned int iterations = std::max(vm["iterations"].as<unsigned int>(), 1u);
+
+    const DisplayGroupPtr group = makeDisplayGroup(windowsCount);
+
+    // boost binary archives
+    std::string serialized;
+    Time start = now();
+    for (unsigned int i = 0; i < iterations; ++i)
+        serialized = SerializeBuffer::serialize(group);
+    const double boostEncode = nsPerWindow(start, iterations, windowsCount);
+
+    SerializeBuffer buffer;
+    buffer.setSize(serialized.size());
+    memcpy(buffer.data(), serialized.data(), serialized.size());
+    start = now();
+    for (unsigned int i = 0; i < iterations; ++i)
+    {
+        DisplayGroupPtr decodedGroup;
+        buffer.deserialize(decodedGroup);
+    }
+    const double boostDecode = nsPerWindow(start, iterations, windowsCount);
+
+    // BinaryCodec
+    BinaryEncoder encoder;
+    std::string encoded;
+    start = now();
+    for (unsigned int i = 0; i < iterations; ++i)
+        encoder.encode(group, encoded);
+    const double codecEncode = nsPerWindow(start, iterations, windowsCount);
+
+    BinaryDecoder decoder;
+    start = now();
+    for (unsigned int i = 0; i < iterations; ++i)
+    {
+        DisplayGroupPtr decodedGroup;
+        decoder.decode(encoded.data(), encoded.size(), decodedGroup);
+    }
+    const double codecDecode = nsPerWindow(start, iterations, windowsCount);
+
+    std::cout << "Windows: " << windowsCount << std::endl;
+    std::cout << "Message size [bytes] boost: " << serialized.size()
+              << " codec: " << encoded.size() << std::endl;
+    std::cout << "Encode [ns/window] boost: " << boostEncode
+              << " codec: " << codecEncode << std::endl;
+    std::cout << "Decode [ns/window] boost: " << boostDecode
+              << " codec: " << codecDecode << std::endl;
+
+    return 0;
+}
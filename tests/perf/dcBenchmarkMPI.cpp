@@ -37,17 +37,31 @@
 /* or implied, of The University of Texas at Austin.                 */
 /*********************************************************************/
 
-#include <string>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <functional>
 #include <iostream>
+#include <string>
 
 #include <boost/serialization/vector.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/make_shared.hpp>
 #include <boost/program_options.hpp>
 
+#include <deflect/Frame.h>
+
+#include "BinaryCodec.h"
+#include "BroadcastTransport.h"
+#include "ContentWindow.h"
+#include "DisplayGroup.h"
 #include "MPIChannel.h"
+#include "PixelStreamContent.h"
 #include "SerializeBuffer.h"
+#include "WallToWallChannel.h"
 
 #define MEGABYTE 1000000
+#define KILOBYTE 1000
 #define MICROSEC 1000000
 
 #define RANK0 0
@@ -55,13 +69,41 @@
 // Example ways to run this program:
 // mpirun -n 6 -H localhost ./dcBenchmarkMPI --datasize 60 --packets 100
 //
-//Object size [Mbytes]: 60
-//Time to send 100 objects: 3.445
-//Time per object: 0.03445
-//Throughput [Mbytes/sec]: 1741.66
+//throughput datasize_MB=60 throughput_MBps=1741.66
+//throughput datasize_MB=60 time_per_object_s=0.03445
+//
+// mpirun -n 6 -H localhost ./dcBenchmarkMPI --datasize 60 --packets 100 --transport shm
+//
+// compares the shared memory transport with MPI on a single host.
+//
+// mpirun -n 8 -H localhost ./dcBenchmarkMPI --benchmark all --format json --output results.json
+//
+// runs the whole suite and writes machine-readable results, one record per
+// measurement: {"benchmark": "latency", "parameter": "ranks", "value": 4,
+// "metric": "latency_us", "result": ...}. The csv format has the same columns.
+//
+// Benchmarks:
+// - throughput: large messages from rank 0 to all ranks, as pixel streams
+// - latency: small messages against the number of ranks
+// - framesync: WallToWallChannel calls made by the walls for each frame
+//   (clock, version checks, swap barrier) against the number of ranks
+// - displaygroup: encode, broadcast and decode of a DisplayGroup against the
+//   number of windows
+// - pixelstream: fan-out of pixel stream frames against the number of segments
+// - electleader: movie timestamp synchronization against the number of ranks
 
 namespace
 {
+const char* BENCHMARKS[] = { "throughput", "latency", "framesync",
+                             "displaygroup", "pixelstream", "electleader" };
+const size_t BENCHMARKS_COUNT = sizeof(BENCHMARKS) / sizeof(BENCHMARKS[0]);
+
+// WallToWallChannel::electLeader() encodes the candidates as bits of an int
+const int MAX_ELECTION_RANKS = 31;
+
+// Number of SwapSyncObjects checked by the walls for each frame
+const int SYNC_OBJECTS_PER_FRAME = 5;
+
 class Timer
 {
 public:
@@ -75,15 +117,31 @@ public:
         start();
     }
 
-    float elapsed()
+    double elapsed()
     {
         const boost::posix_time::ptime now = boost::posix_time::microsec_clock::universal_time();
-        return (float)(now - lastTime_).total_milliseconds();
+        return (double)(now - lastTime_).total_milliseconds();
+    }
+
+    double elapsedMicroseconds()
+    {
+        const boost::posix_time::ptime now = boost::posix_time::microsec_clock::universal_time();
+        return (double)(now - lastTime_).total_microseconds();
     }
 private:
     boost::posix_time::ptime lastTime_;
 };
 
+/** One measurement of the suite. */
+struct Result
+{
+    std::string benchmark;
+    std::string parameter;
+    double value;
+    std::string metric;
+    double result;
+};
+typedef std::vector<Result> Results;
 
 struct BenchmarkOptions
 {
@@ -92,6 +150,11 @@ struct BenchmarkOptions
         , getHelp_(true)
         , dataSize_(0)
         , packetsCount_(0)
+        , messageSize_(0)
+        , windowsCount_(0)
+        , segmentsCount_(0)
+        , segmentSize_(0)
+        , transport_(TRANSPORT_MPI)
     {
         initDesc();
         parseCommandLineArguments(argc, argv);
@@ -106,10 +169,27 @@ struct BenchmarkOptions
     {
         desc_.add_options()
             ("help", "produce help message")
-            ("datasize", boost::program_options::value<float>()->default_value(0),
-                     "Size of each data packet [MB]")
-            ("packets", boost::program_options::value<unsigned int>()->default_value(0),
-                     "number of packets to transmitt")
+            ("benchmark", boost::program_options::value<std::string>()->default_value("throughput"),
+                     "Benchmark to run: 'throughput', 'latency', 'framesync', 'displaygroup', "
+                     "'pixelstream', 'electleader' or 'all'")
+            ("datasize", boost::program_options::value<float>()->default_value(10),
+                     "Size of each data packet for the throughput benchmark [MB]")
+            ("packets", boost::program_options::value<unsigned int>()->default_value(100),
+                     "number of packets to transmitt for each measurement")
+            ("messagesize", boost::program_options::value<unsigned int>()->default_value(64),
+                     "Size of each message for the latency benchmark [bytes]")
+            ("windows", boost::program_options::value<unsigned int>()->default_value(1000),
+                     "Maximum number of windows for the displaygroup benchmark")
+            ("segments", boost::program_options::value<unsigned int>()->default_value(64),
+                     "Maximum number of segments for the pixelstream benchmark")
+            ("segmentsize", boost::program_options::value<unsigned int>()->default_value(64),
+                     "Size of each segment for the pixelstream benchmark [KB]")
+            ("transport", boost::program_options::value<std::string>()->default_value("mpi"),
+                     "Transport for the throughput and pixelstream benchmarks: 'mpi' or 'shm'")
+            ("format", boost::program_options::value<std::string>()->default_value("text"),
+                     "Format of the results: 'text', 'json' or 'csv'")
+            ("output", boost::program_options::value<std::string>()->default_value(""),
+                     "File to write the results to, standard output if empty")
         ;
     }
 
@@ -131,68 +211,559 @@ struct BenchmarkOptions
         }
 
         getHelp_ = vm.count("help");
+        benchmark_ = vm["benchmark"].as<std::string>();
         dataSize_ = vm["datasize"].as<float>() * MEGABYTE;
-        packetsCount_ = vm["packets"].as<unsigned int>();
+        packetsCount_ = std::max(vm["packets"].as<unsigned int>(), 1u);
+        messageSize_ = vm["messagesize"].as<unsigned int>();
+        windowsCount_ = std::max(vm["windows"].as<unsigned int>(), 1u);
+        segmentsCount_ = std::max(vm["segments"].as<unsigned int>(), 1u);
+        segmentSize_ = vm["segmentsize"].as<unsigned int>() * KILOBYTE;
+        transportName_ = vm["transport"].as<std::string>();
+        if (transportName_ == "shm")
+            transport_ = TRANSPORT_SHARED_MEMORY;
+        format_ = vm["format"].as<std::string>();
+        output_ = vm["output"].as<std::string>();
+
+        if (!isValid())
+        {
+            std::cerr << "invalid benchmark or format" << std::endl;
+            getHelp_ = true;
+        }
+    }
+
+    bool isValid() const
+    {
+        if (format_ != "text" && format_ != "json" && format_ != "csv")
+            return false;
+        if (benchmark_ == "all")
+            return true;
+        return std::find(BENCHMARKS, BENCHMARKS + BENCHMARKS_COUNT,
+                         benchmark_) != BENCHMARKS + BENCHMARKS_COUNT;
+    }
+
+    bool runs(const std::string& benchmark) const
+    {
+        return benchmark_ == "all" || benchmark_ == benchmark;
     }
 
     boost::program_options::options_description desc_;
 
     bool getHelp_;
+    std::string benchmark_;
     unsigned int dataSize_;
     unsigned int packetsCount_;
+    unsigned int messageSize_;
+    unsigned int windowsCount_;
+    unsigned int segmentsCount_;
+    unsigned int segmentSize_;
+    std::string transportName_;
+    BroadcastTransportType transport_;
+    std::string format_;
+    std::string output_;
 };
+
+void addResult(Results& results, const std::string& benchmark,
+               const std::string& parameter, const double value,
+               const std::string& metric, const double result)
+{
+    const Result entry = { benchmark, parameter, value, metric, result };
+    results.push_back(entry);
+}
+
+/** The sequence 1, 2, 4... or 1, 10, 100... up to and including max. */
+std::vector<unsigned int> makeSeries(const unsigned int max, const unsigned int factor)
+{
+    std::vector<unsigned int> series;
+    for (unsigned int i = 1; i < max; i *= factor)
+        series.push_back(i);
+    series.push_back(max);
+    return series;
 }
 
 /**
- * Send data via MPI to benchmark the effective link speed at application level.
+ * Run a benchmark within groups of increasing number of ranks (powers of two,
+ * then all ranks). The rank 0 of each group is the rank 0 of the world.
  */
-int main(int argc, char **argv)
+void forEachGroupSize(MPIChannel& mpiChannel,
+                      const std::function<void(MPIChannelPtr)>& benchmark)
 {
-    BenchmarkOptions options(argc, argv);
-    if (options.getHelp_)
+    const int worldSize = mpiChannel.getSize();
+    int ranks = std::min(2, worldSize);
+    while (true)
     {
-        options.showSyntax();
-        return 0;
+        const bool participate = mpiChannel.getRank() < ranks;
+        MPIChannelPtr group(new MPIChannel(mpiChannel, participate ? 0 : 1,
+                                           mpiChannel.getRank()));
+        if (participate)
+            benchmark(group);
+        mpiChannel.globalBarrier();
+
+        if (ranks == worldSize)
+            break;
+        ranks = std::min(2 * ranks, worldSize);
+    }
+}
+
+/** @return the mean duration of the operation over all the ranks [us]. */
+double measureMicroseconds(MPIChannel& channel, const unsigned int iterations,
+                           const std::function<void()>& operation)
+{
+    Timer timer;
+    channel.globalBarrier();
+    timer.start();
+    for (unsigned int i = 0; i < iterations; ++i)
+        operation();
+    // Wait for the last operation to complete on all the ranks
+    channel.globalBarrier();
+    return timer.elapsedMicroseconds() / iterations;
+}
+
+/** @return the largest of the local values of all the ranks. */
+uint64_t globalMax(MPIChannel& channel, const uint64_t localValue)
+{
+    const std::vector<uint64_t> values = channel.gatherAll(localValue);
+    return *std::max_element(values.begin(), values.end());
+}
+
+void receiveBroadcast(MPIChannel& mpiChannel, SerializeBuffer& buffer)
+{
+    const MPIHeader header = mpiChannel.receiveHeader(RANK0);
+    buffer.setSize(header.size);
+    mpiChannel.receiveBroadcast(buffer.data(), header.size, RANK0);
+}
+
+DisplayGroupPtr makeDisplayGroup(const unsigned int windowsCount)
+{
+    DisplayGroupPtr group(new DisplayGroup(QSizeF(7680, 3240)));
+    for (unsigned int i = 0; i < windowsCount; ++i)
+    {
+        ContentPtr content(new PixelStreamContent(QString("stream%1").arg(i)));
+        content->setDimensions(QSize(1920, 1080));
+        ContentWindowPtr window = boost::make_shared<ContentWindow>(content);
+        window->setCoordinates(QRectF(i % 10 * 700, i / 10 * 300, 640, 360));
+        group->addContentWindow(window);
     }
+    return group;
+}
 
-    MPIChannel mpiChannel(argc, argv);
+deflect::FramePtr makeFrame(const unsigned int segmentsCount,
+                            const unsigned int segmentSize)
+{
+    deflect::FramePtr frame(new deflect::Frame);
+    frame->uri = "benchmark";
+    QByteArray imageData(segmentSize, 0);
+    for (int i = 0; i < imageData.size(); ++i)
+        imageData[i] = rand();
 
+    for (unsigned int i = 0; i < segmentsCount; ++i)
+    {
+        deflect::Segment segment;
+        segment.parameters.x = i % 8 * 512;
+        segment.parameters.y = i / 8 * 512;
+        segment.parameters.width = 512;
+        segment.parameters.height = 512;
+        segment.parameters.compressed = true;
+        segment.imageData = imageData;
+        frame->segments.push_back(segment);
+    }
+    return frame;
+}
+
+/**
+ * Broadcast large messages with the transport used between the master and the
+ * walls to measure the effective link speed at application level.
+ */
+void benchmarkThroughput(MPIChannel& mpiChannel, const BenchmarkOptions& options,
+                         BroadcastSender* sender, BroadcastReceiver* receiver,
+                         Results& results)
+{
     // Send buffer
     std::vector<char> noiseBuffer(options.dataSize_);
     for (std::vector<char>::iterator it = noiseBuffer.begin(); it != noiseBuffer.end(); ++it)
         *it = rand();
     const std::string serializedData = SerializeBuffer::serialize(noiseBuffer);
 
-    // Receive buffer
-    SerializeBuffer buffer;
-    Timer timer;
-    size_t counter = 0;
+    MPIHeader header;
+    header.type = MPI_MESSAGE_TYPE_NONE;
+    header.size = serializedData.size();
+    std::string sendBuffer;
 
+    Timer timer;
     mpiChannel.globalBarrier();
     timer.start();
 
-    while(counter < options.packetsCount_)
+    for (size_t i = 0; i < options.packetsCount_; ++i)
     {
-        if (mpiChannel.getRank() == RANK0)
-            mpiChannel.broadcast(MPI_MESSAGE_TYPE_NONE, serializedData);
+        if (sender)
+        {
+            sendBuffer = serializedData;
+            sender->send(header, sendBuffer);
+        }
         else
+            receiver->receive(header);
+    }
+    if (sender)
+        sender->flush();
+    // Wait for the last message to reach all the ranks
+    mpiChannel.globalBarrier();
+
+    const double time = timer.elapsed() / 1000.0;
+    const double dataSize = (double)serializedData.size() / MEGABYTE;
+
+    addResult(results, "throughput", "datasize_MB", dataSize, "throughput_MBps",
+              options.packetsCount_ * dataSize / time);
+    addResult(results, "throughput", "datasize_MB", dataSize, "time_per_object_s",
+              time / options.packetsCount_);
+}
+
+/**
+ * Broadcast small messages to measure how the per-message latency scales with
+ * the size of the cluster.
+ */
+void benchmarkLatency(MPIChannel& mpiChannel, const BenchmarkOptions& options,
+                      Results& results)
+{
+    const std::string message(options.messageSize_, 'x');
+
+    forEachGroupSize(mpiChannel, [&](MPIChannelPtr group)
+    {
+        SerializeBuffer buffer;
+        const double latency = measureMicroseconds(*group, options.packetsCount_, [&]()
+        {
+            if (group->getRank() == RANK0)
+                group->broadcast(MPI_MESSAGE_TYPE_NONE, message);
+            else
+                receiveBroadcast(*group, buffer);
+        });
+        addResult(results, "latency", "ranks", group->getSize(), "latency_us", latency);
+    });
+}
+
+/**
+ * Measure the WallToWallChannel operations made by the walls for each frame:
+ * the clock synchronization, the version check of each synchronized object
+ * and the barrier before swapping the buffers.
+ */
+void benchmarkFrameSync(MPIChannel& mpiChannel, const BenchmarkOptions& options,
+                        Results& results)
+{
+    forEachGroupSize(mpiChannel, [&](MPIChannelPtr group)
+    {
+        WallToWallChannel wallChannel(group);
+        const int ranks = group->getSize();
+        const unsigned int iterations = options.packetsCount_;
+        uint64_t version = 0;
+
+        const double clock = measureMicroseconds(*group, iterations, [&]()
+        {
+            wallChannel.synchronizeClock();
+        });
+        const double checkVersion = measureMicroseconds(*group, iterations, [&]()
+        {
+            wallChannel.checkVersion(++version);
+        });
+        const double barrier = measureMicroseconds(*group, iterations, [&]()
         {
-            const MPIHeader header = mpiChannel.receiveHeader(RANK0);
-            buffer.setSize(header.size);
-            mpiChannel.receiveBroadcast(buffer.data(), header.size, RANK0);
+            wallChannel.globalBarrier();
+        });
+        const double frame = measureMicroseconds(*group, iterations, [&]()
+        {
+            wallChannel.synchronizeClock();
+            ++version;
+            for (int i = 0; i < SYNC_OBJECTS_PER_FRAME; ++i)
+                wallChannel.checkVersion(version);
+            wallChannel.globalBarrier();
+        });
+
+        addResult(results, "framesync", "ranks", ranks, "clock_us", clock);
+        addResult(results, "framesync", "ranks", ranks, "checkversion_us", checkVersion);
+        addResult(results, "framesync", "ranks", ranks, "barrier_us", barrier);
+        addResult(results, "framesync", "ranks", ranks, "frame_us", frame);
+    });
+}
+
+/**
+ * Measure the cost of sending a DisplayGroup from the master to the walls:
+ * encoding on the master, broadcast, and decoding on the slowest wall.
+ */
+void benchmarkDisplayGroup(MPIChannel& mpiChannel, const BenchmarkOptions& options,
+                           Results& results)
+{
+    const unsigned int iterations = options.packetsCount_;
+
+    for (const unsigned int windowsCount : makeSeries(options.windowsCount_, 10))
+    {
+        std::string encoded;
+        SerializeBuffer buffer;
+        double encodeTime = 0.0;
+
+        if (mpiChannel.getRank() == RANK0)
+        {
+            const DisplayGroupPtr group = makeDisplayGroup(windowsCount);
+            BinaryEncoder encoder;
+            Timer timer;
+            timer.start();
+            for (unsigned int i = 0; i < iterations; ++i)
+                encoder.encode(group, encoded);
+            encodeTime = timer.elapsedMicroseconds() / iterations;
         }
-        ++counter;
+
+        const double broadcastTime = measureMicroseconds(mpiChannel, iterations, [&]()
+        {
+            if (mpiChannel.getRank() == RANK0)
+                mpiChannel.broadcast(MPI_MESSAGE_TYPE_DISPLAYGROUP, encoded);
+            else
+                receiveBroadcast(mpiChannel, buffer);
+        });
+
+        // The master decodes its own message if there are no walls
+        const char* data = encoded.data();
+        size_t size = encoded.size();
+        if (mpiChannel.getRank() != RANK0)
+        {
+            data = buffer.data();
+            size = buffer.size();
+        }
+        BinaryDecoder decoder;
+        Timer timer;
+        timer.start();
+        for (unsigned int i = 0; i < iterations; ++i)
+        {
+            DisplayGroupPtr decodedGroup;
+            decoder.decode(data, size, decodedGroup);
+        }
+        const uint64_t decodeTime = globalMax(mpiChannel,
+                                              timer.elapsedMicroseconds() * 1000 / iterations);
+
+        addResult(results, "displaygroup", "windows", windowsCount, "message_bytes",
+                  encoded.size());
+        addResult(results, "displaygroup", "windows", windowsCount, "serialize_us",
+                  encodeTime);
+        addResult(results, "displaygroup", "windows", windowsCount, "broadcast_us",
+                  broadcastTime);
+        addResult(results, "displaygroup", "windows", windowsCount, "deserialize_us",
+                  decodeTime / 1000.0);
     }
+}
 
-    const float time = timer.elapsed() / 1000.f;
+/**
+ * Measure the fan-out of pixel stream frames from the master to the walls,
+ * including their encoding and decoding, against the number of segments.
+ */
+void benchmarkPixelStream(MPIChannel& mpiChannel, const BenchmarkOptions& options,
+                          BroadcastSender* sender, BroadcastReceiver* receiver,
+                          Results& results)
+{
+    for (const unsigned int segmentsCount : makeSeries(options.segmentsCount_, 2))
+    {
+        deflect::FramePtr frame;
+        if (sender)
+            frame = makeFrame(segmentsCount, options.segmentSize_);
 
-    if (mpiChannel.getRank() == RANK0)
+        BinaryEncoder encoder;
+        BinaryDecoder decoder;
+        std::string encoded;
+        size_t frameSize = 0;
+        MPIHeader header;
+        header.type = MPI_MESSAGE_TYPE_PIXELSTREAM;
+
+        Timer timer;
+        mpiChannel.globalBarrier();
+        timer.start();
+
+        for (unsigned int i = 0; i < options.packetsCount_; ++i)
+        {
+            if (sender)
+            {
+                encoder.encode(frame, encoded);
+                header.size = frameSize = encoded.size();
+                sender->send(header, encoded);
+            }
+            else
+            {
+                const char* data = receiver->receive(header);
+                deflect::FramePtr decodedFrame;
+                decoder.decode(data, header.size, decodedFrame);
+                frameSize = header.size;
+            }
+        }
+        if (sender)
+            sender->flush();
+        // Wait for the last frame to be decoded by all the ranks
+        mpiChannel.globalBarrier();
+
+        const double time = timer.elapsedMicroseconds() / MICROSEC;
+
+        addResult(results, "pixelstream", "segments", segmentsCount, "frame_bytes",
+                  frameSize);
+        addResult(results, "pixelstream", "segments", segmentsCount, "frames_per_s",
+                  options.packetsCount_ / time);
+        addResult(results, "pixelstream", "segments", segmentsCount, "throughput_MBps",
+                  options.packetsCount_ * (double)frameSize / MEGABYTE / time);
+    }
+}
+
+/**
+ * Measure the synchronization of movies between the walls: the election of a
+ * leader alone, then followed by the broadcast of its timestamp.
+ */
+void benchmarkElectLeader(MPIChannel& mpiChannel, const BenchmarkOptions& options,
+                          Results& results)
+{
+    forEachGroupSize(mpiChannel, [&](MPIChannelPtr group)
     {
-        std::cout << "Object size [Mbytes]: " << (float)serializedData.size() / MEGABYTE << std::endl;
-        std::cout << "Time to send " << counter << " objects: " << time << std::endl;
-        std::cout << "Time per object: " << time / counter << std::endl;
-        std::cout << "Throughput [Mbytes/sec]: " << counter * serializedData.size() / time / MEGABYTE << std::endl;
+        const int ranks = group->getSize();
+        if (ranks > MAX_ELECTION_RANKS)
+            return;
+
+        WallToWallChannel wallChannel(group);
+        // Only some of the walls have decoded a frame of the movie
+        const bool isCandidate = ranks == 1 || group->getRank() % 2 == 1;
+        const boost::posix_time::time_duration timestamp =
+            boost::posix_time::milliseconds(40);
+
+        const double elect = measureMicroseconds(*group, options.packetsCount_, [&]()
+        {
+            wallChannel.electLeader(isCandidate);
+        });
+        const double sync = measureMicroseconds(*group, options.packetsCount_, [&]()
+        {
+            const int leader = wallChannel.electLeader(isCandidate);
+            if (leader == wallChannel.getRank())
+                wallChannel.broadcast(timestamp);
+            else
+                wallChannel.receiveTimestampBroadcast(leader);
+        });
+
+        addResult(results, "electleader", "ranks", ranks, "elect_us", elect);
+        addResult(results, "electleader", "ranks", ranks, "moviesync_us", sync);
+    });
+}
+
+void writeText(std::ostream& out, const Results& results)
+{
+    for (const Result& result : results)
+        out << result.benchmark << " " << result.parameter << "=" << result.value
+            << " " << result.metric << "=" << result.result << std::endl;
+}
+
+void writeCsv(std::ostream& out, const Results& results)
+{
+    out << "benchmark,parameter,value,metric,result" << std::endl;
+    for (const Result& result : results)
+        out << result.benchmark << "," << result.parameter << "," << result.value
+            << "," << result.metric << "," << result.result << std::endl;
+}
+
+void writeJson(std::ostream& out, const Results& results, const int ranks,
+               const BenchmarkOptions& options)
+{
+    out << "{" << std::endl;
+    out << "  \"ranks\": " << ranks << "," << std::endl;
+    out << "  \"transport\": \"" << options.transportName_ << "\"," << std::endl;
+    out << "  \"packets\": " << options.packetsCount_ << "," << std::endl;
+    out << "  \"results\": [" << std::endl;
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const Result& result = results[i];
+        out << "    { \"benchmark\": \"" << result.benchmark << "\", "
+            << "\"parameter\": \"" << result.parameter << "\", "
+            << "\"value\": " << result.value << ", "
+            << "\"metric\": \"" << result.metric << "\", "
+            << "\"result\": " << result.result << " }"
+            << (i + 1 < results.size() ? "," : "") << std::endl;
+    }
+    out << "  ]" << std::endl;
+    out << "}" << std::endl;
+}
+
+void writeResults(const Results& results, const int ranks,
+                  const BenchmarkOptions& options)
+{
+    std::ofstream file;
+    if (!options.output_.empty())
+    {
+        file.open(options.output_.c_str());
+        if (!file)
+        {
+            std::cerr << "could not open " << options.output_ << std::endl;
+            return;
+        }
+    }
+    std::ostream& out = options.output_.empty() ? std::cout : file;
+    out.precision(10);
+
+    if (options.format_ == "json")
+        writeJson(out, results, ranks, options);
+    else if (options.format_ == "csv")
+        writeCsv(out, results);
+    else
+        writeText(out, results);
+}
+}
+
+/**
+ * Benchmark the communications between the master and the wall processes.
+ */
+int main(int argc, char **argv)
+{
+    BenchmarkOptions options(argc, argv);
+    if (options.getHelp_)
+    {
+        options.showSyntax();
+        return 0;
+    }
+
+    MPIChannelPtr channel(new MPIChannel(argc, argv));
+    MPIChannel& mpiChannel = *channel;
+    Results results;
+
+    // Same transports as between the master and the walls, on a separate
+    // channel so that their pending collectives can not interleave with the
+    // ones of the other benchmarks.
+    BroadcastSenderPtr sender;
+    BroadcastReceiverPtr receiver;
+    MPIChannelPtr transportChannel;
+    const bool useTransport = options.runs("throughput") || options.runs("pixelstream");
+    if (useTransport)
+    {
+        transportChannel.reset(new MPIChannel(mpiChannel, 0, mpiChannel.getRank()));
+        if (mpiChannel.getRank() == RANK0)
+            sender = BroadcastSender::create(options.transport_, transportChannel);
+        else
+            receiver = BroadcastReceiver::create(options.transport_, transportChannel);
     }
 
+    if (options.runs("throughput"))
+        benchmarkThroughput(mpiChannel, options, sender.get(), receiver.get(), results);
+    if (options.runs("latency"))
+        benchmarkLatency(mpiChannel, options, results);
+    if (options.runs("framesync"))
+        benchmarkFrameSync(mpiChannel, options, results);
+    if (options.runs("displaygroup"))
+        benchmarkDisplayGroup(mpiChannel, options, results);
+    if (options.runs("pixelstream"))
+        benchmarkPixelStream(mpiChannel, options, sender.get(), receiver.get(), results);
+    if (options.runs("electleader"))
+        benchmarkElectLeader(mpiChannel, options, results);
+
+    // Terminate the transports, which receive one message in advance
+    if (useTransport)
+    {
+        MPIHeader quit;
+        quit.type = MPI_MESSAGE_TYPE_QUIT;
+        if (sender)
+        {
+            std::string noData;
+            sender->send(quit, noData);
+            sender->flush();
+        }
+        else
+            receiver->receive(quit);
+    }
+
+    if (mpiChannel.getRank() == RANK0)
+        writeResults(results, mpiChannel.getSize(), options);
+
     return 0;
 }
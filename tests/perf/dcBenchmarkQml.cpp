@@ -0,0 +1,204 @@
+/*********************************************************************/
+/* Copyright (c) 2015, EPFL/Blue Brain Project                       */
+/* All rights reserved.                                              */
+/*                                                                   */
+/* Redistribution and use in source and binary forms, with or        */
+/* without modification, are permitted provided that the following   */
+/* conditions are met:                                               */
+/*                                                                   */
+/*   1. Redistributions of source code must retain the above         */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer.                                                  */
+/*                                                                   */
+/*   2. Redistributions in binary form must reproduce the above      */
+/*      copyright notice, this list of conditions and the following  */
+/*      disclaimer in the documentation and/or other materials       */
+/*      provided with the distribution.                              */
+/*                                                                   */
+/*    THIS  SOFTWARE IS PROVIDED  BY THE  UNIVERSITY OF  TEXAS AT    */
+/*    AUSTIN  ``AS IS''  AND ANY  EXPRESS OR  IMPLIED WARRANTIES,    */
+/*    INCLUDING, BUT  NOT LIMITED  TO, THE IMPLIED  WARRANTIES OF    */
+/*    MERCHANTABILITY  AND FITNESS FOR  A PARTICULAR  PURPOSE ARE    */
+/*    DISCLAIMED.  IN  NO EVENT SHALL THE UNIVERSITY  OF TEXAS AT    */
+/*    AUSTIN OR CONTRIBUTORS BE  LIABLE FOR ANY DIRECT, INDIRECT,    */
+/*    INCIDENTAL,  SPECIAL, EXEMPLARY,  OR  CONSEQUENTIAL DAMAGES    */
+/*    (INCLUDING, BUT  NOT LIMITED TO,  PROCUREMENT OF SUBSTITUTE    */
+/*    GOODS  OR  SERVICES; LOSS  OF  USE,  DATA,  OR PROFITS;  OR    */
+/*    BUSINESS INTERRUPTION) HOWEVER CAUSED  AND ON ANY THEORY OF    */
+/*    LIABILITY, WHETHER  IN CONTRACT, STRICT  LIABILITY, OR TORT    */
+/*    (INCLUDING NEGLIGENCE OR OTHERWISE)  ARISING IN ANY WAY OUT    */
+/*    OF  THE  USE OF  THIS  SOFTWARE,  EVEN  IF ADVISED  OF  THE    */
+/*    POSSIBILITY OF SUCH DAMAGE.                                    */
+/*                                                                   */
+/* The views and conclusions contained in the software and           */
+/* documentation are those of the authors and should not be          */
+/* interpreted as representing official policies, either expressed   */
+/* or implied, of The University of Texas at Austin.                 */
+/*********************************************************************/
+
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/program_options.hpp>
+
+#include <QApplication>
+#include <QGraphicsScene>
+#include <QtDeclarative/QDeclarativeComponent>
+#include <QtDeclarative/QDeclarativeContext>
+#include <QtDeclarative/QDeclarativeEngine>
+#include <QtDeclarative/QDeclarativeItem>
+
+#include "ContentWindow.h"
+#include "DisplayGroup.h"
+#include "Options.h"
+#include "PixelStreamContent.h"
+#include "QmlItemPool.h"
+
+// Example way to run this program:
+// ./dcBenchmarkQml --windows 200 --iterations 10 -platform offscreen
+//
+//Windows: 200
+//Create+destroy [us/window] component: ... pool (first): ... pool: ...
+
+namespace
+{
+typedef boost::posix_time::ptime Time;
+
+const QUrl QML_WINDOW_URL("qrc:/qml/core/WallContentWindow.qml");
+
+Time now()
+{
+    return boost::posix_time::microsec_clock::universal_time();
+}
+
+ContentWindowPtrs makeWindows(const unsigned int windowsCount)
+{
+    ContentWindowPtrs windows;
+    for (unsigned int i = 0; i < windowsCount; ++i)
+    {
+        ContentPtr content(new PixelStreamContent(QString("stream%1").arg(i)));
+        content->setDimensions(QSize(1920, 1080));
+        ContentWindowPtr window = boost::make_shared<ContentWindow>(content);
+        window->setCoordinates(QRectF(i % 10 * 700, i / 10 * 300, 640, 360));
+        windows.push_back(window);
+    }
+    return windows;
+}
+
+double usPerWindow(const Time& start, const unsigned int iterations,
+                   const unsigned int windowsCount)
+{
+    return (double)(now() - start).total_microseconds() / iterations / windowsCount;
+}
+
+// Create the windows the way the wall did before pooling: a new component and
+// a new context for each window, and items destroyed with the windows.
+void createWithComponents(QDeclarativeEngine& engine, QDeclarativeItem& parent,
+                          const ContentWindowPtrs& windows)
+{
+    std::vector<QDeclarativeContext*> contexts;
+    std::vector<QDeclarativeItem*> items;
+    for (const ContentWindowPtr& window : windows)
+    {
+        QDeclarativeContext* context =
+                new QDeclarativeContext(engine.rootContext());
+        context->setContextProperty("contentwindow", window.get());
+        QDeclarativeComponent component(&engine, QML_WINDOW_URL);
+        QDeclarativeItem* item =
+                qobject_cast<QDeclarativeItem*>(component.create(context));
+        item->setParentItem(&parent);
+        contexts.push_back(context);
+        items.push_back(item);
+    }
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        delete items[i];
+        delete contexts[i];
+    }
+}
+
+void createWithPool(QmlItemPool& pool, QDeclarativeItem& parent,
+                    const ContentWindowPtrs& windows)
+{
+    std::vector<QmlItemPool::Item> items;
+    for (const ContentWindowPtr& window : windows)
+    {
+        items.push_back(pool.acquire(QML_WINDOW_URL, "contentwindow", window));
+        items.back().item->setParentItem(&parent);
+    }
+    for (const QmlItemPool::Item& item : items)
+        pool.release(item);
+}
+}
+
+/**
+ * Measure the instantiation of the qml windows on the wall, with and without
+ * the QmlItemPool.
+ */
+int main(int argc, char **argv)
+{
+    QApplication app(argc, argv);
+
+    namespace po = boost::program_options;
+    po::options_description desc("Allowed options");
+    desc.add_options()
+        ("help", "produce help message")
+        ("windows", po::value<unsigned int>()->default_value(200),
+                 "number of windows opened and closed at once")
+        ("iterations", po::value<unsigned int>()->default_value(10),
+                 "number of times the windows are opened and closed")
+    ;
+    po::variables_map vm;
+    po::store(po::command_line_parser(argc, argv).options(desc)
+              .allow_unregistered().run(), vm);
+    po::notify(vm);
+    if (vm.count("help"))
+    {
+        std::cout << desc;
+        return 0;
+    }
+    const unsigned int windowsCount = std::max(vm["windows"].as<unsigned int>(), 1u);
+    const unsigned int iterations = std::max(vm["iterations"].as<unsigned int>(), 1u);
+
+    QDeclarativeEngine engine;
+    Options options;
+    DisplayGroup displayGroup(QSizeF(7680, 3240));
+    engine.rootContext()->setContextProperty("options", &options);
+    engine.rootContext()->setContextProperty("displaygroup", &displayGroup);
+
+    QGraphicsScene scene;
+    QDeclarativeItem root;
+    scene.addItem(&root);
+
+    const ContentWindowPtrs windows = makeWindows(windowsCount);
+
+    Time start = now();
+    for (unsigned int i = 0; i < iterations; ++i)
+        createWithComponents(engine, root, windows);
+    const double componentTime = usPerWindow(start, iterations, windowsCount);
+
+    QmlItemPool pool(engine, windowsCount);
+    pool.preload(QML_WINDOW_URL);
+
+    start = now();
+    createWithPool(pool, root, windows);
+    const double poolFirstTime = usPerWindow(start, 1, windowsCount);
+
+    start = now();
+    for (unsigned int i = 0; i < iterations; ++i)
+        createWithPool(pool, root, windows);
+    const double poolTime = usPerWindow(start, iterations, windowsCount);
+
+    scene.removeItem(&root);
+
+    std::cout << "Windows: " << windowsCount << std::endl;
+    std::cout << "Create+destroy [us/window] component: " << componentTime
+              << " pool (first): " << poolFirstTime
+              << " pool: " << poolTime << std::endl;
+
+    return 0;
+}